@@ -33,11 +33,83 @@
 /******************************************************************************/
 GUI_t GUI;
 
+#if GUI_OCCLUSION_RECTS
+/**
+ * \brief           Opaque widget which hides its siblings below
+ */
+typedef struct GUI_Occluder_t {
+    GUI_HANDLE_p h;                         /*!< Opaque widget handle */
+    GUI_Display_t Rect;                     /*!< Part of widget drawn in region rectangle */
+} GUI_Occluder_t;
+#endif /* GUI_OCCLUSION_RECTS */
+
+/**
+ * \brief           Layer where widget with its children is drawn before it is blended to previous layer
+ */
+typedef struct GUI_RedrawTarget_t {
+    GUI_Layer_t* Layer;                     /*!< Scratch or cache layer, NULL when widget is drawn directly */
+    GUI_Layer_t* LayerPrev;                 /*!< Layer where widget is blended to */
+    GUI_Display_t Blend;                    /*!< Part of widget to blend */
+    GUI_Display_t Region;                   /*!< Region rectangle to restore after widget was drawn to cache */
+    uint8_t Cache;                          /*!< Widget was drawn to its cache layer */
+} GUI_RedrawTarget_t;
+
+/**
+ * \brief           Level of widget tree on redraw stack
+ */
+typedef struct GUI_RedrawLevel_t {
+    GUI_HANDLE_p Parent;                    /*!< Widget which children are visited, NULL for base widgets */
+    GUI_HANDLE_p h;                         /*!< Last visited child widget */
+    GUI_Display_t Clip;                     /*!< Clipping rectangle of children widgets */
+#if GUI_OCCLUSION_RECTS
+    GUI_Occluder_t Occ[GUI_OCCLUSION_RECTS];/*!< Opaque children widgets from top to bottom */
+    size_t OccCnt;                          /*!< Number of opaque widgets above next child widget */
+#endif /* GUI_OCCLUSION_RECTS */
+    GUI_RedrawTarget_t Target;              /*!< Target where parent widget is finished when all children are drawn */
+} GUI_RedrawLevel_t;
+
+/**
+ * \brief           Redraw process of one region rectangle
+ */
+typedef struct GUI_Redraw_t {
+    GUI_RedrawLevel_t Levels[GUI_WIDGET_MAX_DEPTH]; /*!< Stack of visited tree levels */
+    size_t Depth;                           /*!< Number of used levels */
+    size_t Index;                           /*!< Index of region rectangle */
+    uint32_t Count;                         /*!< Number of drawn widgets */
+} GUI_Redraw_t;
+
+#if GUI_USE_TOUCH
+/**
+ * \brief           Level of widget tree on touch stack
+ */
+typedef struct GUI_TouchLevel_t {
+    GUI_HANDLE_p Parent;                    /*!< Widget which children are checked, NULL for base widgets */
+    GUI_HANDLE_p h;                         /*!< Currently checked child widget */
+    GUI_Display_t Clip;                     /*!< Clipping rectangle of children widgets */
+    GUI_Display_t Disp;                     /*!< Visible part of currently checked child widget */
+    GUI_Grid_t* Grid;                       /*!< Spatial index of children widgets or NULL */
+    size_t Start;                           /*!< Start of index cell references */
+    size_t Pos;                             /*!< Position after next reference to check in index cell */
+    uint8_t DialogOnly;                     /*!< Only dialog widgets can be touched on this level */
+} GUI_TouchLevel_t;
+
+/**
+ * \brief           Touch press process looking for widget under touch point
+ */
+typedef struct GUI_TouchSearch_t {
+    __GUI_TouchData_t* Touch;               /*!< Touch data */
+    GUI_TouchLevel_t Levels[GUI_WIDGET_MAX_DEPTH];  /*!< Stack of visited tree levels */
+    size_t Depth;                           /*!< Number of used levels */
+    uint8_t IsKeyboard;                     /*!< Checked widget is part of keyboard */
+} GUI_TouchSearch_t;
+#endif /* GUI_USE_TOUCH */
+
 /******************************************************************************/
 /******************************************************************************/
 /***                           Private definitions                           **/
 /******************************************************************************/
 /******************************************************************************/
+#define RECT_INTERSECTS(a, b)       ((a)->X1 < (b)->X2 && (b)->X1 < (a)->X2 && (a)->Y1 < (b)->Y2 && (b)->Y1 < (a)->Y2)
 
 
 /******************************************************************************/
@@ -52,7 +124,6 @@ GUI_t GUI;
 /***                            Private functions                            **/
 /******************************************************************************/
 /******************************************************************************/
-
 /* Gets number of widgets waiting for redraw */
 //uint32_t __GetNumberOfPendingWidgets(GUI_HANDLE_p parent) {
 //    GUI_HANDLE_p h;
@@ -75,143 +146,463 @@ GUI_t GUI;
 //    return cnt;
 //}
 
-/* Clip widget before draw/touch operation */
+/* Get part of widget inside clipping rectangle of its parent level, return 0 when nothing is visible */
 static
-void __CheckDispClipping(GUI_HANDLE_p h) {
+uint8_t __ClipWidget(GUI_HANDLE_p h, const GUI_Display_t* clip, GUI_Display_t* out) {
     GUI_iDim_t x, y;
-    GUI_Dim_t wi, hi;
     
-    /* Set widget itself first */
     x = __GUI_WIDGET_GetAbsoluteX(h);
     y = __GUI_WIDGET_GetAbsoluteY(h);
-    wi = __GUI_WIDGET_GetWidth(h);
-    hi = __GUI_WIDGET_GetHeight(h);
-    
-    memcpy(&GUI.DisplayTemp, &GUI.Display, sizeof(GUI.DisplayTemp));
-    if (GUI.DisplayTemp.X1 == (GUI_iDim_t)0x7FFF)   { GUI.DisplayTemp.X1 = x; }
-    if (GUI.DisplayTemp.Y1 == (GUI_iDim_t)0x7FFF)   { GUI.DisplayTemp.Y1 = y; }
-    if (GUI.DisplayTemp.X2 == (GUI_iDim_t)0x8000)   { GUI.DisplayTemp.X2 = (GUI_iDim_t)GUI.LCD.Width; }
-    if (GUI.DisplayTemp.Y2 == (GUI_iDim_t)0x8000)   { GUI.DisplayTemp.Y2 = (GUI_iDim_t)GUI.LCD.Height; }
-    
-    if (GUI.DisplayTemp.X1 < x)             { GUI.DisplayTemp.X1 = x; }
-    if (GUI.DisplayTemp.X2 > x + wi)        { GUI.DisplayTemp.X2 = x + wi; }
-    if (GUI.DisplayTemp.Y1 < y)             { GUI.DisplayTemp.Y1 = y; }
-    if (GUI.DisplayTemp.Y2 > y + hi)        { GUI.DisplayTemp.Y2 = y + hi; }
-    
-    /* Check that widget is not drawn over any of parent widgets because of scrolling */
-    for (; h; h = __GH(h)->Parent) {
-        x = __GUI_WIDGET_GetParentAbsoluteX(h);     /* Parent absolute X position for inner widgets */
-        y = __GUI_WIDGET_GetParentAbsoluteY(h);     /* Parent absolute Y position for inner widgets */
-        wi = __GUI_WIDGET_GetParentInnerWidth(h);   /* Get parent inner width */
-        hi = __GUI_WIDGET_GetParentInnerHeight(h);  /* Get parent inner height */
+    
+    out->X1 = __GUI_MAX(clip->X1, x);
+    out->Y1 = __GUI_MAX(clip->Y1, y);
+    out->X2 = __GUI_MIN(clip->X2, x + __GUI_WIDGET_GetWidth(h));
+    out->Y2 = __GUI_MIN(clip->Y2, y + __GUI_WIDGET_GetHeight(h));
+    return out->X1 < out->X2 && out->Y1 < out->Y2;
+}
+
+/* Get clipping rectangle for children widgets, visible part of widget limited to its inner area */
+static
+void __ClipChildren(GUI_HANDLE_p h, const GUI_Display_t* disp, GUI_Display_t* out) {
+    GUI_iDim_t x, y;
+    
+    x = __GUI_WIDGET_GetAbsoluteX(h) + __GUI_WIDGET_GetPaddingLeft(h);
+    y = __GUI_WIDGET_GetAbsoluteY(h) + __GUI_WIDGET_GetPaddingTop(h);
+    
+    out->X1 = __GUI_MAX(disp->X1, x);
+    out->Y1 = __GUI_MAX(disp->Y1, y);
+    out->X2 = __GUI_MIN(disp->X2, x + __GUI_WIDGET_GetInnerWidth(h));
+    out->Y2 = __GUI_MIN(disp->Y2, y + __GUI_WIDGET_GetInnerHeight(h));
+}
+
+#if GUI_OCCLUSION_RECTS
+/* Check if rectangle is completely covered by opaque rectangles */
+static
+uint8_t __IsOccluded(const GUI_Display_t* r, const GUI_Occluder_t* occ, size_t cnt) {
+    GUI_Display_t parts[4];
+    size_t i, n;
+    
+    for (; cnt; cnt--, occ++) {
+        const GUI_Display_t* o = &occ->Rect;
+        if (!RECT_INTERSECTS(r, o)) {
+            continue;
+        }
         
-        if (GUI.DisplayTemp.X1 < x)         { GUI.DisplayTemp.X1 = x; }
-        if (GUI.DisplayTemp.X2 > x + wi)    { GUI.DisplayTemp.X2 = x + wi; }
-        if (GUI.DisplayTemp.Y1 < y)         { GUI.DisplayTemp.Y1 = y; }
-        if (GUI.DisplayTemp.Y2 > y + hi)    { GUI.DisplayTemp.Y2 = y + hi; }
+        /* Parts outside this rectangle must be covered by remaining rectangles */
+        n = __GUI_REGION_Subtract(r, o, parts);
+        for (i = 0; i < n; i++) {
+            if (!__IsOccluded(&parts[i], occ + 1, cnt - 1)) {
+                return 0;
+            }
+        }
+        return 1;
     }
+    return 0;
 }
 
-/* Redraw widgets */
+/* Remove covered sides from rectangle, return 0 when rectangle is completely covered */
 static
-uint32_t __RedrawWidgets(GUI_HANDLE_p parent) {
-    GUI_HANDLE_p h;
-    uint32_t cnt = 0;
-    static uint32_t level = 0;
+uint8_t __ClipOccluded(GUI_Display_t* r, const GUI_Occluder_t* occ, size_t cnt) {
+    GUI_Display_t parts[4];
+    size_t i;
+    
+    if (__IsOccluded(r, occ, cnt)) {
+        return 0;
+    }
+    for (i = 0; i < cnt; i++) {
+        const GUI_Display_t* o = &occ[i].Rect;
+        if (RECT_INTERSECTS(r, o) && __GUI_REGION_Subtract(r, o, parts) == 1) {   /* Uncovered part is rectangle */
+            *r = parts[0];
+            i = (size_t)-1;                         /* Smaller rectangle may now lose other sides too */
+        }
+    }
+    return 1;
+}
+#endif /* GUI_OCCLUSION_RECTS */
 
-    /* Go through all elements of parent */
+/* Clear redraw flag of all children widgets */
+static
+void __ClearRedrawFlags(GUI_HANDLE_p parent) {
+    GUI_HANDLE_p h;
+    
     for (h = __GUI_LINKEDLIST_WidgetGetNext((GUI_HANDLE_ROOT_t *)parent, NULL); h; 
-            h = __GUI_LINKEDLIST_WidgetGetNext(NULL, h)) {
+            h = __GUI_WIDGET_GetNextInTree(parent, h, 1)) {
+        __GUI_WIDGET_ClrFlag(h, GUI_FLAG_REDRAW);
+    }
+}
+
+/* Widget is not visible in region rectangle, keep redraw flags only when it is drawn in next region rectangles */
+static
+void __SkipWidget(GUI_HANDLE_p h, size_t index) {
+    if (!__GUI_WIDGET_IsInsideRegion(h, &GUI.Region, index + 1)) {
+        __GUI_WIDGET_ClrFlag(h, GUI_FLAG_REDRAW);
+        if (__GUI_WIDGET_AllowChildren(h)) {
+            __ClearRedrawFlags(h);
+        }
+    }
+}
+
+/* Blend part disp of transparent widget from its layer to previous layer */
+static
+void __BlendWidget(GUI_HANDLE_p h, GUI_Layer_t* layer, GUI_Layer_t* layerPrev, const GUI_Display_t* disp) {
+    GUI_iDim_t width, height;
+    
+    width = disp->X2 - disp->X1;
+    height = disp->Y2 - disp->Y1;
+    if (width > 0 && height > 0) {
+        GUI.LL.CopyBlend(&GUI.LCD, layer,
+            (void *)(layer->StartAddress + 
+                GUI.LCD.PixelSize * (layer->Width * (disp->Y1 - layer->OffsetY) + (disp->X1 - layer->OffsetX))),
+            (void *)(layerPrev->StartAddress + 
+                GUI.LCD.PixelSize * (layerPrev->Width * (disp->Y1 - layerPrev->OffsetY) + (disp->X1 - layerPrev->OffsetX))),
+            __GUI_WIDGET_GetTransparency(h), 0xFF,
+            width, height,
+            layer->Width - width, layerPrev->Width - width
+        );
+    }
+}
+
+/* Finish widget when it and all its children are drawn */
+static
+void __FinishWidget(GUI_HANDLE_p h, const GUI_RedrawTarget_t* t) {
+    if (t->Layer) {                                 /* Widget was drawn to separate layer */
+        GUI.LCD.DrawingLayer = t->LayerPrev;        /* Reset layer pointer */
+        if (t->Cache) {
+            memcpy(&GUI.Display, &t->Region, sizeof(GUI.Display)); /* Restore region rectangle */
+        }
+        __BlendWidget(h, t->Layer, t->LayerPrev, &t->Blend);
+        __GUI_SCRATCH_Release(t->Layer);            /* Return layer to pool, cache stays with widget */
+    }
+}
+
+/* Start visiting children widgets of parent, return 0 when tree is too deep */
+static
+uint8_t __RedrawPush(GUI_Redraw_t* ctx, GUI_HANDLE_p parent, const GUI_Display_t* clip) {
+    GUI_RedrawLevel_t* lvl;
+#if GUI_OCCLUSION_RECTS
+    GUI_HANDLE_p h;
+    GUI_Display_t disp;
+#endif /* GUI_OCCLUSION_RECTS */
+    
+    if (ctx->Depth >= GUI_WIDGET_MAX_DEPTH) {       /* Children widgets are not drawn */
+        if (__GUI_LINKEDLIST_WidgetGetNext((GUI_HANDLE_ROOT_t *)parent, NULL)) {
+            __GUI_DEBUG("Widget tree is deeper than GUI_WIDGET_MAX_DEPTH, children widgets not drawn\r\n");
+        }
+        return 0;
+    }
+    lvl = &ctx->Levels[ctx->Depth++];
+    lvl->Parent = parent;
+    lvl->h = NULL;
+    memcpy(&lvl->Clip, clip, sizeof(lvl->Clip));
+    lvl->Target.Layer = NULL;
+    
+#if GUI_OCCLUSION_RECTS
+    /**
+     * Collect opaque widgets from top to bottom of z-order.
+     * Only widgets which are redrawn now may hide widgets below them
+     */
+    lvl->OccCnt = 0;
+    for (h = __GUI_LINKEDLIST_WidgetGetPrev((GUI_HANDLE_ROOT_t *)parent, NULL); h && lvl->OccCnt < GUI_OCCLUSION_RECTS; 
+            h = __GUI_LINKEDLIST_WidgetGetPrev(NULL, h)) {
+        if (__GUI_WIDGET_IsVisible(h) && __GUI_WIDGET_IsOpaque(h) && __GUI_WIDGET_GetFlag(h, GUI_FLAG_REDRAW)
+            && __GUI_WIDGET_IsInsideClippingRegion(h) && __ClipWidget(h, clip, &disp)
+            && !__IsOccluded(&disp, lvl->Occ, lvl->OccCnt)) {
+            lvl->Occ[lvl->OccCnt].h = h;
+            memcpy(&lvl->Occ[lvl->OccCnt++].Rect, &disp, sizeof(disp));
+        }
+    }
+#endif /* GUI_OCCLUSION_RECTS */
+    return 1;
+}
+
+/**
+ * Redraw all widgets inside region rectangle with index, GUI.Display is set to this rectangle.
+ * Clipping rectangle is region rectangle limited to inner area of parent and all its parents,
+ * each level intersects it only with its own area before it is passed to children.
+ *
+ * Tree is walked with explicit stack, widget with children is finished when its level is removed from stack
+ */
+static
+uint32_t __RedrawWidgets(GUI_Redraw_t* ctx, size_t index) {
+    GUI_RedrawLevel_t* lvl;
+    GUI_RedrawTarget_t t;
+    GUI_HANDLE_p h, tmp;
+    GUI_Display_t disp, area, inner;
+    
+    ctx->Depth = 0;
+    ctx->Index = index;
+    ctx->Count = 0;
+    __RedrawPush(ctx, NULL, &GUI.Display);          /* Base widgets are clipped by region rectangle */
+    
+    while (ctx->Depth) {
+        lvl = &ctx->Levels[ctx->Depth - 1];
+        
+        /* Go to next widget on level, finish parent when all children are visited */
+        h = __GUI_LINKEDLIST_WidgetGetNext(lvl->h ? NULL : (GUI_HANDLE_ROOT_t *)lvl->Parent, lvl->h);
+        if (!h) {
+            ctx->Depth--;
+            __FinishWidget(lvl->Parent, &lvl->Target);
+            continue;
+        }
+        lvl->h = h;
+        
+        __GUI_STATS_INC(WidgetsVisited);
         if (!__GUI_WIDGET_IsVisible(h)) {           /* Check if visible */
             __GUI_WIDGET_ClrFlag(h, GUI_FLAG_REDRAW);   /* Clear flag to be sure */
+            __GUI_STATS_INC(WidgetsSkipped);
             continue;                               /* Ignore hidden elements */
         }
-        if (__GUI_WIDGET_IsInsideClippingRegion(h)) {   /* If draw function is set and drawing is inside clipping region */
-            /* Draw main widget if required */
-            if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_REDRAW)) { /* Check if redraw required */
-                GUI_Layer_t* layerPrev = GUI.LCD.DrawingLayer;  /* Save drawing layer */
-                uint8_t transparent = 0;
-                
-                __GUI_WIDGET_ClrFlag(h, GUI_FLAG_REDRAW);   /* Clear flag for drawing on widget */
-                
-                /**
-                 * Prepare clipping region for this widget drawing
-                 */
-                __CheckDispClipping(h);             /* Check coordinates for drawings */
-                
-                /**
-                 * Check transparency and check if blending function exists to merge layers later together
-                 */
-                if (__GUI_WIDGET_IsTransparent(h) && GUI.LL.CopyBlend) {
-                    GUI_iDim_t width = GUI.DisplayTemp.X2 - GUI.DisplayTemp.X1;
-                    GUI_iDim_t height = GUI.DisplayTemp.Y2 - GUI.DisplayTemp.Y1;
-                    
-                    /**
-                     * Try to allocate memory for new virtual layer for temporary usage
-                     */
-                    GUI.LCD.DrawingLayer = __GUI_MEMALLOC(sizeof(*GUI.LCD.DrawingLayer) + width * height * GUI.LCD.PixelSize);
-                    
-                    if (GUI.LCD.DrawingLayer) {     /* Check if allocation was successful */
-                        GUI.LCD.DrawingLayer->Width = width;
-                        GUI.LCD.DrawingLayer->Height = height;
-                        GUI.LCD.DrawingLayer->OffsetX = GUI.DisplayTemp.X1;
-                        GUI.LCD.DrawingLayer->OffsetY = GUI.DisplayTemp.Y1;
-                        GUI.LCD.DrawingLayer->StartAddress = (uint32_t)((char *)GUI.LCD.DrawingLayer) + sizeof(*GUI.LCD.DrawingLayer);
-                        transparent = 1;            /* We are going to transparent drawing mode */
-                    } else {
-                        GUI.LCD.DrawingLayer = layerPrev;   /* Reset layer back */
+        if (!__GUI_WIDGET_IsInsideClippingRegion(h)) {
+            __GUI_STATS_INC(WidgetsSkipped);        /* Widget is outside region */
+            continue;
+        }
+        if (!__ClipWidget(h, &lvl->Clip, &disp)) {  /* Widget is in region but hidden by parents */
+            __SkipWidget(h, index);
+            __GUI_STATS_INC(WidgetsSkipped);
+            continue;
+        }
+#if GUI_OCCLUSION_RECTS
+        if (lvl->OccCnt && lvl->Occ[lvl->OccCnt - 1].h == h) {  /* Widget is lowest collected opaque widget, only widgets above cover it */
+            lvl->OccCnt--;
+        }
+        if (lvl->OccCnt && !__ClipOccluded(&disp, lvl->Occ, lvl->OccCnt)) {  /* Draw widget and children only in uncovered part */
+            __SkipWidget(h, index);
+            __GUI_STATS_INC(WidgetsOccluded);
+            continue;
+        }
+#endif /* GUI_OCCLUSION_RECTS */
+        
+        /* Widget itself is up to date, check if any widget from children should be redrawn */
+        if (!__GUI_WIDGET_GetFlag(h, GUI_FLAG_REDRAW)) {
+            __GUI_STATS_INC(WidgetsSkipped);
+            if (__GUI_WIDGET_AllowChildren(h)) {
+                __ClipChildren(h, &disp, &inner);   /* Clipping for all children widgets */
+                __RedrawPush(ctx, h, &inner);
+            }
+            continue;
+        }
+        
+        /**
+         * Clear flag for drawing on widget,
+         * but only if widget will not be drawn again in one of next region rectangles
+         */
+        if (!__GUI_WIDGET_IsInsideRegion(h, &GUI.Region, index + 1)) {
+            __GUI_WIDGET_ClrFlag(h, GUI_FLAG_REDRAW);
+        }
+        
+        t.Layer = NULL;
+        t.LayerPrev = GUI.LCD.DrawingLayer;         /* Save drawing layer */
+        t.Cache = 0;
+        memcpy(&t.Blend, &disp, sizeof(disp));
+        memcpy(&area, &disp, sizeof(disp));         /* Part of widget to draw */
+        
+        /**
+         * Check transparency and check if blending function exists to merge layers later together
+         */
+        if (__GUI_WIDGET_IsTransparent(h) && GUI.LL.CopyBlend) {
+            /**
+             * Widget with unchanged content is only blended again from its cache,
+             * otherwise entire visible area of widget is drawn to new cache
+             */
+            if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_CACHE)) {
+                __GUI_WIDGET_GetVisibleRect(h, &area);
+                if (area.X1 < area.X2 && area.Y1 < area.Y2) {
+                    t.Layer = __GUI_SCRATCH_GetCache(h, &area);
+                    if (t.Layer) {                  /* Content has not changed */
+                        if (__GUI_WIDGET_AllowChildren(h)) {
+                            __ClearRedrawFlags(h);  /* Children are part of cached content */
+                        }
+                        __GUI_STATS_INC(WidgetsSkipped);
+                        __FinishWidget(h, &t);
+                        continue;
                     }
-                }
-                
-                /**
-                 * Draw widget itself normally, don't care on layer offset and size
-                 */
-                __GUI_WIDGET_Callback(h, GUI_WC_Draw, &GUI.DisplayTemp, NULL);  /* Draw widget */
-                
-                /* Check if there are children widgets in this widget */
-                if (__GUI_WIDGET_AllowChildren(h)) {
-                    GUI_HANDLE_p tmp;
-                    
-                    /* Set drawing flag to all widgets  first... */
-                    for (tmp = __GUI_LINKEDLIST_WidgetGetNext((GUI_HANDLE_ROOT_t *)h, NULL); tmp; 
-                            tmp = __GUI_LINKEDLIST_WidgetGetNext(NULL, tmp)) {
-                        __GUI_WIDGET_SetFlag(tmp, GUI_FLAG_REDRAW); /* Set redraw bit to all children elements */
+                    t.Layer = __GUI_SCRATCH_NewCache(h, &area);
+                    if (t.Layer) {
+                        t.Cache = 1;
+                        memcpy(&t.Region, &GUI.Display, sizeof(t.Region)); /* Save region rectangle */
+                        memcpy(&GUI.Display, &area, sizeof(GUI.Display));
                     }
-                    /* ...now call function for redrawing process */
-                    level++;
-                    cnt += __RedrawWidgets(h);      /* Redraw children widgets */
-                    level--;
                 }
-                
-                /**
-                 * TODO: If widget has transparency, 
-                 * copy drawed area back to main drawing layer with blending
-                 * between layers
-                 */
-                if (transparent) {                  /* If we were in transparent mode */
-                    /* Copy layers with blending */
-                    GUI.LL.CopyBlend(&GUI.LCD, GUI.LCD.DrawingLayer,
-                        (void *)GUI.LCD.DrawingLayer->StartAddress, 
-                        (void *)(layerPrev->StartAddress + 
-                            GUI.LCD.PixelSize * (layerPrev->Width * (GUI.LCD.DrawingLayer->OffsetY - layerPrev->OffsetY) + (GUI.LCD.DrawingLayer->OffsetX - layerPrev->OffsetX))),
-                        __GUI_WIDGET_GetTransparency(h), 0xFF,
-                        GUI.LCD.DrawingLayer->Width, GUI.LCD.DrawingLayer->Height,
-                        0, layerPrev->Width - GUI.LCD.DrawingLayer->Width
-                    );
-                    
-                    __GUI_MEMFREE(GUI.LCD.DrawingLayer);    /* Free memory for virtual layer */
-                    GUI.LCD.DrawingLayer = layerPrev;   /* Reset layer pointer */
-                }
-                
+            }
+            
             /**
-             * Check if any widget from children should be redrawn
+             * Try to get virtual layer for temporary usage
              */
-            } else if (__GUI_WIDGET_AllowChildren(h)) {
-                cnt += __RedrawWidgets(h);          /* Redraw children widgets */
+            if (!t.Layer) {
+                memcpy(&area, &disp, sizeof(disp)); /* Draw only region rectangle without cache */
+                t.Layer = __GUI_SCRATCH_Get(disp.X1, disp.Y1, disp.X2 - disp.X1, disp.Y2 - disp.Y1);
+            }
+            if (t.Layer) {                          /* Check if allocation was successful */
+                GUI.LCD.DrawingLayer = t.Layer;     /* We are going to transparent drawing mode */
+            }
+        }
+        
+        /**
+         * Draw widget itself normally, don't care on layer offset and size
+         */
+        __GUI_WIDGET_Callback(h, GUI_WC_Draw, &area, NULL); /* Draw widget */
+        __GUI_STATS_INC(WidgetsDrawn);
+        ctx->Count++;
+        
+        /* Check if there are children widgets in this widget */
+        if (__GUI_WIDGET_AllowChildren(h)) {
+            /* Set drawing flag to all widgets first... */
+            for (tmp = __GUI_LINKEDLIST_WidgetGetNext((GUI_HANDLE_ROOT_t *)h, NULL); tmp; 
+                    tmp = __GUI_LINKEDLIST_WidgetGetNext(NULL, tmp)) {
+                __GUI_WIDGET_SetFlag(tmp, GUI_FLAG_REDRAW); /* Set redraw bit to all children elements */
+            }
+            /* ...now draw them and finish widget after last one */
+            __ClipChildren(h, &area, &inner);
+            if (__RedrawPush(ctx, h, &inner)) {
+                memcpy(&ctx->Levels[ctx->Depth - 1].Target, &t, sizeof(t));
+                continue;
             }
         }
+        __FinishWidget(h, &t);
     }
-    return cnt;                                     /* Return number of redrawn objects */
+    return ctx->Count;                              /* Return number of redrawn objects */
+}
+
+#if GUI_OCCLUSION_RECTS
+/**
+ * Collect parts of region which are completely repainted in this frame, return number of rectangles.
+ * Opaque widget with redraw flag draws every pixel of its visible area, unless it is blended
+ * to layer with transparent parent widget or it is too deep in tree to be drawn
+ */
+static
+size_t __GetRepainted(GUI_Display_t* rects, size_t max) {
+    GUI_HANDLE_p h, p;
+    GUI_Display_t vis;
+    size_t cnt = 0, i, depth;
+    uint8_t children = 0;
+    
+    for (h = __GUI_LINKEDLIST_WidgetGetNext(NULL, NULL); h && cnt < max; h = __GUI_WIDGET_GetNextInTree(NULL, h, children)) {
+        children = 0;
+        if (!__GUI_WIDGET_IsVisible(h) || __GUI_WIDGET_IsTransparent(h) || !__GUI_WIDGET_IsInsideRegion(h, &GUI.Region, 0)) {
+            continue;                               /* Widget and its children are not drawn directly in region */
+        }
+        if (!__GUI_WIDGET_IsOpaque(h) || !__GUI_WIDGET_GetFlag(h, GUI_FLAG_REDRAW)) {
+            children = 1;                           /* Children widgets may still be repainted */
+            continue;
+        }
+        for (depth = 1, p = __GH(h)->Parent; p; p = __GH(p)->Parent) {
+            depth++;
+        }
+        if (depth > GUI_WIDGET_MAX_DEPTH) {         /* Widget is not drawn, content must be copied */
+            continue;
+        }
+        
+        __GUI_WIDGET_GetVisibleRect(h, &vis);
+        for (i = 0; i < GUI.Region.Count && cnt < max; i++) {
+            const GUI_Display_t* r = &GUI.Region.Rects[i];
+            if (RECT_INTERSECTS(&vis, r)) {
+                rects[cnt].X1 = __GUI_MAX(vis.X1, r->X1);
+                rects[cnt].Y1 = __GUI_MAX(vis.Y1, r->Y1);
+                rects[cnt].X2 = __GUI_MIN(vis.X2, r->X2);
+                rects[cnt].Y2 = __GUI_MIN(vis.Y2, r->Y2);
+                cnt++;
+            }
+        }
+    }
+    return cnt;
+}
+#endif /* GUI_OCCLUSION_RECTS */
+
+/* Copy rectangle from active layer to drawing layer, except parts which are repainted */
+static
+void __CopyBack(const GUI_Display_t* r, const GUI_Display_t* rep, size_t cnt) {
+    GUI_Layer_t* src = GUI.LCD.ActiveLayer;
+    GUI_Layer_t* dst = GUI.LCD.DrawingLayer;
+    GUI_Display_t parts[4];
+    size_t i, n;
+    
+    for (; cnt; cnt--, rep++) {
+        if (RECT_INTERSECTS(r, rep)) {              /* Copy only parts outside repainted rectangle */
+            n = __GUI_REGION_Subtract(r, rep, parts);
+            for (i = 0; i < n; i++) {
+                __CopyBack(&parts[i], rep + 1, cnt - 1);
+            }
+            return;
+        }
+    }
+    
+    GUI.LL.Copy(&GUI.LCD, dst, 
+        (void *)(src->StartAddress + GUI.LCD.PixelSize * (r->Y1 * src->Width + r->X1)),   /* Source address */
+        (void *)(dst->StartAddress + GUI.LCD.PixelSize * (r->Y1 * dst->Width + r->X1)),   /* Destination address */
+        r->X2 - r->X1,                              /* Area width */
+        r->Y2 - r->Y1,                              /* Area height */
+        src->Width - (r->X2 - r->X1),               /* Offline source */
+        dst->Width - (r->X2 - r->X1)                /* Offline destination */
+    );
+    __GUI_STATS_ADD(CopyBackArea, (uint32_t)(r->X2 - r->X1) * (r->Y2 - r->Y1));
+}
+
+/**
+ * Bring drawing layer up to date before first drawing of new frame.
+ *
+ * Layer misses damage of all frames drawn on other layers after it, each layer keeps damage of its last frame.
+ * With 2 layers this is damage of active layer only, with more layers drawing layer is the oldest one
+ * and damage of all other layers is copied. Parts which are repainted in this frame are not copied
+ */
+static
+void __UpdateDrawingLayer(void) {
+    GUI_Layer_t* drawing = GUI.LCD.DrawingLayer;
+    GUI_Region_t damage;
+    size_t i, k, cnt = 0;
+#if GUI_OCCLUSION_RECTS
+    GUI_Display_t rep[GUI_OCCLUSION_RECTS];
+#else
+    GUI_Display_t* rep = NULL;
+#endif /* GUI_OCCLUSION_RECTS */
+    
+    if (drawing == GUI.LCD.ActiveLayer) {           /* Single layer is always up to date */
+        return;
+    }
+    
+    __GUI_REGION_Reset(&damage);
+    if (!drawing->Frame) {                          /* Layer has no content yet */
+        GUI_Display_t lcd = {0, 0, (GUI_iDim_t)GUI.LCD.Width, (GUI_iDim_t)GUI.LCD.Height};
+        __GUI_REGION_Add(&damage, &lcd);
+    } else {
+        for (k = 0; k < GUI.LCD.LayersCount; k++) {
+            GUI_Layer_t* layer = &GUI.LCD.Layers[k];
+            if (layer->Frame <= drawing->Frame) {   /* Layer content is older */
+                continue;
+            }
+            if (!damage.Count) {                    /* Region rectangles are disjoint already */
+                memcpy(&damage, &layer->Region, sizeof(damage));
+            } else {
+                for (i = 0; i < layer->Region.Count; i++) {
+                    __GUI_REGION_Add(&damage, &layer->Region.Rects[i]);
+                }
+            }
+        }
+    }
+    if (!damage.Count) {
+        return;
+    }
+    
+#if GUI_OCCLUSION_RECTS
+    cnt = __GetRepainted(rep, GUI_OCCLUSION_RECTS);
+#endif /* GUI_OCCLUSION_RECTS */
+    for (i = 0; i < damage.Count; i++) {
+        __CopyBack(&damage.Rects[i], rep, cnt);
+    }
+}
+
+/* Get layer for next frame, it is the layer with the oldest content which is not active */
+static
+GUI_Layer_t* __GetNextDrawingLayer(void) {
+    GUI_Layer_t* next = GUI.LCD.ActiveLayer;
+    size_t k;
+    
+    for (k = 0; k < GUI.LCD.LayersCount; k++) {
+        GUI_Layer_t* layer = &GUI.LCD.Layers[k];
+        if (layer != GUI.LCD.ActiveLayer && (next == GUI.LCD.ActiveLayer || layer->Frame < next->Frame)) {
+            next = layer;
+        }
+    }
+    return next;
 }
 
 #if GUI_USE_TOUCH
@@ -358,106 +749,216 @@ void __SetRelativeCoordinate(__GUI_TouchData_t* ts, GUI_iDim_t x, GUI_iDim_t y,
 #endif /* GUI_TOUCH_MAX_PRESSES > 1 */
 }
 
-__GUI_TouchStatus_t __ProcessTouch(__GUI_TouchData_t* touch, GUI_HANDLE_p parent) {
+/**
+ * Get previous widget on parent linked list which should be checked for touch
+ *
+ * When spatial index is used, only widgets from index cell whose visible area includes touch point are returned.
+ * Widget which is not returned can't be touched, neither any of its children widgets
+ */
+static
+GUI_HANDLE_p __GetPrevTouchWidget(GUI_HANDLE_p parent, GUI_HANDLE_p h, __GUI_TouchData_t* touch, GUI_Grid_t* grid, size_t start, size_t* pos) {
+    if (grid) {
+        while (*pos > start) {                      /* Check references in cell from top to bottom */
+            size_t i = grid->Refs[--*pos];
+            if (touch->TS.X[0] >= grid->Rects[i].X1 && touch->TS.X[0] <= grid->Rects[i].X2 && 
+                touch->TS.Y[0] >= grid->Rects[i].Y1 && touch->TS.Y[0] <= grid->Rects[i].Y2) {
+                return grid->Items[i];
+            }
+        }
+        return NULL;
+    }
+    return __GUI_LINKEDLIST_WidgetGetPrev((GUI_HANDLE_ROOT_t *)parent, h);
+}
+
+/* Start checking children widgets of parent, return 0 when there is nothing to check or tree is too deep */
+static
+uint8_t __TouchPush(GUI_TouchSearch_t* ctx, GUI_HANDLE_p parent, const GUI_Display_t* clip) {
+    GUI_TouchLevel_t* lvl;
+#if GUI_WIDGET_GRID_CHILDREN
     GUI_HANDLE_p h;
-    static uint8_t deep = 0;
-    static uint8_t isKeyboard = 0;
-    uint8_t dialogOnly = 0;
-    __GUI_TouchStatus_t tStat = touchCONTINUE;
+#endif /* GUI_WIDGET_GRID_CHILDREN */
+    
+    if (ctx->Depth >= GUI_WIDGET_MAX_DEPTH) {       /* Children widgets can't be touched */
+        if (__GUI_LINKEDLIST_WidgetGetNext((GUI_HANDLE_ROOT_t *)parent, NULL)) {
+            __GUI_DEBUG("Widget tree is deeper than GUI_WIDGET_MAX_DEPTH, children widgets can't be touched\r\n");
+        }
+        return 0;
+    }
+    lvl = &ctx->Levels[ctx->Depth];
+    lvl->Parent = parent;
+    lvl->h = NULL;
+    memcpy(&lvl->Clip, clip, sizeof(lvl->Clip));
+    lvl->Grid = NULL;
+    lvl->Start = 0;
+    lvl->Pos = 0;
+    lvl->DialogOnly = 0;
+    
+#if GUI_WIDGET_GRID_CHILDREN
+    /**
+     * Parent with many children widgets has spatial index of them,
+     * use it to check only widgets which are under touch point
+     */
+    if (parent) {
+        lvl->Grid = __GUI_WIDGET_GetChildrenGrid(parent);
+    }
+    if (lvl->Grid) {
+        if (!__GUI_GRID_GetCell(lvl->Grid, ctx->Touch->TS.X[0], ctx->Touch->TS.Y[0], &lvl->Start, &lvl->Pos)) {
+            return 0;                               /* No widget under touch point */
+        }
+        
+        /**
+         * Visible dialog element on base elements list disables touch on all other widgets.
+         * Dialogs are always on the end of linked list
+         */
+        if (ctx->Depth == 1) {
+            for (h = __GUI_LINKEDLIST_WidgetGetPrev(__GHR(parent), 0); h && __GUI_WIDGET_IsDialogBase(h); h = __GUI_LINKEDLIST_WidgetGetPrev(__GHR(parent), h)) {
+                if (!__GUI_WIDGET_IsHidden(h)) {
+                    lvl->DialogOnly = 1;
+                    break;
+                }
+            }
+        }
+    }
+#endif /* GUI_WIDGET_GRID_CHILDREN */
+    ctx->Depth++;
+    return 1;
+}
+
+/* Get next widget on level to check for touch, go reverse on linked list */
+static
+GUI_HANDLE_p __TouchNext(GUI_TouchSearch_t* ctx, GUI_TouchLevel_t* lvl) {
+    GUI_HANDLE_p h = lvl->h;
     
-    /* Check touches if any matches, go reverse on linked list */
-    for (h = __GUI_LINKEDLIST_WidgetGetPrev((GUI_HANDLE_ROOT_t *)parent, 0); h; h = __GUI_LINKEDLIST_WidgetGetPrev((GUI_HANDLE_ROOT_t *)parent, h)) {
+    while ((h = __GetPrevTouchWidget(lvl->Parent, h, ctx->Touch, lvl->Grid, lvl->Start, &lvl->Pos)) != NULL) {
         if (__GUI_WIDGET_IsHidden(h)) {             /* Ignore hidden widget */
             continue;
         }
         
-        if (deep == 1) {                            /* On base elements list = children of base window element */
+        if (lvl == &ctx->Levels[1]) {               /* On base elements list = children of base window element */
             if (__GUI_WIDGET_IsDialogBase(h)) {     /* We found dialog element */
-                dialogOnly = 1;                     /* Check only widgets which are dialog based */
+                lvl->DialogOnly = 1;                /* Check only widgets which are dialog based */
             }
         }
         
         /* When we should only check dialogs and previous element is not dialog anymore */
-        if (dialogOnly && !__GUI_WIDGET_IsDialogBase(h)) {
-            break;
-        }
-        
-        /* Check for keyboard mode */
-        if (__GUI_WIDGET_GetId(h) == GUI_ID_KEYBOARD_BASE) {
-            isKeyboard = 1;                         /* Set keyboard mode as 1 */
+        if (lvl->DialogOnly && !__GUI_WIDGET_IsDialogBase(h)) {
+            return NULL;
         }
-        
-        /* Check children elements first */
-        if (__GUI_WIDGET_AllowChildren(h)) {        /* If children widgets are allowed */
-            deep++;                                 /* Go deeper in level */
-            tStat = __ProcessTouch(touch, h);       /* Process touch on widget elements first */
-            deep--;                                 /* Go back to normal level */
+        return h;
+    }
+    return NULL;
+}
+
+/* Check widget itself for touch when none of its children widgets handled it */
+static
+__GUI_TouchStatus_t __TouchWidget(GUI_TouchSearch_t* ctx, GUI_HANDLE_p h, const GUI_Display_t* disp) {
+    __GUI_TouchData_t* touch = ctx->Touch;
+    __GUI_TouchStatus_t tStat = touchCONTINUE;
+    
+    /* Check if widget is in touch area */
+    if (touch->TS.X[0] >= disp->X1 && touch->TS.X[0] <= disp->X2 && 
+        touch->TS.Y[0] >= disp->Y1 && touch->TS.Y[0] <= disp->Y2) {
+        __SetRelativeCoordinate(touch,              /* Set relative coordinate */
+            __GUI_WIDGET_GetAbsoluteX(h), __GUI_WIDGET_GetAbsoluteY(h), 
+            __GUI_WIDGET_GetWidth(h), __GUI_WIDGET_GetHeight(h)
+        ); 
+    
+        __GUI_WIDGET_Callback(h, GUI_WC_TouchStart, touch, &tStat);
+        if (tStat == touchCONTINUE) {               /* Check result status */
+            tStat = touchHANDLED;                   /* If command is processed, touchCONTINUE can't work */
         }
-        
         /**
-         * Children widgets were not detected
+         * Move widget down on parent linked list and do the same with all of its parents,
+         * no matter of touch focus or not
          */
-        if (tStat == touchCONTINUE) {               /* Do we still have to check this widget? */
-            __CheckDispClipping(h);                 /* Check display region where widget is placed */
+        __GUI_WIDGET_MoveDownTree(h);
         
-            /* Check if widget is in touch area */
-            if (touch->TS.X[0] >= GUI.DisplayTemp.X1 && touch->TS.X[0] <= GUI.DisplayTemp.X2 && 
-                touch->TS.Y[0] >= GUI.DisplayTemp.Y1 && touch->TS.Y[0] <= GUI.DisplayTemp.Y2) {
-                __SetRelativeCoordinate(touch,      /* Set relative coordinate */
-                    __GUI_WIDGET_GetAbsoluteX(h), __GUI_WIDGET_GetAbsoluteY(h), 
-                    __GUI_WIDGET_GetWidth(h), __GUI_WIDGET_GetHeight(h)
-                ); 
+        if (tStat == touchHANDLED) {                /* Touch handled for widget completelly */
+            /**
+             * Set active widget and set flag for it
+             * Set focus widget and set flag for it but only do this if widget is not related to keyboard
+             *
+             * This allows us to click keyboard items but not to lose focus on main widget
+             */
+            if (!ctx->IsKeyboard) {
+                __GUI_WIDGET_FOCUS_SET(h);
+            }
+            __GUI_WIDGET_ACTIVE_SET(h);
             
-                __GUI_WIDGET_Callback(h, GUI_WC_TouchStart, touch, &tStat);
-                if (tStat == touchCONTINUE) {       /* Check result status */
-                    tStat = touchHANDLED;           /* If command is processed, touchCONTINUE can't work */
-                }
-                /**
-                 * Move widget down on parent linked list and do the same with all of its parents,
-                 * no matter of touch focus or not
-                 */
-                __GUI_WIDGET_MoveDownTree(h);
-                
-                if (tStat == touchHANDLED) {        /* Touch handled for widget completelly */
-                    /**
-                     * Set active widget and set flag for it
-                     * Set focus widget and set flag for it but only do this if widget is not related to keyboard
-                     *
-                     * This allows us to click keyboard items but not to lose focus on main widget
-                     */
-                    if (!isKeyboard) {
-                        __GUI_WIDGET_FOCUS_SET(h);
-                    }
-                    __GUI_WIDGET_ACTIVE_SET(h);
-                    
-                    /**
-                     * Invalidate actual handle object
-                     * Already invalidated in __GUI_ACTIVE_SET function
-                     */
-                    //__GUI_WIDGET_Invalidate(h);
-                } else {                            /* Touch handled with no focus */
-                    /**
-                     * When touch was handled without focus,
-                     * process only clearing currently focused and active widgets and clear them
-                     */
-                    if (!isKeyboard) {
-                        __GUI_WIDGET_FOCUS_CLEAR();
-                    }
-                    __GUI_WIDGET_ACTIVE_CLEAR();
+            /**
+             * Invalidate actual handle object
+             * Already invalidated in __GUI_ACTIVE_SET function
+             */
+            //__GUI_WIDGET_Invalidate(h);
+        } else {                                    /* Touch handled with no focus */
+            /**
+             * When touch was handled without focus,
+             * process only clearing currently focused and active widgets and clear them
+             */
+            if (!ctx->IsKeyboard) {
+                __GUI_WIDGET_FOCUS_CLEAR();
+            }
+            __GUI_WIDGET_ACTIVE_CLEAR();
+        }
+    }
+    return tStat;
+}
+
+/**
+ * Find widget under touch point and start touch on it.
+ * Children widgets are checked before their parent, tree is walked with explicit stack
+ */
+static
+__GUI_TouchStatus_t __ProcessTouch(GUI_TouchSearch_t* ctx, const GUI_Display_t* clip) {
+    GUI_TouchLevel_t* lvl;
+    GUI_HANDLE_p h;
+    GUI_Display_t inner;
+    __GUI_TouchStatus_t tStat;
+    
+    ctx->Depth = 0;
+    ctx->IsKeyboard = 0;
+    __TouchPush(ctx, NULL, clip);                   /* Start with base widgets */
+    
+    while (ctx->Depth) {
+        lvl = &ctx->Levels[ctx->Depth - 1];
+        h = __TouchNext(ctx, lvl);
+        if (h) {
+            lvl->h = h;
+            
+            /* Check for keyboard mode */
+            if (__GUI_WIDGET_GetId(h) == GUI_ID_KEYBOARD_BASE) {
+                ctx->IsKeyboard = 1;                /* Set keyboard mode as 1 */
+            }
+            
+            __ClipWidget(h, &lvl->Clip, &lvl->Disp);    /* Check display region where widget is placed */
+            
+            /* Check children elements first */
+            if (__GUI_WIDGET_AllowChildren(h)) {    /* If children widgets are allowed */
+                __ClipChildren(h, &lvl->Disp, &inner);
+                if (__TouchPush(ctx, h, &inner)) {  /* Go deeper in level */
+                    continue;
                 }
             }
+        } else {                                    /* Children widgets were not detected */
+            if (!--ctx->Depth) {                    /* Base widgets were not detected */
+                break;
+            }
+            lvl = &ctx->Levels[ctx->Depth - 1];     /* Go back to parent widget */
+            h = lvl->h;
         }
         
+        tStat = __TouchWidget(ctx, h, &lvl->Disp);
+        
         /* Check for keyboard mode */
         if (__GUI_WIDGET_GetId(h) == GUI_ID_KEYBOARD_BASE) {
-            isKeyboard = 0;                         /* Set keyboard mode as 1 */
+            ctx->IsKeyboard = 0;                    /* Clear keyboard mode */
         }
         
         if (tStat != touchCONTINUE) {               /* Return status if necessary */
             return tStat;
         }
     }
-    return touchCONTINUE;                           /* Try with another widget */
+    return touchCONTINUE;                           /* No widget handled touch */
 }
 #endif /* GUI_USE_TOUCH */
 
@@ -492,10 +993,13 @@ GUI_Result_t GUI_Init(void) {
             GUI.LCD.Layers[i].OffsetY = 0;
             GUI.LCD.Layers[i].Width = GUI.LCD.Width;
             GUI.LCD.Layers[i].Height = GUI.LCD.Height;
+            GUI.LCD.Layers[i].Frame = 0;            /* Layer has no content yet */
         }
         GUI.LCD.ActiveLayer = &GUI.LCD.Layers[0];
         GUI.LCD.DrawingLayer = &GUI.LCD.Layers[0];
         GUI.LL.Fill(&GUI.LCD, GUI.LCD.DrawingLayer, (void *)GUI.LCD.DrawingLayer->StartAddress, GUI.LCD.Width, GUI.LCD.Height, 0, 0xFFFFFFFF);
+        GUI.LCD.Frame = 1;
+        GUI.LCD.ActiveLayer->Frame = GUI.LCD.Frame; /* Active layer is filled and shown as first frame */
         if (GUI.LCD.LayersCount > 1) {
             GUI.LCD.DrawingLayer = &GUI.LCD.Layers[1];
         }
@@ -503,6 +1007,8 @@ GUI_Result_t GUI_Init(void) {
         return guiERROR;
     }
     
+    /* Count low-level drawing operations */
+    __GUI_STATS_Init();
     
     /* Init input devices */
     __GUI_INPUT_Init();
@@ -515,9 +1021,9 @@ GUI_Result_t GUI_Init(void) {
     
     return guiOK;
 }
-#include "tm_stm32_general.h"
 int32_t GUI_Process(void) {
     int32_t cnt = 0;
+    uint32_t time = __GUI_STATS_GetTime();          /* Start time for statistics */
 #if GUI_USE_TOUCH
     __GUI_TouchStatus_t tStat;
     GUI_WC_t result;
@@ -561,7 +1067,11 @@ int32_t GUI_Process(void) {
                  * New status: pressed
                  * Action: Touch down on element, find element
                  */
-                __ProcessTouch(&GUI.Touch, NULL);
+                GUI_Display_t lcd = {0, 0, (GUI_iDim_t)GUI.LCD.Width, (GUI_iDim_t)GUI.LCD.Height};
+                GUI_TouchSearch_t search;
+                
+                search.Touch = &GUI.Touch;
+                __ProcessTouch(&search, &lcd);      /* Clipping of base widgets is entire LCD */
                 if (GUI.ActiveWidget != GUI.ActiveWidgetPrev) { /* If new active widget is not the same as previous */
                     PT_INIT(&GUI.Touch.pt)          /* Reset thread, otherwise process with double click event */
                 }
@@ -630,6 +1140,7 @@ int32_t GUI_Process(void) {
         }
     }
 #endif /* GUI_USE_KEYBOARD */
+    __GUI_STATS_TIME(TimeInput, time);              /* Time of input processing */
     
     /**
      * Timer processing
@@ -642,61 +1153,87 @@ int32_t GUI_Process(void) {
     if (GUI.Flags & GUI_FLAG_REMOVE) {              /* Check if at least one widget should be deleted */
         __GUI_WIDGET_ExecuteRemove();               /* Execute deletion */
     }
+    __GUI_STATS_TIME(TimeTimers, time);             /* Time of timers and removal */
     
     /**
      * Redrawing operations
+     *
+     * Drawing layer must not be shown on LCD. With 2 layers it is shown until new active layer is confirmed,
+     * with more layers it is the oldest one and next frame is drawn while confirmation is pending
      */
-    if (!(GUI.LCD.Flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM) && (GUI.Flags & GUI_FLAG_REDRAW)) {  /* Check if anything to draw first */
-        uint32_t time;
-        GUI_Layer_t* active = GUI.LCD.ActiveLayer;
+    if ((GUI.Flags & GUI_FLAG_REDRAW) && (GUI.LCD.LayersCount > 2 || !(GUI.LCD.Flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM))) {
         GUI_Layer_t* drawing = GUI.LCD.DrawingLayer;
-        uint8_t result = 1;
-        GUI_Display_t* dispA = &active->Display;
+        GUI_Redraw_t redraw;
+        size_t i;
         
         GUI.Flags &= ~GUI_FLAG_REDRAW;              /* Clear redraw flag */
         
-        time = TM_GENERAL_DWTCounterGetValue();
+#if GUI_USE_STATS
+        for (i = 0; i < GUI.Region.Count; i++) {    /* Region rectangles are disjoint */
+            __GUI_STATS_ADD(DirtyArea, (uint32_t)(GUI.Region.Rects[i].X2 - GUI.Region.Rects[i].X1) * (GUI.Region.Rects[i].Y2 - GUI.Region.Rects[i].Y1));
+        }
+#endif /* GUI_USE_STATS */
         
-        /* Copy from currently active layer to drawing layer only changes on layer */
-        GUI.LL.Copy(&GUI.LCD, drawing, 
-            (void *)(active->StartAddress + GUI.LCD.PixelSize * (dispA->Y1 * active->Width + dispA->X1)),    /* Source address */
-            (void *)(drawing->StartAddress + GUI.LCD.PixelSize * (dispA->Y1 * drawing->Width + dispA->X1)),   /* Destination address */
-            dispA->X2 - dispA->X1,                  /* Area width */
-            dispA->Y2 - dispA->Y1,                  /* Area height */
-            active->Width - (dispA->X2 - dispA->X1),    /* Offline source */
-            drawing->Width - (dispA->X2 - dispA->X1)    /* Offline destination */
-        );
+        /* Copy changes of newer layers to drawing layer before first drawing on it */
+        if (!(GUI.LCD.Flags & GUI_FLAG_LCD_LAYER_DRAWN)) {
+            __UpdateDrawingLayer();
+        }
             
-        /* Actually draw new screen based on setup */
-        cnt = __RedrawWidgets(NULL);                /* Redraw all widgets now */
+        /* Actually draw new screen based on setup, one region rectangle at a time */
+        for (i = 0; i < GUI.Region.Count; i++) {
+            memcpy(&GUI.Display, &GUI.Region.Rects[i], sizeof(GUI.Display));
+            cnt += __RedrawWidgets(&redraw, i);     /* Redraw all widgets now */
+        }
+        
+        /* Keep damage of layer until its content is used again */
+        if (!(GUI.LCD.Flags & GUI_FLAG_LCD_LAYER_DRAWN)) {
+            memcpy(&drawing->Region, &GUI.Region, sizeof(GUI.Region));
+            GUI.LCD.Flags |= GUI_FLAG_LCD_LAYER_DRAWN;
+        } else {
+            for (i = 0; i < GUI.Region.Count; i++) {
+                __GUI_REGION_Add(&drawing->Region, &GUI.Region.Rects[i]);
+            }
+        }
+        __GUI_REGION_Reset(&GUI.Region);
+        
+        /* Invalid clipping region(s) for next drawing process */
+        GUI.Display.X1 = 0x7FFF;
+        GUI.Display.Y1 = 0x7FFF;
+        GUI.Display.X2 = 0x8000;
+        GUI.Display.Y2 = 0x8000;
             
-        /* Get cycles for drawing */
-        time = TM_GENERAL_DWTCounterGetValue() - time;
+        __GUI_STATS_TIME(TimeRedraw, time);         /* Time of drawing */
+    }
+    
+    /**
+     * Show drawn layer when previous active layer has been confirmed
+     */
+    if ((GUI.LCD.Flags & GUI_FLAG_LCD_LAYER_DRAWN) && !(GUI.LCD.Flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM)) {
+        GUI_Layer_t* drawing = GUI.LCD.DrawingLayer;
+        uint8_t result = 1;
+        
+        /* Wait for all queued drawing operations before layer is shown */
+        __GUI_LL_FENCE();
         
         /* Set drawing layer as pending */
         drawing->Pending = 1;
+        drawing->Frame = ++GUI.LCD.Frame;           /* Layer has content of newest frame */
         
         /* Notify low-level about layer change */
+        GUI.LCD.Flags &= ~GUI_FLAG_LCD_LAYER_DRAWN;
         GUI.LCD.Flags |= GUI_FLAG_LCD_WAIT_LAYER_CONFIRM;
-        GUI_LL_Control(&GUI.LCD, GUI_LL_Command_SetActiveLayer, &drawing, &result); /* Set new active layer to low-level driver */
+        GUI_LL_Control(&GUI.LCD, GUI_LL_Command_SetActiveLayer, &drawing->Num, &result);    /* Set new active layer to low-level driver */
         
-        /* Swap active and drawing layers */
         /* New drawings won't be affected until confirmation from low-level is not received */
         GUI.LCD.ActiveLayer = drawing;
-        GUI.LCD.DrawingLayer = active;
-        
-        /* Copy clipping data to region */
-        memcpy(&GUI.LCD.ActiveLayer->Display, &GUI.Display, sizeof(GUI.Display));
+        GUI.LCD.DrawingLayer = __GetNextDrawingLayer();
         
-        /* Invalid clipping region(s) for next drawing process */
-        GUI.Display.X1 = 0x7FFF;
-        GUI.Display.Y1 = 0x7FFF;
-        GUI.Display.X2 = 0x8000;
-        GUI.Display.Y2 = 0x8000;
-        
-        __GUI_UNUSED(time);                         /* Prevent compiler warnings */
+        __GUI_STATS_TIME(TimeSwap, time);           /* Time of waiting for drawing and layer swap */
+        __GUI_STATS_FrameDone();                    /* Frame is finished */
     }
     
+    __GUI_UNUSED(time);                             /* Prevent compiler warnings */
+    
     return cnt;                                     /* Return number of elements updated on GUI */
 }
 
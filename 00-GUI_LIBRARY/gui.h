@@ -62,6 +62,14 @@ extern "C" {
 #include "utils/gui_math.h"
 #include "utils/gui_mem.h"
 #include "utils/gui_translate.h"
+#include "utils/gui_region.h"
+#include "utils/gui_grid.h"
+#include "utils/gui_idmap.h"
+#include "utils/gui_stats.h"
+#include "utils/gui_scratch.h"
+#include "utils/gui_glyph.h"
+#include "utils/gui_textlayout.h"
+#include "utils/gui_batch.h"
 
 /* GUI Low-Level drivers */
 #include "gui_ll.h"
@@ -133,6 +141,18 @@ extern "C" {
     (p) = NULL;                                     \
 } while (0);
 
+/**
+ * \brief           Wait for low-level layer to finish all queued drawing operations
+ * \note            Low-level drawing functions may only queue operation and return before it is finished.
+ *                  Fence must be used before CPU reads pixels from layer or before memory used by queued operations is released.
+ *                  Commands collected in drawing batch are sent to driver first
+ * \hideinitializer
+ */
+#define __GUI_LL_FENCE()            do {            \
+    __GUI_BATCH_Flush();                            \
+    while (!GUI.LL.IsReady(&GUI.LCD));              \
+} while (0)
+
 /**
  * \brief           Check input parameters and return value on failure
  * \hideinitializer
@@ -243,18 +263,17 @@ typedef struct GUI_t {
     
     uint32_t Flags;                         /*!< Core GUI flags management */
     
-    GUI_Display_t Display;                  /*!< Clipping management */
-    GUI_Display_t DisplayTemp;              /*!< Clipping for widgets for drawing and touch */
+    GUI_Region_t Region;                    /*!< List of invalidated regions waiting for redraw */
+    GUI_Display_t Display;                  /*!< Clipping management, region currently being redrawn */
     
     GUI_HANDLE_p WindowActive;              /*!< Pointer to currently active window when creating new widgets */
     GUI_HANDLE_p FocusedWidget;             /*!< Pointer to focused widget for keyboard events if any */
     GUI_HANDLE_p FocusedWidgetPrev;         /*!< Pointer to previously focused widget */
     
     GUI_LinkedListRoot_t Root;              /*!< Root linked list of widgets */
+    GUI_IdMap_t IdMap;                      /*!< Hash map of widget IDs for fast search */
     GUI_TIMER_CORE_t Timers;                /*!< Software structure management */
     
-    GUI_LinkedListRoot_t RootFonts;         /*!< Root linked list of font widgets */
-    
 #if GUI_USE_TOUCH || defined(DOXYGEN)
     __GUI_TouchData_t TouchOld;             /*!< Old touch data, used for event management */
     __GUI_TouchData_t Touch;                /*!< Current touch data and processing tool */
@@ -266,6 +285,10 @@ typedef struct GUI_t {
     GUI_TRANSLATE_t Translate;              /*!< Translation management structure */
 #endif /* GUI_USE_TRANSLATE */
 
+#if GUI_USE_STATS || defined(DOXYGEN)
+    GUI_STATS_t Stats;                      /*!< Render statistics of frame currently being processed */
+#endif /* GUI_USE_STATS || defined(DOXYGEN) */
+
     uint8_t Initialized;                    /*!< Status indicating GUI is initialized */
 } GUI_t;
 #if defined(GUI_INTERNAL)
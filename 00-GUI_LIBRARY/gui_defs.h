@@ -45,6 +45,47 @@ extern "C" {
 #include "gui_config.h"
 #include "pt/pt.h"
 
+/* Default values for options not set in configuration file */
+#ifndef GUI_DISPLAY_REGIONS
+#define GUI_DISPLAY_REGIONS             8
+#endif /* GUI_DISPLAY_REGIONS */
+#ifndef GUI_DISPLAY_REGIONS_WASTE
+#define GUI_DISPLAY_REGIONS_WASTE       25
+#endif /* GUI_DISPLAY_REGIONS_WASTE */
+#ifndef GUI_WIDGET_GRID_CHILDREN
+#define GUI_WIDGET_GRID_CHILDREN        32
+#endif /* GUI_WIDGET_GRID_CHILDREN */
+#ifndef GUI_USE_FIXED_GEOMETRY
+#define GUI_USE_FIXED_GEOMETRY          0
+#endif /* GUI_USE_FIXED_GEOMETRY */
+#ifndef GUI_MEM_TLSF
+#define GUI_MEM_TLSF                    0
+#endif /* GUI_MEM_TLSF */
+#ifndef GUI_USE_STATS
+#define GUI_USE_STATS                   0
+#endif /* GUI_USE_STATS */
+#ifndef GUI_SCRATCH_POOL_SIZE
+#define GUI_SCRATCH_POOL_SIZE           0
+#endif /* GUI_SCRATCH_POOL_SIZE */
+#ifndef GUI_GLYPH_CACHE_SIZE
+#define GUI_GLYPH_CACHE_SIZE            0x4000
+#endif /* GUI_GLYPH_CACHE_SIZE */
+#ifndef GUI_TEXTLAYOUT_CACHE_SIZE
+#define GUI_TEXTLAYOUT_CACHE_SIZE       0x1000
+#endif /* GUI_TEXTLAYOUT_CACHE_SIZE */
+#ifndef GUI_CIRCLE_CACHE_SIZE
+#define GUI_CIRCLE_CACHE_SIZE           8
+#endif /* GUI_CIRCLE_CACHE_SIZE */
+#ifndef GUI_LL_BATCH_SIZE
+#define GUI_LL_BATCH_SIZE               16
+#endif /* GUI_LL_BATCH_SIZE */
+#ifndef GUI_OCCLUSION_RECTS
+#define GUI_OCCLUSION_RECTS             4
+#endif /* GUI_OCCLUSION_RECTS */
+#ifndef GUI_WIDGET_MAX_DEPTH
+#define GUI_WIDGET_MAX_DEPTH            8
+#endif /* GUI_WIDGET_MAX_DEPTH */
+
 /**
  * \addtogroup      GUI
  * \{
@@ -74,8 +115,10 @@ extern "C" {
 #define GUI_FLAG_TOUCH_MOVE             ((uint32_t)0x00008000)  /*!< Indicates widget callback has processed touch move event. This parameter works in conjunction with \ref GUI_FLAG_ACTIVE flag */
 #define GUI_FLAG_XPOS_PERCENT           ((uint32_t)0x00010000)  /*!< Indicates widget X position is in percent relative to parent width */
 #define GUI_FLAG_YPOS_PERCENT           ((uint32_t)0x00020000)  /*!< Indicates widget Y position is in percent relative to parent height */
+#define GUI_FLAG_CACHE                  ((uint32_t)0x00040000)  /*!< Indicates content of transparent widget is kept in scratch layer between redraws */
 
 #define GUI_FLAG_LCD_WAIT_LAYER_CONFIRM ((uint32_t)0x00000001)  /*!< Indicates waiting for layer change confirmation */
+#define GUI_FLAG_LCD_LAYER_DRAWN        ((uint32_t)0x00000002)  /*!< Indicates drawing layer has new content which is not set as active layer yet */
 
 
 /**
@@ -87,6 +130,7 @@ extern "C" {
 #define GUI_FLAG_WIDGET_ALLOW_CHILDREN      ((uint32_t)0x00100000)  /*!< Widget allows children widgets */
 #define GUI_FLAG_WIDGET_DIALOG_BASE         ((uint32_t)0x00200000)  /*!< Widget is dialog base. When it is active, no other widget around dialog can be pressed */
 #define GUI_FLAG_WIDGET_INVALIDATE_PARENT   ((uint32_t)0x00400000)  /*!< Anytime widget is invalidated, parent should be invalidated too */
+#define GUI_FLAG_WIDGET_OPAQUE              ((uint32_t)0x00800000)  /*!< Widget draws every pixel of its area and hides widgets below it */
 
 /**
  * \}
@@ -177,6 +221,11 @@ typedef uint32_t    GUI_ID_t;               /*!< GUI object ID */
 typedef uint32_t    GUI_Color_t;            /*!< Color definition */
 typedef int16_t     GUI_Dim_t;              /*!< GUI dimensions in units of pixels */
 typedef int16_t     GUI_iDim_t;             /*!< GUI signed dimensions in units of pixels  */
+#if GUI_USE_FIXED_GEOMETRY || defined(DOXYGEN)
+typedef GUI_iDim_t  GUI_Geom_t;             /*!< Widget position or size in units of pixels or 0.01 percent of parent, see \ref GUI_USE_FIXED_GEOMETRY */
+#else
+typedef float       GUI_Geom_t;             /*!< Widget position or size in units of pixels or percent of parent */
+#endif /* GUI_USE_FIXED_GEOMETRY || defined(DOXYGEN) */
 typedef uint8_t     GUI_Byte;               /*!< GUI byte data type */
 typedef GUI_Byte    GUI_Byte_t;             /*!< GUI byte data type */
 typedef int8_t      GUI_iByte;              /*!< GUI signed byte data type */
@@ -234,12 +283,24 @@ void myFunc(drv_t* drv) {
  */
 #define             GUI_ContainerOf(ptr, type, memb)      (type *)((char *)(ptr) - (char *)offsetof(type, memb))
 
+/**
+ * \brief           Color gradient intermediate stop
+ * \sa              GUI_Gradient_t
+ */
+typedef struct GUI_GradientStop_t {
+    uint8_t Pos;                            /*!< Stop position between start (0) and end (255) of gradient */
+    GUI_Color_t Color;                      /*!< Color at stop position */
+} GUI_GradientStop_t;
+
 /**
  * \brief           Color gradient definition
+ * \note            Gradient with only start and stop colors may be initialized as <b>{start, stop}</b>
  */
 typedef struct GUI_Gradient_t {
     GUI_Color_t Start;                      /*!< Gradient start color */
     GUI_Color_t Stop;                       /*!< Gradient end color */
+    const GUI_GradientStop_t* Stops;        /*!< Optional intermediate stops sorted by position or NULL if not used */
+    size_t StopsCount;                      /*!< Number of entries in stops array */
 } GUI_Gradient_t;
 
 /**
@@ -325,14 +386,23 @@ typedef struct GUI_Display_t {
     GUI_iDim_t Y2;                          /*!< Clipping area end Y */
 } GUI_Display_t;
 
+/**
+ * \brief           List of disjoint rectangles for redraw operation
+ */
+typedef struct GUI_Region_t {
+    GUI_Display_t Rects[GUI_DISPLAY_REGIONS];   /*!< List of rectangles */
+    size_t Count;                           /*!< Number of valid rectangles in list */
+} GUI_Region_t;
+
 /**
  * \brief           LCD layer structure
  */
 typedef struct GUI_Layer_t {
     uint8_t Num;                            /*!< Layer number */
-    uint32_t StartAddress;                  /*!< Start address in memory if it exists */
+    uintptr_t StartAddress;                 /*!< Start address in memory if it exists */
     volatile uint8_t Pending;               /*!< Layer pending for redrawing operation */
-    GUI_Display_t Display;                  /*!< Display setup for clipping regions for main layers (no virtual) */
+    GUI_Region_t Region;                    /*!< Regions redrawn on layer in last drawing process, used for main layers (no virtual) */
+    uint32_t Frame;                         /*!< Number of frame last drawn on layer or 0 when layer has no content, used for main layers (no virtual) */
     
     GUI_iDim_t Width;                       /*!< Layer width, used for virtual layers mainly */
     GUI_iDim_t Height;                      /*!< Layer height, used for virtual layers mainly */
@@ -351,9 +421,20 @@ typedef struct GUI_LCD_t {
     GUI_Layer_t* DrawingLayer;              /*!< Currently active drawing layer */
     size_t LayersCount;                     /*!< Number of layers used for LCD and drawings */
     GUI_Layer_t* Layers;                    /*!< Pointer to layers */
+    uint32_t Frame;                         /*!< Number of last frame set as active layer */
     uint32_t Flags;                         /*!< List of flags */
 } GUI_LCD_t;
 
+/**
+ * \brief           Pixel formats for reading pixels from layer
+ * \sa              GUI_DRAW_ReadRect
+ */
+typedef enum GUI_PixelFormat_t {
+    GUI_PixelFormat_ARGB8888 = 0x00,        /*!< 32-bit pixel, stored as little endian \ref GUI_Color_t value */
+    GUI_PixelFormat_RGB888,                 /*!< 24-bit pixel, stored as blue, green and red byte */
+    GUI_PixelFormat_RGB565,                 /*!< 16-bit pixel, stored as little endian value */
+} GUI_PixelFormat_t;
+
 /**
  * \addtogroup      GUI_IMAGE
  * \{
@@ -394,12 +475,43 @@ typedef enum GUI_LL_Command_t {
     GUI_LL_Command_SetActiveLayer,          /*!< Set new layer as active layer */
 } GUI_LL_Command_t;
 
+/**
+ * \brief           Type of drawing command in batch
+ * \sa              GUI_LL_Cmd_t
+ */
+typedef enum GUI_LL_CmdType_t {
+    GUI_LL_CmdType_Fill = 0x00,             /*!< Fill area with color, same as \ref GUI_LL_t.Fill */
+    GUI_LL_CmdType_Copy,                    /*!< Copy area, same as \ref GUI_LL_t.Copy */
+    GUI_LL_CmdType_CopyBlend,               /*!< Copy area with blending, same as \ref GUI_LL_t.CopyBlend */
+    GUI_LL_CmdType_CopyChar,                /*!< Blend A8 character with color, same as \ref GUI_LL_t.CopyChar */
+    GUI_LL_CmdType_DrawImage,               /*!< Draw image, same as \ref GUI_LL_t.DrawImage16, \ref GUI_LL_t.DrawImage24 or \ref GUI_LL_t.DrawImage32 depending on image BPP */
+} GUI_LL_CmdType_t;
+
+/**
+ * \brief           Single drawing command in batch for \ref GUI_LL_t.DrawBatch function
+ *
+ *                  Members have the same meaning as parameters of function for each command type
+ */
+typedef struct GUI_LL_Cmd_t {
+    GUI_LL_CmdType_t Type;                  /*!< Command type. This parameter can be a value of \ref GUI_LL_CmdType_t enumeration */
+    const void* Src;                        /*!< Source address, not used for fill command */
+    void* Dst;                              /*!< Destination address */
+    GUI_Dim_t XSize;                        /*!< Area width */
+    GUI_Dim_t YSize;                        /*!< Area height */
+    GUI_Dim_t OffLineSrc;                   /*!< Source line offset */
+    GUI_Dim_t OffLineDst;                   /*!< Destination line offset */
+    GUI_Color_t Color;                      /*!< Fill or character color */
+    uint8_t AlphaSrc;                       /*!< Source alpha for copy with blending */
+    uint8_t AlphaDst;                       /*!< Destination alpha for copy with blending */
+    const GUI_IMAGE_DESC_t* Img;            /*!< Image description for image command */
+} GUI_LL_Cmd_t;
+
 /**
  * \brief           GUI Low-Level structure for drawing operations
  */
 typedef struct GUI_LL_t {
     void            (*Init)         (GUI_LCD_t *);                                                                      /*!< Pointer to LCD initialization function */
-    uint8_t         (*IsReady)      (GUI_LCD_t *);                                                                      /*!< Pointer to LCD is ready function */
+    uint8_t         (*IsReady)      (GUI_LCD_t *);                                                                      /*!< Pointer to LCD is ready function. Returns 1 when all queued drawing operations are finished */
     void            (*SetPixel)     (GUI_LCD_t *, GUI_Layer_t *, GUI_Dim_t, GUI_Dim_t, GUI_Color_t);                    /*!< Pointer to LCD set pixel function */
     GUI_Color_t     (*GetPixel)     (GUI_LCD_t *, GUI_Layer_t *, GUI_Dim_t, GUI_Dim_t);                                 /*!< Pointer to read pixel from LCD */
     void            (*Fill)         (GUI_LCD_t *, GUI_Layer_t *, void *, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Color_t); /*!< Pointer to LCD fill screen or rectangle function */
@@ -412,8 +524,65 @@ typedef struct GUI_LL_t {
     void            (*DrawImage24)  (GUI_LCD_t *, GUI_Layer_t *, const GUI_IMAGE_DESC_t *, const void *, void *, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t);   /*!< Pointer to function for drawing 24BPP (RGB888) images */
     void            (*DrawImage32)  (GUI_LCD_t *, GUI_Layer_t *, const GUI_IMAGE_DESC_t *, const void *, void *, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t);   /*!< Pointer to function for drawing 32BPP (ARGB8888) images */
     void            (*CopyChar)     (GUI_LCD_t *, GUI_Layer_t *, const void *, void *, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Color_t);                /*!< Pointer to copy char function with alpha only as source */
+    uint32_t        (*GetTime)      (GUI_LCD_t *);                                                                      /*!< Pointer to function returning free running time in units of microseconds, used for statistics. Set to 0 if not available */
+    void            (*DrawBatch)    (GUI_LCD_t *, GUI_Layer_t *, const GUI_LL_Cmd_t *, size_t);                        /*!< Pointer to function executing array of \ref GUI_LL_Cmd_t commands in order. Commands may be merged or pipelined by driver. Set to 0 if not available */
+    void            (*ReadRect)     (GUI_LCD_t *, GUI_Layer_t *, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, void *, GUI_PixelFormat_t);   /*!< Pointer to function reading rectangle from layer to buffer in \ref GUI_PixelFormat_t format. Must return when data are in buffer. Set to 0 to read frame buffer with CPU */
 } GUI_LL_t;
 
+/**
+ * \brief           List of low-level drawing functions counted in statistics
+ */
+typedef enum GUI_STATS_LL_t {
+    GUI_STATS_LL_SetPixel = 0x00,           /*!< \ref GUI_LL_t.SetPixel function */
+    GUI_STATS_LL_GetPixel,                  /*!< \ref GUI_LL_t.GetPixel function */
+    GUI_STATS_LL_Fill,                      /*!< \ref GUI_LL_t.Fill function */
+    GUI_STATS_LL_Copy,                      /*!< \ref GUI_LL_t.Copy function */
+    GUI_STATS_LL_CopyBlend,                 /*!< \ref GUI_LL_t.CopyBlend function */
+    GUI_STATS_LL_DrawHLine,                 /*!< \ref GUI_LL_t.DrawHLine function */
+    GUI_STATS_LL_DrawVLine,                 /*!< \ref GUI_LL_t.DrawVLine function */
+    GUI_STATS_LL_FillRect,                  /*!< \ref GUI_LL_t.FillRect function */
+    GUI_STATS_LL_DrawImage16,               /*!< \ref GUI_LL_t.DrawImage16 function */
+    GUI_STATS_LL_DrawImage24,               /*!< \ref GUI_LL_t.DrawImage24 function */
+    GUI_STATS_LL_DrawImage32,               /*!< \ref GUI_LL_t.DrawImage32 function */
+    GUI_STATS_LL_CopyChar,                  /*!< \ref GUI_LL_t.CopyChar function */
+    GUI_STATS_LL_DrawBatch,                 /*!< \ref GUI_LL_t.DrawBatch function */
+    GUI_STATS_LL_ReadRect,                  /*!< \ref GUI_LL_t.ReadRect function */
+    GUI_STATS_LL_Count,                     /*!< Number of counted functions */
+} GUI_STATS_LL_t;
+
+/**
+ * \brief           Render statistics of single frame
+ *
+ *                  Values are collected from all \ref GUI_Process calls
+ *                  since previous frame until current frame has been drawn
+ */
+typedef struct GUI_STATS_t {
+    uint32_t Frame;                         /*!< Number of frame since GUI start */
+
+    uint32_t WidgetsVisited;                /*!< Number of widgets checked during redraw */
+    uint32_t WidgetsDrawn;                  /*!< Number of widgets which were drawn */
+    uint32_t WidgetsSkipped;                /*!< Number of widgets which were not drawn because hidden, outside region, without redraw flag or cached */
+    uint32_t WidgetsOccluded;               /*!< Number of widgets which were not drawn because opaque widgets above cover them */
+
+    uint32_t PixelsFilled;                  /*!< Number of pixels set with single color */
+    uint32_t PixelsCopied;                  /*!< Number of pixels copied from layer or image without blending */
+    uint32_t PixelsBlended;                 /*!< Number of pixels blended with destination */
+    uint32_t LLCalls[GUI_STATS_LL_Count];   /*!< Number of low-level function calls for each member of \ref GUI_STATS_LL_t */
+    uint32_t BatchedCommands;               /*!< Number of commands executed with \ref GUI_LL_t.DrawBatch */
+    uint32_t Glyphs;                        /*!< Number of characters drawn */
+    uint32_t GlyphCacheHits;                /*!< Number of characters found in glyph cache */
+    uint32_t GlyphCacheMisses;              /*!< Number of characters converted and added to glyph cache */
+    uint32_t TextLayoutHits;                /*!< Number of texts drawn with cached layout */
+    uint32_t TextLayoutMisses;              /*!< Number of texts measured and wrapped to lines */
+    uint32_t DirtyArea;                     /*!< Number of pixels in invalidated region */
+    uint32_t CopyBackArea;                  /*!< Number of pixels copied from active layer to bring drawing layer up to date */
+
+    uint32_t TimeInput;                     /*!< Time spent in touch and keyboard processing in units of microseconds */
+    uint32_t TimeTimers;                    /*!< Time spent in software timers and widget removal in units of microseconds */
+    uint32_t TimeRedraw;                    /*!< Time spent to copy damage of newer layers and draw widgets in units of microseconds */
+    uint32_t TimeSwap;                      /*!< Time spent waiting for low-level drawing to finish and setting new active layer in units of microseconds */
+} GUI_STATS_t;
+
 /**
  * \defgroup        GUI_FONT Fonts
  * \brief           Font description structures and flags
@@ -432,8 +601,34 @@ typedef struct GUI_FONT_CharInfo_t {
     GUI_Const GUI_Byte* Data;               /*!< Pointer to actual data for font */
 } GUI_FONT_CharInfo_t;
 
+/**
+ * \brief           Range of consecutive characters in sparse font
+ */
+typedef struct GUI_FONT_Range_t {
+    uint32_t StartChar;                     /*!< First character code in range */
+    uint32_t EndChar;                       /*!< Last character code in range */
+    GUI_Const GUI_FONT_CharInfo_t* Data;    /*!< Pointer to character information of first character in range */
+} GUI_FONT_Range_t;
+
+/**
+ * \brief           Kerning pair of characters
+ */
+typedef struct GUI_FONT_KernPair_t {
+    uint32_t Left;                          /*!< Character code of left character */
+    uint32_t Right;                         /*!< Character code of right character */
+    int8_t Value;                           /*!< Correction of advance of left character in units of pixels */
+} GUI_FONT_KernPair_t;
+
 /**
  * \brief           FONT structure for writing usage
+ *
+ *                  Dense font has information for every character between StartChar and EndChar in Data array.
+ *                  Sparse font sets Ranges to array of ranges sorted by character code instead,
+ *                  characters are then found with binary search and StartChar, EndChar and Data are not used.
+ *
+ *                  Optional Advances array of dense font has advance width (xSize + xMargin) for every character in Data,
+ *                  so strings are measured without reading character information.
+ *                  Optional Kerning array is sorted by left and then right character code.
  */
 typedef struct {
     GUI_Const GUI_Char* Name;               /*!< Pointer to font name */
@@ -442,6 +637,11 @@ typedef struct {
     uint16_t EndChar;                       /*!< End character number in list */
     uint8_t Flags;                          /*!< List of flags for font */
     GUI_Const GUI_FONT_CharInfo_t* Data;    /*!< Pointer to first character */
+    GUI_Const GUI_FONT_Range_t* Ranges;     /*!< Pointer to sorted array of character ranges for sparse font. Set to 0 for dense font */
+    uint16_t RangesCount;                   /*!< Number of ranges in Ranges array */
+    GUI_Const GUI_Byte* Advances;           /*!< Pointer to advance width of each character in Data array. Set to 0 if not available */
+    GUI_Const GUI_FONT_KernPair_t* Kerning; /*!< Pointer to sorted array of kerning pairs. Set to 0 if not available */
+    uint16_t KerningCount;                  /*!< Number of pairs in Kerning array */
 } GUI_FONT_t;
 
 #define GUI_FLAG_FONT_AA                ((uint8_t)0x01) /*!< Indicates anti-alliasing on font */
@@ -454,10 +654,48 @@ typedef struct {
  * \brief           Char temporary entry stored in RAM for faster copy with blending operations
  */
 typedef struct GUI_FONT_CharEntry_t {
-    GUI_LinkedList_t List;                  /*!< Linked list entry. Must always be first on the list */
-    const GUI_FONT_CharInfo_t* Ch;          /*!< Character value */
+    struct GUI_FONT_CharEntry_t* Next;      /*!< Next entry in the same hash table bucket */
+    struct GUI_FONT_CharEntry_t* Newer;     /*!< Entry used after this one */
+    struct GUI_FONT_CharEntry_t* Older;     /*!< Entry used before this one */
     const GUI_FONT_t* Font;                 /*!< Pointer to font structure */
+    uint32_t Ch;                            /*!< Character code */
+    size_t Size;                            /*!< Number of bytes allocated for entry and alpha values following it */
 } GUI_FONT_CharEntry_t;
+
+/**
+ * \brief           Single line of text layout
+ */
+typedef struct GUI_TEXTLAYOUT_Line_t {
+    size_t Offset;                          /*!< Offset of first byte of line from start of string */
+    size_t Count;                           /*!< Number of characters to read in line */
+    size_t Draw;                            /*!< Number of characters to draw from the beginning of line */
+    GUI_iDim_t Width;                       /*!< Line width in units of pixels */
+} GUI_TEXTLAYOUT_Line_t;
+
+/**
+ * \brief           Text layout stored in RAM to skip measurement and line wrapping on redraw
+ *
+ *                  Array of \ref GUI_TEXTLAYOUT_Line_t lines follows the structure in memory
+ */
+typedef struct GUI_TEXTLAYOUT_t {
+    struct GUI_TEXTLAYOUT_t* Next;          /*!< Next entry in the same hash table bucket */
+    struct GUI_TEXTLAYOUT_t* Newer;         /*!< Entry used after this one */
+    struct GUI_TEXTLAYOUT_t* Older;         /*!< Entry used before this one */
+    size_t Size;                            /*!< Number of bytes allocated for entry and lines following it */
+    
+    const GUI_Char* Str;                    /*!< Pointer to string */
+    size_t Length;                          /*!< String length in units of bytes */
+    uint32_t Hash;                          /*!< Hash of string content */
+    const GUI_FONT_t* Font;                 /*!< Pointer to font structure */
+    GUI_iDim_t Width;                       /*!< Width of drawing rectangle */
+    GUI_Dim_t LineHeight;                   /*!< Line height */
+    uint8_t Flags;                          /*!< Font flags used for drawing */
+    
+    GUI_iDim_t TextHeight;                  /*!< Height of all lines of text */
+    GUI_iDim_t ShiftX;                      /*!< Shift of X position when text is aligned right */
+    size_t Start;                           /*!< Offset of first drawn byte when text is aligned right */
+    size_t LinesCount;                      /*!< Number of lines following structure */
+} GUI_TEXTLAYOUT_t;
 #endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
 
 #if !defined(DOXYGEN)
@@ -1017,8 +1255,61 @@ typedef struct GUI_WIDGET_t {
     uint8_t ColorsCount;                    /*!< Number of colors used in widget */
 } GUI_WIDGET_t;
 
+/**
+ * \brief           Entry of widget ID hash map
+ */
+typedef struct GUI_IdMapEntry_t {
+    GUI_HANDLE_p Handle;                    /*!< Widget with this ID, NULL when unknown after duplicate was removed */
+    GUI_ID_t Id;                            /*!< Widget ID */
+    uint16_t Count;                         /*!< Number of widgets with this ID, entry is empty when 0 */
+} GUI_IdMapEntry_t;
+
+/**
+ * \brief           Hash map of widget IDs with open addressing
+ */
+typedef struct GUI_IdMap_t {
+    uint8_t Valid;                          /*!< Set to 1 when map includes all widgets in tree */
+    GUI_IdMapEntry_t* Entries;              /*!< List of entries */
+    size_t Size;                            /*!< Number of entries, always power of 2 */
+    size_t Used;                            /*!< Number of used entries */
+} GUI_IdMap_t;
+
 #if defined(GUI_INTERNAL) || defined(DOXYGEN)
 
+/**
+ * \brief           Cached absolute widget geometry on LCD
+ */
+typedef struct GUI_Geometry_t {
+    uint8_t Valid;                          /*!< Set to 1 when values match widget setup, cleared on change of widget itself */
+    uint32_t Gen;                           /*!< Generation of values, increased every time values are calculated again */
+    uint32_t ParentGen;                     /*!< Generation of parent values used for calculation, values are not valid when parent values changed */
+    GUI_iDim_t X;                           /*!< Absolute X position on LCD in units of pixels */
+    GUI_iDim_t Y;                           /*!< Absolute Y position on LCD in units of pixels */
+    GUI_Dim_t Width;                        /*!< Width in units of pixels */
+    GUI_Dim_t Height;                       /*!< Height in units of pixels */
+    GUI_Display_t Visible;                  /*!< Visible part of widget on LCD after clipping with all parents */
+} GUI_Geometry_t;
+
+/**
+ * \brief           Scratch layer for drawing of transparent widgets, reused from pool between redraws
+ */
+typedef struct GUI_Scratch_t {
+    GUI_Layer_t Layer;                      /*!< Virtual layer, must be first for casting. Pixel data follow the structure */
+    struct GUI_Scratch_t* Next;             /*!< Next scratch layer in pool */
+    size_t Size;                            /*!< Size of pixel data in units of bytes */
+    uint8_t PixelSize;                      /*!< Number of bytes per pixel */
+    uint8_t Pooled;                         /*!< Set to 1 when layer is kept in pool after release */
+    uint8_t InUse;                          /*!< Set to 1 when layer is currently used for drawing */
+    uint8_t Pending;                        /*!< Set to 1 when low-level may still read data after release */
+    uint8_t Valid;                          /*!< Set to 1 when cached content of owner widget is valid, cleared when widget or any of its children is invalidated */
+    GUI_iDim_t X;                           /*!< Absolute X position of owner widget when content has been cached */
+    GUI_iDim_t Y;                           /*!< Absolute Y position of owner widget when content has been cached */
+    GUI_Dim_t Width;                        /*!< Width of owner widget when content has been cached */
+    GUI_Dim_t Height;                       /*!< Height of owner widget when content has been cached */
+    uint32_t Used;                          /*!< Use stamp for least recently used eviction */
+    GUI_HANDLE_p Owner;                     /*!< Widget with cached content in layer or 0 when not used as cache */
+} GUI_Scratch_t;
+
 /**
  * \brief           Common GUI values for widgets
  */
@@ -1029,12 +1320,15 @@ typedef struct GUI_HANDLE {
     const GUI_WIDGET_t* Widget;             /*!< Widget parameters with callback functions */
     GUI_WIDGET_CALLBACK_t Callback;         /*!< Callback function prototype */
     struct GUI_HANDLE* Parent;              /*!< Pointer to parent widget */
-    float X;                                /*!< Object X position relative to parent window in units of pixels */
-    float Y;                                /*!< Object Y position relative to parent window in units of pixels */
-    float Width;                            /*!< Object width in units of pixels or percentages */
-    float Height;                           /*!< Object height in units of pixels or percentages */
+    GUI_Geom_t X;                           /*!< Object X position relative to parent window in units of pixels or percentages */
+    GUI_Geom_t Y;                           /*!< Object Y position relative to parent window in units of pixels or percentages */
+    GUI_Geom_t Width;                       /*!< Object width in units of pixels or percentages */
+    GUI_Geom_t Height;                      /*!< Object height in units of pixels or percentages */
     uint32_t Padding;                       /*!< 4-bytes long padding, each byte of one side, MSB = top padding, LSB = left padding.
                                                     Used for children widgets if virtual padding should be used */
+    GUI_Geometry_t Geometry;                /*!< Cached absolute position, size and visible area */
+    size_t Index;                           /*!< Position of widget in spatial index of parent, valid only when index is valid */
+    GUI_Scratch_t* Cache;                   /*!< Scratch layer with cached content of transparent widget, used with \ref GUI_FLAG_CACHE */
     int32_t ZIndex;                         /*!< Z-Index value of widget, which can be set by user. All widgets with same z-index are changeable when active on visible area */
     uint8_t Transparency;                   /*!< Transparency of widget relative to parent widget */
     uint32_t Flags;                         /*!< All possible flags for specific widget */
@@ -1047,6 +1341,35 @@ typedef struct GUI_HANDLE {
     void* UserData;                         /*!< Pointer to optional user data */
 } GUI_HANDLE;
 
+/**
+ * \brief           Spatial index of children widgets, uniform grid of their visible rectangles
+ */
+typedef struct GUI_Grid_t {
+    uint8_t Valid;                          /*!< Set to 1 when index matches linked list of children */
+    uint32_t ParentGen;                     /*!< Geometry generation of parent widget when index was built */
+    size_t Count;                           /*!< Number of indexed widgets, including removed widgets */
+    size_t Size;                            /*!< Number of widgets memory is allocated for */
+    GUI_HANDLE_p* Items;                    /*!< Indexed widgets in linked list order, NULL for removed widget */
+    size_t* Found;                          /*!< Result list of last search */
+    size_t* Dirty;                          /*!< Indexes of widgets whose rectangle must be updated */
+    size_t DirtyCount;                      /*!< Number of entries in dirty list */
+    uint32_t* Marks;                        /*!< Search pass when widget was found last time */
+    GUI_Display_t* Rects;                   /*!< Visible rectangle of each widget */
+    uint32_t Pass;                          /*!< Current search pass */
+    
+    GUI_iDim_t X;                           /*!< Left position of grid on LCD */
+    GUI_iDim_t Y;                           /*!< Top position of grid on LCD */
+    GUI_iDim_t CellWidth;                   /*!< Width of one cell in units of pixels */
+    GUI_iDim_t CellHeight;                  /*!< Height of one cell in units of pixels */
+    size_t Cols;                            /*!< Number of columns */
+    size_t Rows;                            /*!< Number of rows */
+    size_t* Cells;                          /*!< Index of first reference for each cell, cell may use references up to start of next cell */
+    size_t* Used;                           /*!< Number of used references in each cell */
+    size_t CellsSize;                       /*!< Number of entries memory for cells is allocated for */
+    size_t* Refs;                           /*!< Widget indexes, grouped by cells and sorted in each cell */
+    size_t RefsSize;                        /*!< Number of references memory is allocated for */
+} GUI_Grid_t;
+
 /**
  * \brief           Common GUI values for widgets who can have children widgets (windows, panels)
  */
@@ -1056,6 +1379,7 @@ typedef struct GUI_HANDLE_ROOT {
     GUI_LinkedListRoot_t RootList;          /*!< Linked list root of children widgets */
     GUI_iDim_t ScrollX;                     /*!< Scroll of widgets in horizontal direction in units of pixels */
     GUI_iDim_t ScrollY;                     /*!< Scroll of widgets in vertical direction in units of pixels */
+    GUI_Grid_t* Grid;                       /*!< Spatial index of children widgets, created only for many children */
 } GUI_HANDLE_ROOT_t;
 #endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
 
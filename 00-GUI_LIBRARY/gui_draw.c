@@ -44,6 +44,26 @@ typedef struct GUI_StringRect_t {
     const GUI_FONT_t* Font;                         /*!< Pointer to used font */
 } GUI_StringRect_t;
 
+typedef struct GUI_PolyEdge_t {
+    GUI_iDim_t YStart;                              /*!< First scanline crossed by edge */
+    GUI_iDim_t YEnd;                                /*!< First scanline below edge */
+    GUI_iDim_t X0, Y0;                              /*!< Upper edge point */
+    int32_t DX, DY;                                 /*!< Edge deltas, DY is always positive */
+    int32_t X;                                      /*!< Integer part of first pixel on current scanline */
+    int32_t Rem;                                    /*!< Remainder of first pixel, in range [0, 2 * DY) */
+    int32_t StepX;                                  /*!< Integer part of X step per scanline */
+    int32_t StepRem;                                /*!< Remainder part of X step per scanline */
+    int8_t Dir;                                     /*!< Edge direction for non-zero rule, 1 when going down */
+} GUI_PolyEdge_t;
+
+#if GUI_CIRCLE_CACHE_SIZE
+typedef struct GUI_CircleSpans_t {
+    GUI_iDim_t R;                                   /*!< Circle radius, 0 when entry is not used */
+    uint32_t Used;                                  /*!< Time of last use for replacement */
+    GUI_iDim_t* Spans;                              /*!< Width of corner on each row from circle center, R + 1 entries */
+} GUI_CircleSpans_t;
+#endif /* GUI_CIRCLE_CACHE_SIZE */
+
 typedef struct GUI_StringRectVars_t {
     GUI_STRING_t s;                                 /*!< Pointer to input string */
     uint32_t ch, lastCh;                            /*!< Current and previous characters */
@@ -73,43 +93,99 @@ typedef struct GUI_StringRectVars_t {
 #define CH_WS           GUI_KEY_WS
 #define __GetCharFromValue(ch)      (uint32_t)((CH_CR == (ch) || CH_LF == (ch)) ? CH_WS : (ch))
 
+#define POLY_EDGES_STATIC   8                       /* Number of polygon edges processed without memory allocation */
+
 /******************************************************************************/
 /******************************************************************************/
 /***                            Private variables                            **/
 /******************************************************************************/
 /******************************************************************************/
 static GUI_StringRectVars_t var;
+#if GUI_CIRCLE_CACHE_SIZE
+static GUI_CircleSpans_t CircleSpans[GUI_CIRCLE_CACHE_SIZE];
+static uint32_t CircleSpansTime;
+#endif /* GUI_CIRCLE_CACHE_SIZE */
 
 /******************************************************************************/
 /******************************************************************************/
 /***                            Private functions                            **/
 /******************************************************************************/
 /******************************************************************************/
+/* Find character information in font */
+static
+const GUI_FONT_CharInfo_t* __FontGetChar(const GUI_FONT_t* font, uint32_t ch) {
+    if (font->Ranges) {                             /* Sparse font with ranges */
+        size_t low = 0, high = font->RangesCount, mid;
+        
+        while (low < high) {                        /* Binary search for range with character */
+            mid = (low + high) >> 1;
+            if (ch < font->Ranges[mid].StartChar) {
+                high = mid;
+            } else if (ch > font->Ranges[mid].EndChar) {
+                low = mid + 1;
+            } else {
+                return &font->Ranges[mid].Data[ch - font->Ranges[mid].StartChar];
+            }
+        }
+    } else if (ch >= font->StartChar && ch <= font->EndChar) {  /* Character is in font structure */
+        return &font->Data[ch - font->StartChar];   /* Return character pointer from font */
+    }
+    return 0;                                       /* No character in font */
+}
+
 /* Get character from font object array */
 static
 const GUI_FONT_CharInfo_t* __StringGetCharPtr(const GUI_FONT_t* font, uint32_t ch) {
+    const GUI_FONT_CharInfo_t* c;
+    
     ch = __GetCharFromValue(ch);                    /* Get char from char value */
-    if (ch >= font->StartChar && ch <= font->EndChar) { /* Character is in font structure */
-        return &font->Data[(ch) - font->StartChar]; /* Return character pointer from font */
-    } else if ('?' >= font->StartChar && '?' <= font->EndChar) {    /* Try to return ? character */
-        return &font->Data[(uint32_t)'?' - font->StartChar];    /* Get pointer of ? character */
+    c = __FontGetChar(font, ch);                    /* Get character pointer from font */
+    if (!c) {
+        c = __FontGetChar(font, '?');               /* Try to return ? character */
     }
-    return 0;                                       /* No character in font */
+    return c;
 }
 
-/* Get dimensions for input character */
+/* Get advance width of character, this is horizontal distance to next character */
 static
-void __StringGetCharSize(const GUI_FONT_t* font, uint32_t ch, GUI_iDim_t* width, GUI_iDim_t* height) {
-    const GUI_FONT_CharInfo_t* c = 0;
+GUI_iDim_t __StringGetCharAdvance(const GUI_FONT_t* font, uint32_t ch) {
+    const GUI_FONT_CharInfo_t* c;
     
+    ch = __GetCharFromValue(ch);                    /* Get char from char value */
+    if (font->Advances && !font->Ranges && ch >= font->StartChar && ch <= font->EndChar) {
+        return font->Advances[ch - font->StartChar];/* Get width from packed table */
+    }
     c = __StringGetCharPtr(font, ch);               /* Get character from font */
-    if (c) {
-        *width = c->xSize + c->xMargin;
-        *height = c->ySize;
-    } else {
-        *width = 0;
-        *height = 0;
+    return c ? (c->xSize + c->xMargin) : 0;
+}
+
+/* Get kerning correction between 2 characters, white spaces are never kerned */
+static
+GUI_iDim_t __StringGetKerning(const GUI_FONT_t* font, uint32_t left, uint32_t right) {
+    size_t low = 0, high, mid;
+    const GUI_FONT_KernPair_t* k;
+    
+    if (!font->Kerning || !left) {
+        return 0;
+    }
+    left = __GetCharFromValue(left);
+    right = __GetCharFromValue(right);
+    if (left == CH_WS || right == CH_WS) {
+        return 0;
+    }
+    high = font->KerningCount;
+    while (low < high) {                            /* Binary search for pair */
+        mid = (low + high) >> 1;
+        k = &font->Kerning[mid];
+        if (left < k->Left || (left == k->Left && right < k->Right)) {
+            high = mid;
+        } else if (left > k->Left || right > k->Right) {
+            low = mid + 1;
+        } else {
+            return k->Value;
+        }
     }
+    return 0;
 }
 
 /* Get string rectangle width and height */
@@ -186,7 +262,7 @@ void __ProcessStringRectangleBeforeReturn(GUI_StringRectVars_t* var, GUI_StringR
 
 static
 size_t __StringRectangle(GUI_StringRect_t* rect, GUI_STRING_t* str, uint8_t onlyToNextLine) {
-    GUI_iDim_t w, h, mW = 0, tH = 0;                /* Maximal width and total height */
+    GUI_iDim_t w, mW = 0, tH = 0;                   /* Maximal width and total height */
     uint8_t i;
     const GUI_Char* lastS;
     GUI_STRING_t tmpStr;
@@ -249,7 +325,7 @@ size_t __StringRectangle(GUI_StringRect_t* rect, GUI_STRING_t* str, uint8_t only
                     var.SpaceCount++;               /* Increase number of spaces on last element */
                 } else {                            /* Try to get character size */
                     /* Try to fit character in current line */
-                    __StringGetCharSize(rect->Font, var.ch, &w, &h);    /* Get character dimensions */
+                    w = __StringGetCharAdvance(rect->Font, var.ch) + __StringGetKerning(rect->Font, var.lastCh, var.ch);    /* Get character width */
                     if ((var.cW + w) < rect->StringDraw->Width) {   /* Do we have enough memory available */
                         var.cW += w;                /* Increase total line width */
                         if (CH_WS == var.ch) {      /* Check if character is white space */
@@ -299,7 +375,7 @@ size_t __StringRectangle(GUI_StringRect_t* rect, GUI_STRING_t* str, uint8_t only
     else {
         var.cW = 0;
         while (GUI_STRING_GetCh(&var.s, &var.ch, &i)) { /* Get next character from string */
-            __StringGetCharSize(rect->Font, var.ch, &w, &h);/* Get character width and height */
+            w = __StringGetCharAdvance(rect->Font, var.ch) + __StringGetKerning(rect->Font, var.lastCh, var.ch);    /* Get character width */
             if (!(rect->StringDraw->Flags & GUI_FLAG_FONT_RIGHTALIGN) && (var.cW + w) > rect->StringDraw->Width) {  /* Check if end now */
                 break;
             }
@@ -307,6 +383,7 @@ size_t __StringRectangle(GUI_StringRect_t* rect, GUI_STRING_t* str, uint8_t only
                 var.cW += w;                        /* Increase width */
             }
             var.cnt++;                              /* Increase number of characters to read */
+            var.lastCh = var.ch;                    /* Save character for kerning */
         }
         rect->ReadTotal = rect->ReadDraw = var.cnt; /* Set values for drawing and reading */
         rect->Width = var.cW;                       /* Save width value */
@@ -316,111 +393,15 @@ size_t __StringRectangle(GUI_StringRect_t* rect, GUI_STRING_t* str, uint8_t only
     return var.cnt;                                 /* Return number of characters to read in current line */
 }
 
-/* Get font char object from memory with alpha values */
-static
-GUI_FONT_CharEntry_t* __GetCharEntryFromFont(const GUI_FONT_t* font, const GUI_FONT_CharInfo_t* c) {
-    GUI_FONT_CharEntry_t* entry;
-    for (entry = (GUI_FONT_CharEntry_t *)__GUI_LINKEDLIST_GETNEXT_GEN(&GUI.RootFonts, 0); entry;
-        entry = (GUI_FONT_CharEntry_t *)__GUI_LINKEDLIST_GETNEXT_GEN(0, (GUI_LinkedList_t *)entry)) {
-        if (entry->Font == font && entry->Ch == c) {
-            return entry;
-        }
-    }
-    return 0;
-}
-
-/* Create char and put it to RAM for fast drawing with memory to memory copy */
-static
-GUI_FONT_CharEntry_t* __CreateCharEntryFromFont(const GUI_FONT_t* font, const GUI_FONT_CharInfo_t* c) {
-    GUI_FONT_CharEntry_t* entry = NULL;
-    uint16_t columns;
-    uint16_t memsize = sizeof(*entry);              /* Get size of entry */
-    uint16_t memDataSize;
-    
-    /* Calculate memory size for data */
-    memDataSize = c->xSize * c->ySize;
-    
-    memsize += memDataSize;
-    entry = __GUI_MEMALLOC(memsize);                /* Allocate memory for entry */
-    if (entry) {                                    /* Allocation was successful */
-        uint16_t i, x;
-        uint8_t b, k, t;
-        uint8_t* ptr = (uint8_t *)entry;            /* Go to memory size */
-        ptr += sizeof(*entry);                      /* Go to start of data */
-        
-        entry->Ch = c;                              /* Set pointer to character */
-        entry->Font = font;                         /* Set pointer to font structure */
-        
-        if (font->Flags & GUI_FLAG_FONT_AA) {       /* Anti-alliased font */
-            columns = c->xSize >> 2;                /* Calculate number of bytes used for single character line */
-            if (c->xSize % 4) {                     /* If only 1 column used */
-                columns++;
-            }
-            x = 0;
-            for (i = 0; i < c->ySize * columns; i++) {  /* Inspect all vertical lines */
-                b = c->Data[i];                     /* Get byte of data */
-                for (k = 0; k < 4; k++) {           /* Scan each bit in byte */
-                    t = (b >> (6 - 2 * k)) & 0x03;  /* Get temporary bits on bottom */
-                    switch (t) {
-                        case 0:
-                            *ptr |= 0x00;
-                            break;
-                        case 1:
-                            *ptr |= 0x55;
-                            break;
-                        case 2:
-                            *ptr |= 0xAA;
-                            break;
-                        default:
-                            *ptr |= 0xFF;
-                    }
-                    ptr++;
-                    x++;
-                    if (x == c->xSize) {
-                        x = 0;
-                        break;
-                    }
-                }
-            }
-        } else {
-            columns = c->xSize >> 3;                /* Calculate number of bytes used for single character line */
-            if (c->xSize % 8) {                     /* If only 1 column used */
-                columns++;
-            }
-            x = 0;
-            for (i = 0; i < c->ySize * columns; i++) {  /* Inspect all vertical lines */
-                b = c->Data[i];                     /* Get byte of data */
-                for (k = 0; k < 8; k++) {           /* Scan each bit in byte */
-                    if ((b >> (7 - k)) & 0x01) {
-                        *ptr++ = 0xFF;
-                    } else {
-                        *ptr++ = 0x00;
-                    }
-                    x++;
-                    if (x == c->xSize) {
-                        x = 0;
-                        break;
-                    }
-                }
-            }
-        }
-        
-        __GUI_LINKEDLIST_ADD_GEN(&GUI.RootFonts, (GUI_LinkedList_t *)entry);    /* Add entry to linked list */
-    }
-    return entry;                                   /* Return new created entry */
-}
-
 /* Draw character to screen */
 /* X and Y coordinates are TOP LEFT coordinates for character */
 static
-void __DRAW_Char(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_DRAW_FONT_t* draw, GUI_iDim_t x, GUI_iDim_t y, const GUI_FONT_CharInfo_t* c) {
+void __DRAW_Char(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_DRAW_FONT_t* draw, GUI_iDim_t x, GUI_iDim_t y, uint32_t ch, const GUI_FONT_CharInfo_t* c) {
     GUI_Byte i, b;
     GUI_iDim_t x1;
     GUI_iByte k;
     GUI_Byte columns;
     
-    while (!GUI.LL.IsReady(&GUI.LCD));              /* Wait till ready */
-    
     y += c->yPos;                                   /* Set Y position */
     
     if (!__GUI_RECT_MATCH(
@@ -429,23 +410,19 @@ void __DRAW_Char(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_DR
     )) {
         return;
     }
+    __GUI_STATS_INC(Glyphs);
     
     if (GUI.LL.CopyChar) {                          /* If copying character function exists in low-level part */
-        GUI_FONT_CharEntry_t* entry = NULL;
+        const uint8_t* ptr;
         
-        entry = __GetCharEntryFromFont(font, c);    /* Get char entry from font and character for fast alpha drawing operations */
-        if (!entry) {
-            entry = __CreateCharEntryFromFont(font, c); /* Create new entry */
-        }
-        if (entry) {                                /* We have valid data */
+        ptr = __GUI_GLYPH_Get(font, ch, c);         /* Get alpha values of character for fast drawing operations */
+        if (ptr) {                                  /* We have valid data */
             GUI_Dim_t width, height, offlineSrc, offlineDst;
             uint8_t* dst = 0;
-            uint8_t* ptr = (uint8_t *)entry;        /* Get pointer */
             GUI_Dim_t tmpX;
             
             tmpX = x;                               /* Start X */
             
-            ptr += sizeof(*entry);                  /* Go to start of data array */
             dst = (uint8_t *)(GUI.LCD.DrawingLayer->StartAddress + ((y - GUI.LCD.DrawingLayer->OffsetY) * GUI.LCD.DrawingLayer->Width + (x - GUI.LCD.DrawingLayer->OffsetX)) * GUI.LCD.PixelSize);
             
             width = c->xSize;                       /* Get X size */
@@ -479,23 +456,24 @@ void __DRAW_Char(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_DR
                 GUI_Dim_t firstWidth = (draw->X + draw->Color1Width) - tmpX;
                 
                 /* First part draw */
-                GUI.LL.CopyChar(&GUI.LCD, GUI.LCD.DrawingLayer, ptr, dst, 
+                __GUI_BATCH_CopyChar(ptr, dst, 
                     firstWidth, height,
                     offlineSrc + width - firstWidth, offlineDst + width - firstWidth, draw->Color1);
                 
                 /* Second part draw */
-                GUI.LL.CopyChar(&GUI.LCD, GUI.LCD.DrawingLayer, ptr + firstWidth, dst + firstWidth * GUI.LCD.PixelSize, 
+                __GUI_BATCH_CopyChar(ptr + firstWidth, dst + firstWidth * GUI.LCD.PixelSize, 
                     width - firstWidth, height,
                     offlineSrc + firstWidth, offlineDst + firstWidth, draw->Color2);
             } else {
                 /* Draw entire character with single color */
-                GUI.LL.CopyChar(&GUI.LCD, GUI.LCD.DrawingLayer, ptr, dst, 
+                __GUI_BATCH_CopyChar(ptr, dst, 
                     width, height,
                     offlineSrc, offlineDst, (draw->X + draw->Color1Width) > x ? draw->Color1 : draw->Color2);
             }
             return;
         }
     }
+    __GUI_BATCH_Flush();                            /* Pixels are drawn directly, batched characters must be drawn first */
     
     if (font->Flags & GUI_FLAG_FONT_AA) {           /* Font has anti alliasing enabled */
         GUI_Color_t color;                          /* Temporary color for AA */
@@ -573,9 +551,9 @@ void __DRAW_Char(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_DR
 /* Get string pointer start address for specific width of rectangle */
 static
 const GUI_Char* __StringGetPointerForWidth(const GUI_FONT_t* font, GUI_STRING_t* str, GUI_DRAW_FONT_t* draw) {
-    GUI_iDim_t tot = 0, w, h;
+    GUI_iDim_t tot = 0, w;
     uint8_t i;
-    uint32_t ch;
+    uint32_t ch, next = 0;
     const GUI_Char* tmp = str->Str;                 /* Set start of string */
     
     GUI_STRING_GoToEnd(str);                        /* Go to the end of string */
@@ -584,7 +562,8 @@ const GUI_Char* __StringGetPointerForWidth(const GUI_FONT_t* font, GUI_STRING_t*
         if (!GUI_STRING_GetChReverse(str, &ch, &i)) {   /* Get character in reverse order */
             break;
         }
-        __StringGetCharSize(font, ch, &w, &h);
+        w = __StringGetCharAdvance(font, ch) + __StringGetKerning(font, ch, next);
+        next = ch;
         if ((tot + w) < draw->Width) {
             tot += w;
         } else {
@@ -595,6 +574,459 @@ const GUI_Char* __StringGetPointerForWidth(const GUI_FONT_t* font, GUI_STRING_t*
     return str->Str + i + 1;
 }
 
+/* Get Y position of first line of text with height of all lines */
+static
+GUI_iDim_t __GetTextStartY(const GUI_DRAW_FONT_t* draw, GUI_iDim_t height) {
+    GUI_iDim_t y = draw->Y;                         /* Get start Y position */
+    
+    if (draw->Align & GUI_VALIGN_CENTER) {          /* Check for vertical align center */
+        y += (draw->Height - height) / 2;           /* Align center of drawing area */
+    } else if (draw->Align & GUI_VALIGN_BOTTOM) {   /* Check for vertical align bottom */
+        y += draw->Height - height;                 /* Align bottom of drawing area */
+    }
+    
+    if (y < draw->Y) {                              /* Check situation first */
+        y = draw->Y;
+    }
+    y -= draw->ScrollY;                             /* Go scroll top */
+    
+    /**
+     * Check Y start value in case of edit mode = allow always on bottom
+     */
+    if (draw->Flags & GUI_FLAG_FONT_MULTILINE && draw->Flags & GUI_FLAG_FONT_EDITMODE) {    /* In multi-line and edit mode */
+        if (height > draw->Height) {                /* If text is greater than visible area in edit mode, set it to bottom align */
+            y = draw->Y + draw->Height - height;
+        }
+    }
+    return y;
+}
+
+/* Get X position of line of text with line width */
+static
+GUI_iDim_t __GetTextLineStartX(const GUI_DRAW_FONT_t* draw, GUI_iDim_t width) {
+    GUI_iDim_t x = draw->X;
+    
+    if (draw->Align & GUI_HALIGN_CENTER) {          /* Check for horizontal align center */
+        x += (draw->Width - width) / 2;             /* Align center of drawing area */
+    } else if (draw->Align & GUI_HALIGN_RIGHT) {    /* Check for horizontal align right */
+        x += draw->Width - width;                   /* Align right of drawing area */
+    }
+    return x;
+}
+
+/* Draw single line of text, cnt characters are read from string and first drawCnt of them are drawn */
+static
+void __DrawTextLine(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_DRAW_FONT_t* draw, GUI_iDim_t x, GUI_iDim_t y, GUI_STRING_t* currStr, size_t cnt, size_t drawCnt) {
+    const GUI_FONT_CharInfo_t* c;
+    uint32_t ch, prev = 0;
+    uint8_t i;
+    
+    while (cnt-- && GUI_STRING_GetCh(currStr, &ch, &i)) {   /* Read character by character */
+        ch = __GetCharFromValue(ch);                /* Get char from char value */
+        x += __StringGetKerning(font, prev, ch);    /* Correct position for pair of characters */
+        prev = ch;
+        if (drawCnt == 0) {                         /* Anything to draw? */
+            continue;
+        }
+        drawCnt--;                                  /* Decrease number of drawn elements */
+        
+        if (x > disp->X2) {                         /* Check if X over line */
+            continue;
+        }
+        
+        if ((c = __StringGetCharPtr(font, ch)) == 0) {  /* Get character pointer */
+            continue;                               /* Character is not known */
+        }
+        __DRAW_Char(disp, font, draw, x, y, ch, c); /* Draw actual char */
+        
+        x += __StringGetCharAdvance(font, ch);      /* Increase X position */
+    }
+}
+
+#if GUI_TEXTLAYOUT_CACHE_SIZE
+/* Measure text and wrap it to lines, returned layout is added to cache */
+static
+const GUI_TEXTLAYOUT_t* __CreateTextLayout(const GUI_FONT_t* font, const GUI_Char* str, GUI_DRAW_FONT_t* draw) {
+    GUI_StringRect_t rect = {0};
+    GUI_STRING_t currStr;
+    GUI_DRAW_FONT_t tmpDraw;
+    GUI_TEXTLAYOUT_t* layout;
+    GUI_TEXTLAYOUT_Line_t* line;
+    const GUI_Char* start = str;
+    GUI_iDim_t height;
+    size_t cnt, lines;
+    uint32_t ch;
+    uint8_t i, pass;
+    
+    rect.Font = font;                               /* Save font structure */
+    rect.StringDraw = draw;                         /* Set drawing pointer */
+    rect.IsEditMode = !!(draw->Flags & GUI_FLAG_FONT_EDITMODE); /* Check if in edit mode */
+    
+    GUI_STRING_Prepare(&currStr, str);              /* Prepare string */
+    __StringRectangle(&rect, &currStr, 0);          /* Get string rectangle for this box */
+    height = rect.Height;
+    memcpy(&tmpDraw, draw, sizeof(tmpDraw));
+    if (rect.Width > draw->Width && draw->Flags & GUI_FLAG_FONT_RIGHTALIGN) {   /* Show only end of string */
+        GUI_STRING_Prepare(&currStr, str);          /* Prepare string */
+        start = __StringGetPointerForWidth(font, &currStr, &tmpDraw);   /* Get string pointer and X position */
+    }
+    
+    /**
+     * Lines are counted in first pass to allocate layout
+     * and written to layout in second pass
+     */
+    layout = NULL;
+    for (pass = 0; pass < 2; pass++) {
+        lines = 0;
+        GUI_STRING_Prepare(&currStr, start);
+        while ((cnt = __StringRectangle(&rect, &currStr, 1)) > 0) {
+            if (layout) {                           /* Save line */
+                line = &__GUI_TEXTLAYOUT_GetLines(layout)[lines];
+                line->Offset = currStr.Str - str;
+                line->Count = cnt;
+                line->Draw = rect.ReadDraw;
+                line->Width = rect.Width;
+            }
+            lines++;
+            while (cnt-- && GUI_STRING_GetCh(&currStr, &ch, &i)) {} /* Skip characters of line */
+            if (!(draw->Flags & GUI_FLAG_FONT_MULTILINE)) { /* Only first line is drawn */
+                break;
+            }
+        }
+        if (!pass) {
+            layout = __GUI_TEXTLAYOUT_Add(str, font, draw->Width, draw->LineHeight, draw->Flags, lines);
+            if (!layout) {
+                return NULL;
+            }
+        }
+    }
+    
+    layout->TextHeight = height;
+    layout->ShiftX = tmpDraw.X - draw->X;
+    layout->Start = start - str;
+    return layout;
+}
+
+/* Draw text with layout */
+static
+void __DrawTextLayout(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_Char* str, GUI_DRAW_FONT_t* draw, const GUI_TEXTLAYOUT_t* layout) {
+    const GUI_TEXTLAYOUT_Line_t* line = __GUI_TEXTLAYOUT_GetLines(layout);
+    GUI_STRING_t currStr;
+    GUI_iDim_t x, y;
+    size_t n;
+    
+    draw->X += layout->ShiftX;                      /* Text aligned right starts before rectangle */
+    y = __GetTextStartY(draw, layout->TextHeight);  /* Get Y position of first line */
+    for (n = 0; n < layout->LinesCount; n++, line++) {
+        x = __GetTextLineStartX(draw, line->Width); /* Get X position of line */
+        GUI_STRING_Prepare(&currStr, str + line->Offset);
+        __DrawTextLine(disp, font, draw, x, y, &currStr, line->Count, line->Draw);
+        y += draw->LineHeight;                      /* Go to next line */
+        if (y > disp->Y2) {                         /* Over visible Y area */
+            break;
+        }
+    }
+}
+#endif /* GUI_TEXTLAYOUT_CACHE_SIZE */
+
+/* Clip rectangle to drawing region, returns 1 when part of rectangle is visible */
+static
+uint8_t __ClipRect(const GUI_Display_t* disp, GUI_iDim_t* x, GUI_iDim_t* y, GUI_iDim_t* width, GUI_iDim_t* height) {
+    if (                                            /* Check if redraw is inside area */
+        !__GUI_RECT_MATCH(  *x, *y, *x + *width, *y + *height,
+                            disp->X1, disp->Y1, disp->X2, disp->Y2)) {
+        return 0;
+    }
+        
+    if (*width <= 0 || *height <= 0) {
+        return 0;
+    }
+    
+    /* We are in region */
+    if (*x < disp->X1) {
+        *width -= (disp->X1 - *x);
+        *x = disp->X1;
+    }
+    if (*y < disp->Y1) {
+        *height -= (disp->Y1 - *y);
+        *y = disp->Y1;
+    }
+    
+    /* Check out of regions */
+    if ((*x + *width) > disp->X2) {
+        *width = disp->X2 - *x;
+    }
+    if ((*y + *height) > disp->Y2) {
+        *height = disp->Y2 - *y;
+    }
+    return *width > 0 && *height > 0;
+}
+
+/* Floor division of 64-bit numerator with positive denominator */
+static
+int32_t __PolyDivFloor(int64_t num, int32_t den, int32_t* rem) {
+    int64_t q = num / den;
+    int64_t r = num % den;
+    if (r < 0) {
+        q--;
+        r += den;
+    }
+    *rem = (int32_t)r;
+    return (int32_t)q;
+}
+
+/* Get first pixel on the right of edge on current scanline */
+#define __PolyEdgePixel(e)          ((e)->X + ((e)->Rem > 0))
+
+/* Set edge position to pixel centers of scanline y */
+static
+void __PolyEdgeSetLine(GUI_PolyEdge_t* e, GUI_iDim_t y) {
+    int32_t den = 2 * e->DY;
+    
+    /**
+     * Edge crosses scanline center y + 0.5 at x = X0 + (2 * (y - Y0) + 1) * DX / (2 * DY)
+     * and pixel centers on the right are from ceil(x - 0.5) on
+     */
+    e->X = __PolyDivFloor((int64_t)2 * e->X0 * e->DY + (int64_t)(2 * (y - e->Y0) + 1) * e->DX - e->DY, den, &e->Rem);
+    e->StepX = __PolyDivFloor((int64_t)2 * e->DX, den, &e->StepRem);
+}
+
+/* Fill polygon with scanline algorithm using active edge table */
+static
+void __FillPoly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, size_t len, GUI_PolyEdge_t* edges, GUI_PolyEdge_t** active, GUI_DRAW_FillRule_t rule, GUI_Color_t color) {
+    GUI_PolyEdge_t *e, *tmp;
+    const GUI_DRAW_Poly_t *p1, *p2;
+    size_t i, j, cnt = 0, next = 0, act = 0;
+    GUI_iDim_t y, yEnd, x1, x2;
+    int32_t winding;
+    
+    /* Build edge table without horizontal edges, sorted by top scanline */
+    yEnd = disp->Y1;
+    for (i = 0; i < len; i++) {
+        p1 = &points[i];
+        p2 = &points[(i + 1) % len];
+        if (p1->Y == p2->Y) {
+            continue;
+        }
+        e = &edges[cnt];
+        e->Dir = p1->Y < p2->Y ? 1 : -1;
+        if (p1->Y > p2->Y) {                        /* Edge must go down */
+            const GUI_DRAW_Poly_t* t = p1;
+            p1 = p2;
+            p2 = t;
+        }
+        e->X0 = p1->X;
+        e->Y0 = p1->Y;
+        e->DX = p2->X - p1->X;
+        e->DY = p2->Y - p1->Y;
+        e->YStart = __GUI_MAX(p1->Y, disp->Y1);
+        e->YEnd = __GUI_MIN(p2->Y, disp->Y2);
+        if (e->YStart >= e->YEnd) {                 /* Edge is outside drawing region */
+            continue;
+        }
+        yEnd = __GUI_MAX(yEnd, e->YEnd);
+        for (j = cnt; j > 0 && edges[j - 1].YStart > e->YStart; j--);  /* Insert sorted */
+        if (j != cnt) {
+            GUI_PolyEdge_t t = *e;
+            memmove(&edges[j + 1], &edges[j], (cnt - j) * sizeof(*edges));
+            edges[j] = t;
+        }
+        cnt++;
+    }
+    if (!cnt) {
+        return;
+    }
+    
+    for (y = edges[0].YStart; y < yEnd; y++) {
+        /* Remove finished edges */
+        for (i = 0, j = 0; i < act; i++) {
+            if (active[i]->YEnd > y) {
+                active[j++] = active[i];
+            }
+        }
+        act = j;
+        
+        /* Add edges starting on this scanline */
+        while (next < cnt && edges[next].YStart == y) {
+            __PolyEdgeSetLine(&edges[next], y);
+            active[act++] = &edges[next++];
+        }
+        if (!act) {
+            if (next >= cnt) {
+                break;
+            }
+            y = edges[next].YStart - 1;             /* Skip empty scanlines */
+            continue;
+        }
+        
+        /* Keep active edges sorted by X, order changes only slightly between scanlines */
+        for (i = 1; i < act; i++) {
+            tmp = active[i];
+            for (j = i; j > 0 && __PolyEdgePixel(active[j - 1]) > __PolyEdgePixel(tmp); j--) {
+                active[j] = active[j - 1];
+            }
+            active[j] = tmp;
+        }
+        
+        /* Draw spans between edges according to fill rule */
+        winding = 0;
+        for (i = 0; i + 1 < act; i++) {
+            if (rule == GUI_DRAW_FillRule_NonZero) {
+                winding += active[i]->Dir;
+            } else {
+                winding ^= 1;
+            }
+            if (!winding) {
+                continue;
+            }
+            x1 = (GUI_iDim_t)__GUI_MAX(__PolyEdgePixel(active[i]), disp->X1);
+            x2 = (GUI_iDim_t)__GUI_MIN(__PolyEdgePixel(active[i + 1]), disp->X2);
+            if (x1 < x2) {
+                __GUI_BATCH_Fill(x1 - GUI.LCD.DrawingLayer->OffsetX, y - GUI.LCD.DrawingLayer->OffsetY, x2 - x1, 1, color);
+            }
+        }
+        
+        /* Move edges to next scanline */
+        for (i = 0; i < act; i++) {
+            e = active[i];
+            e->X += e->StepX;
+            e->Rem += e->StepRem;
+            if (e->Rem >= 2 * e->DY) {
+                e->Rem -= 2 * e->DY;
+                e->X++;
+            }
+        }
+    }
+    __GUI_BATCH_Flush();                            /* Send batched spans to driver */
+}
+
+#if GUI_CIRCLE_CACHE_SIZE
+/* Get cached widths of filled circle corner rows, same pixels as midpoint algorithm in GUI_DRAW_FilledCircleCorner */
+static
+const GUI_iDim_t* __GetCircleSpans(GUI_iDim_t r) {
+    GUI_CircleSpans_t* e = &CircleSpans[0];
+    GUI_iDim_t f = 1 - r;
+    GUI_iDim_t ddF_x = 1;
+    GUI_iDim_t ddF_y = -2 * r;
+    GUI_iDim_t x = 0;
+    GUI_iDim_t y = r;
+    size_t i;
+    
+    for (i = 0; i < GUI_CIRCLE_CACHE_SIZE; i++) {
+        if (CircleSpans[i].R == r) {                /* Table for radius exists */
+            CircleSpans[i].Used = ++CircleSpansTime;
+            return CircleSpans[i].Spans;
+        }
+        if (CircleSpans[i].Used < e->Used) {        /* Find least recently used entry */
+            e = &CircleSpans[i];
+        }
+    }
+    
+    if (e->Spans) {                                 /* Replace old table */
+        __GUI_MEMFREE(e->Spans);
+        e->R = 0;
+    }
+    e->Spans = __GUI_MEMALLOC(sizeof(*e->Spans) * (r + 1));
+    if (!e->Spans) {
+        return NULL;
+    }
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        
+        e->Spans[y] = __GUI_MAX(e->Spans[y], x);    /* Row y from center */
+        e->Spans[x] = __GUI_MAX(e->Spans[x], y);    /* Row x from center */
+    }
+    e->R = r;
+    e->Used = ++CircleSpansTime;
+    return e->Spans;
+}
+
+/* Draw filled circle corners from span table, rows with the same width are merged to single rectangle */
+static
+void __DrawCircleSpans(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, const GUI_iDim_t* spans, GUI_Byte_t c, GUI_Color_t color) {
+    GUI_iDim_t k, start, left, right;
+    uint8_t top;
+    
+    for (top = 0; top < 2; top++) {
+        left = top ? (c & GUI_DRAW_CIRCLE_TL) : (c & GUI_DRAW_CIRCLE_BL);
+        right = top ? (c & GUI_DRAW_CIRCLE_TR) : (c & GUI_DRAW_CIRCLE_BR);
+        if (!left && !right) {
+            continue;
+        }
+        for (start = 1, k = 1; k <= r; k++) {
+            if (k == r || spans[k + 1] != spans[start]) {   /* End of rows with equal width */
+                GUI_iDim_t x = left ? x0 - spans[start] : x0;
+                GUI_iDim_t y = top ? y0 - k : y0 + start;
+                GUI_iDim_t width = (left ? spans[start] : 0) + (right ? spans[start] : 0);
+                GUI_iDim_t height = k - start + 1;
+                
+                if (__ClipRect(disp, &x, &y, &width, &height)) {
+                    __GUI_BATCH_Fill(x - GUI.LCD.DrawingLayer->OffsetX, y - GUI.LCD.DrawingLayer->OffsetY, width, height, color);
+                }
+                start = k + 1;
+            }
+        }
+    }
+    __GUI_BATCH_Flush();                            /* Send batched rows to driver */
+}
+#endif /* GUI_CIRCLE_CACHE_SIZE */
+
+/* Get gradient color at pixel position pos on gradient of len pixels */
+static
+GUI_Color_t __GradientColor(const GUI_Gradient_t* g, GUI_iDim_t pos, GUI_iDim_t len) {
+    uint32_t p, pa = 0, pb = 0xFF00, t;
+    GUI_Color_t ca = g->Start, cb = g->Stop, res = 0;
+    size_t i;
+    uint8_t sh;
+    
+    p = len > 1 ? (uint32_t)pos * 0xFF00UL / (len - 1) : 0; /* Position in 8.8 fixed point format */
+    for (i = 0; i < g->StopsCount; i++) {           /* Find stops around position */
+        if (((uint32_t)g->Stops[i].Pos << 8) <= p) {
+            pa = (uint32_t)g->Stops[i].Pos << 8;
+            ca = g->Stops[i].Color;
+        } else {
+            pb = (uint32_t)g->Stops[i].Pos << 8;
+            cb = g->Stops[i].Color;
+            break;
+        }
+    }
+    if (pb <= pa) {                                 /* Position is on last stop */
+        return ca;
+    }
+    t = (p - pa) * 256 / (pb - pa);                 /* Interpolation factor between 0 and 256 */
+    for (sh = 0; sh < 32; sh += 8) {                /* Interpolate each channel including alpha */
+        int32_t a = (ca >> sh) & 0xFF, b = (cb >> sh) & 0xFF;
+        res |= (GUI_Color_t)((a + (((b - a) * (int32_t)t) >> 8)) & 0xFF) << sh;
+    }
+    return res;
+}
+
+/* Store color in layer pixel format, only 2 (RGB565) and 4 (ARGB8888) bytes per pixel are supported */
+static
+uint8_t* __GradientStore(uint8_t* d, GUI_Color_t c) {
+    if (GUI.LCD.PixelSize == 4) {
+        *(uint32_t *)d = c;
+    } else {
+        *(uint16_t *)d = (uint16_t)(((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F));
+    }
+    return d + GUI.LCD.PixelSize;
+}
+
+/* Check if rendered gradient in cache matches requested one */
+static
+uint8_t __GradientCacheMatch(const GUI_DRAW_GradientCache_t* cache, const GUI_Gradient_t* g, GUI_DRAW_GradientDir_t dir, GUI_iDim_t width, GUI_iDim_t height) {
+    return cache->Data && cache->Dir == dir && cache->Width == width && cache->Height == height
+        && cache->Gradient.Start == g->Start && cache->Gradient.Stop == g->Stop
+        && cache->Gradient.Stops == g->Stops && cache->Gradient.StopsCount == g->StopsCount;
+}
+
 /******************************************************************************/
 /******************************************************************************/
 /***                              Protothreads                               **/
@@ -620,34 +1052,7 @@ void GUI_DRAW_FillScreen(const GUI_Display_t* disp, GUI_Color_t color) {
 }
 
 void GUI_DRAW_Fill(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color) {
-    if (                                            /* Check if redraw is inside area */
-        !__GUI_RECT_MATCH(  x, y, x + width, y + height,
-                            disp->X1, disp->Y1, disp->X2, disp->Y2)) {
-        return;
-    }
-        
-    if (width <= 0 || height <= 0) {
-        return;
-    }
-    
-    /* We are in region */
-    if (x < disp->X1) {
-        width -= (disp->X1 - x);
-        x = disp->X1;
-    }
-    if (y < disp->Y1) {
-        height -= (disp->Y1 - y);
-        y = disp->Y1;
-    }
-    
-    /* Check out of regions */
-    if ((x + width) > disp->X2) {
-        width = disp->X2 - x;
-    }
-    if ((y + height) > disp->Y2) {
-        height = disp->Y2 - y;
-    }
-    if (width > 0 && height > 0) {
+    if (__ClipRect(disp, &x, &y, &width, &height)) {
         GUI.LL.FillRect(&GUI.LCD, GUI.LCD.DrawingLayer, x - GUI.LCD.DrawingLayer->OffsetX, y - GUI.LCD.DrawingLayer->OffsetY, width, height, color);
     }
 }
@@ -660,9 +1065,63 @@ void GUI_DRAW_SetPixel(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GU
 }
 
 GUI_Color_t GUI_DRAW_GetPixel(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y) {
+    __GUI_LL_FENCE();                               /* Pixel must be written before it is read */
     return GUI.LL.GetPixel(&GUI.LCD, GUI.LCD.DrawingLayer, x - GUI.LCD.DrawingLayer->OffsetX, y - GUI.LCD.DrawingLayer->OffsetY);
 }
 
+uint8_t GUI_DRAW_ReadRect(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, void* buff, GUI_PixelFormat_t format) {
+    GUI_Layer_t* layer = GUI.LCD.DrawingLayer;
+    uint8_t* d = buff;
+    GUI_iDim_t i, j;
+    
+    x -= layer->OffsetX;                            /* Get position on layer */
+    y -= layer->OffsetY;
+    if (width <= 0 || height <= 0 || x < 0 || y < 0 || (x + width) > layer->Width || (y + height) > layer->Height) {
+        return 0;
+    }
+    
+    __GUI_LL_FENCE();                               /* Pixels must be written before they are read */
+    if (GUI.LL.ReadRect) {                          /* Conversion with hardware */
+        GUI.LL.ReadRect(&GUI.LCD, layer, x, y, width, height, buff, format);
+        return 1;
+    }
+    if (GUI.LCD.PixelSize != 2 && GUI.LCD.PixelSize != 4) {
+        return 0;                                   /* Only RGB565 and ARGB8888 layers can be read by CPU */
+    }
+    
+    for (j = 0; j < height; j++) {
+        const uint8_t* s = (const uint8_t *)(layer->StartAddress + ((size_t)(y + j) * layer->Width + x) * GUI.LCD.PixelSize);
+        for (i = 0; i < width; i++, s += GUI.LCD.PixelSize) {
+            GUI_Color_t c;
+            if (GUI.LCD.PixelSize == 4) {           /* ARGB8888 layer */
+                c = *(const uint32_t *)s;
+            } else {                                /* RGB565 layer, expand to 8 bits per channel */
+                uint32_t p = *(const uint16_t *)s;
+                uint32_t r = (p >> 11) & 0x1F, g = (p >> 5) & 0x3F, b = p & 0x1F;
+                c = 0xFF000000UL | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+            }
+            switch (format) {
+                case GUI_PixelFormat_ARGB8888:
+                    *(uint32_t *)d = c;
+                    d += 4;
+                    break;
+                case GUI_PixelFormat_RGB888:
+                    *d++ = (uint8_t)c;
+                    *d++ = (uint8_t)(c >> 8);
+                    *d++ = (uint8_t)(c >> 16);
+                    break;
+                case GUI_PixelFormat_RGB565:
+                    *(uint16_t *)d = (uint16_t)(((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F));
+                    d += 2;
+                    break;
+                default:
+                    return 0;
+            }
+        }
+    }
+    return 1;
+}
+
 void GUI_DRAW_VLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t length, GUI_Color_t color) {
     if (x >= disp->X2 || x < disp->X1 || y > disp->Y2 || (y + length) < disp->Y1) {
         return;
@@ -697,19 +1156,11 @@ void GUI_DRAW_HLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_i
 /******************************************************************************/
 /******************************************************************************/
 void GUI_DRAW_Line(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_Color_t color) {
-    GUI_iDim_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0, 
-    yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0, 
-    curpixel = 0;
+    GUI_iDim_t deltax, deltay;
+    int32_t n, d, h, num, k, kMin, kMax, lo, hi, jLo, jHi, mMaj, mMin, sMaj, sMin, start, steep;
     
-    /* Check if coordinates are inside drawing region */
-//    if (                                            /* Check if redraw is inside area */
-//        !__GUI_RECT_MATCH(  x1, y1, x2, y2,
-//                            disp->X1, disp->Y1, disp->X2, disp->Y2)) {
-//        return;
-//    }
-
-	deltax = __GUI_ABS(x2 - x1);
-	deltay = __GUI_ABS(y2 - y1);
+    deltax = __GUI_ABS(x2 - x1);
+    deltay = __GUI_ABS(y2 - y1);
     
     if (deltax == 0) {                              /* Straight vertical line */
         GUI_DRAW_VLine(disp, x1, __GUI_MIN(y1, y2), deltay, color);
@@ -719,53 +1170,94 @@ void GUI_DRAW_Line(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_
         GUI_DRAW_HLine(disp, __GUI_MIN(x1, x2), y1, deltax, color);
         return;
     }
-
-    x = x1;
-    y = y1;
-
-    if (x2 >= x1) {
-        xinc1 = 1;
-        xinc2 = 1;
+    
+    /* Check if line is inside drawing region */
+    if (__GUI_MAX(x1, x2) < disp->X1 || __GUI_MIN(x1, x2) >= disp->X2 ||
+        __GUI_MAX(y1, y2) < disp->Y1 || __GUI_MIN(y1, y2) >= disp->Y2) {
+        return;
+    }
+    
+    /**
+     * Bresenham line along major axis with n + 1 pixels.
+     * Pixel k is on major position start + k and minor position start + (n / 2 + k * d) / n,
+     * which allows to compute first and last pixel inside drawing region directly
+     */
+    steep = deltay > deltax;
+    if (steep) {
+        n = deltay; d = deltax;
+        mMaj = y1; mMin = x1;
+        sMaj = y2 > y1 ? 1 : -1; sMin = x2 > x1 ? 1 : -1;
     } else {
-        xinc1 = -1;
-        xinc2 = -1;
+        n = deltax; d = deltay;
+        mMaj = x1; mMin = y1;
+        sMaj = x2 > x1 ? 1 : -1; sMin = y2 > y1 ? 1 : -1;
     }
-
-    if (y2 >= y1) {
-        yinc1 = 1;
-        yinc2 = 1;
+    h = n / 2;
+    
+    /* Clip major axis to [lo, hi) */
+    lo = steep ? disp->Y1 : disp->X1;
+    hi = steep ? disp->Y2 : disp->X2;
+    if (sMaj > 0) {
+        kMin = lo - mMaj;
+        kMax = hi - 1 - mMaj;
     } else {
-        yinc1 = -1;
-        yinc2 = -1;
+        kMin = mMaj - (hi - 1);
+        kMax = mMaj - lo;
     }
-
-    if (deltax >= deltay) {
-        xinc1 = 0;
-        yinc2 = 0;
-        den = deltax;
-        num = deltax / 2;
-        numadd = deltay;
-        numpixels = deltax;
+    
+    /* Clip minor axis to [lo, hi), minor step j must be in [jLo, jHi] */
+    lo = steep ? disp->X1 : disp->Y1;
+    hi = steep ? disp->X2 : disp->Y2;
+    if (sMin > 0) {
+        jLo = lo - mMin;
+        jHi = hi - 1 - mMin;
     } else {
-        xinc2 = 0;
-        yinc1 = 0;
-        den = deltay;
-        num = deltay / 2;
-        numadd = deltax;
-        numpixels = deltay;
+        jLo = mMin - (hi - 1);
+        jHi = mMin - lo;
     }
-
-    for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-        GUI_DRAW_SetPixel(disp, x, y, color);
-        num += numadd;
-        if (num >= den) {
-            num -= den;
-            x += xinc1;
-            y += yinc1;
+    if (jHi < 0) {
+        return;
+    }
+    if (jLo > 0) {                                  /* First pixel with (h + k * d) / n >= jLo */
+        kMin = __GUI_MAX(kMin, (jLo * n - h + d - 1) / d);
+    }
+    kMax = __GUI_MIN(kMax, ((jHi + 1) * n - h - 1) / d);   /* Last pixel with (h + k * d) / n <= jHi */
+    kMin = __GUI_MAX(kMin, 0);
+    kMax = __GUI_MIN(kMax, n);
+    if (kMin > kMax) {
+        return;
+    }
+    
+    /* Go to first visible pixel */
+    num = h + kMin * d;
+    mMin += sMin * (num / n);
+    num %= n;
+    mMaj += sMaj * kMin;
+    
+    /**
+     * Draw runs of pixels with the same minor position
+     * as single horizontal or vertical line
+     */
+    start = mMaj;
+    for (k = kMin; k <= kMax; k++) {
+        num += d;
+        if (num >= n || k == kMax) {                /* Minor position changes after this pixel */
+            GUI_iDim_t first = (GUI_iDim_t)__GUI_MIN(start, mMaj);
+            GUI_iDim_t len = (GUI_iDim_t)(__GUI_ABS(mMaj - start) + 1);
+            if (steep) {
+                __GUI_BATCH_Fill((GUI_iDim_t)mMin - GUI.LCD.DrawingLayer->OffsetX, first - GUI.LCD.DrawingLayer->OffsetY, 1, len, color);
+            } else {
+                __GUI_BATCH_Fill(first - GUI.LCD.DrawingLayer->OffsetX, (GUI_iDim_t)mMin - GUI.LCD.DrawingLayer->OffsetY, len, 1, color);
+            }
+            if (num >= n) {
+                num -= n;
+                mMin += sMin;
+            }
+            start = mMaj + sMaj;
         }
-        x += xinc2;
-        y += yinc2;
+        mMaj += sMaj;
     }
+    __GUI_BATCH_Flush();                            /* Send batched runs to driver */
 }
 
 void GUI_DRAW_Rectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color) {
@@ -783,6 +1275,97 @@ void GUI_DRAW_FilledRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_
     GUI_DRAW_Fill(disp, x, y, width, height, color);
 }
 
+void GUI_DRAW_FillGradient(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, const GUI_Gradient_t* gradient, GUI_DRAW_GradientDir_t dir, GUI_DRAW_GradientCache_t* cache) {
+    GUI_Layer_t* layer = GUI.LCD.DrawingLayer;
+    GUI_iDim_t cx = x, cy = y, cw = width, ch = height, i, j, n;
+    size_t ps = GUI.LCD.PixelSize;
+    uint8_t canCopy, *d;
+    
+    if (!__ClipRect(disp, &cx, &cy, &cw, &ch)) {    /* Get visible part of rectangle */
+        return;
+    }
+    canCopy = (ps == 2 || ps == 4) && GUI.LL.Copy && layer->StartAddress;
+    
+    /*******************/
+    /* Cached gradient */
+    /*******************/
+    if (cache && canCopy) {
+        if (!__GradientCacheMatch(cache, gradient, dir, width, height)) {
+            GUI_DRAW_GradientCacheFree(cache);      /* Release old gradient */
+            cache->Data = __GUI_MEMALLOC((size_t)width * height * ps);
+            if (cache->Data) {                      /* Render complete gradient once */
+                d = cache->Data;
+                for (j = 0; j < height; j++) {
+                    if (dir == GUI_DRAW_GradientDir_Vertical) {
+                        GUI_Color_t c = __GradientColor(gradient, j, height);
+                        for (i = 0; i < width; i++) {
+                            d = __GradientStore(d, c);
+                        }
+                    } else if (j == 0) {
+                        for (i = 0; i < width; i++) {
+                            d = __GradientStore(d, __GradientColor(gradient, i, width));
+                        }
+                    } else {                        /* Each line of horizontal gradient is the same */
+                        memcpy(d, cache->Data, (size_t)width * ps);
+                        d += (size_t)width * ps;
+                    }
+                }
+                cache->Gradient = *gradient;
+                cache->Dir = dir;
+                cache->Width = width;
+                cache->Height = height;
+            }
+        }
+        if (cache->Data) {                          /* Redraw is a single copy */
+            __GUI_BATCH_Flush();                    /* Keep order with batched commands */
+            GUI.LL.Copy(&GUI.LCD, layer,
+                (uint8_t *)cache->Data + ((size_t)(cy - y) * width + (cx - x)) * ps,
+                (uint8_t *)(layer->StartAddress + ((size_t)(cy - layer->OffsetY) * layer->Width + (cx - layer->OffsetX)) * ps),
+                cw, ch, width - cw, layer->Width - cw);
+            return;
+        }
+    }
+    
+    /*******************/
+    /*    Vertical     */
+    /*******************/
+    if (dir == GUI_DRAW_GradientDir_Vertical) {     /* Each line has single color */
+        for (j = 0; j < ch; j++) {
+            __GUI_BATCH_Fill(cx - layer->OffsetX, cy + j - layer->OffsetY, cw, 1, __GradientColor(gradient, cy - y + j, height));
+        }
+        __GUI_BATCH_Flush();                        /* Send batched lines to driver */
+        return;
+    }
+    
+    /*******************/
+    /*   Horizontal    */
+    /*******************/
+    if (!canCopy) {                                 /* Each column has single color */
+        for (i = 0; i < cw; i++) {
+            __GUI_BATCH_Fill(cx + i - layer->OffsetX, cy - layer->OffsetY, 1, ch, __GradientColor(gradient, cx - x + i, width));
+        }
+        __GUI_BATCH_Flush();                        /* Send batched columns to driver */
+        return;
+    }
+    
+    d = (uint8_t *)(layer->StartAddress + ((size_t)(cy - layer->OffsetY) * layer->Width + (cx - layer->OffsetX)) * ps);
+    __GUI_LL_FENCE();                               /* Pending operations may still write to first line */
+    for (i = 0; i < cw; i++) {                      /* Render first visible line */
+        __GradientStore(d + i * ps, __GradientColor(gradient, cx - x + i, width));
+    }
+    for (j = 1; j < ch; j += n) {                   /* Replicate already rendered lines, doubling them each time */
+        n = j < ch - j ? j : ch - j;
+        GUI.LL.Copy(&GUI.LCD, layer, d, d + (size_t)j * layer->Width * ps, cw, n, layer->Width - cw, layer->Width - cw);
+    }
+}
+
+void GUI_DRAW_GradientCacheFree(GUI_DRAW_GradientCache_t* cache) {
+    if (cache->Data) {
+        __GUI_LL_FENCE();                           /* Driver may still copy from memory */
+        __GUI_MEMFREE(cache->Data);
+    }
+}
+
 void GUI_DRAW_Rectangle3D(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_DRAW_3D_State_t state) {
     GUI_Color_t c1, c2, c3;
     
@@ -859,6 +1442,20 @@ void GUI_DRAW_Circle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_
 }
 
 void GUI_DRAW_FilledCircle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t r, GUI_Color_t color) {
+#if GUI_CIRCLE_CACHE_SIZE
+    const GUI_iDim_t* spans;
+    
+    if (r > 0 && (spans = __GetCircleSpans(r)) != NULL) {
+        if (__GUI_RECT_MATCH(
+            disp->X1, disp->Y1, disp->X2, disp->Y2,
+            x - r, y - r - 1, x + r, y + r
+        )) {
+            __DrawCircleSpans(disp, x, y, r, spans, GUI_DRAW_CIRCLE_TL | GUI_DRAW_CIRCLE_TR, color);
+            __DrawCircleSpans(disp, x, y - 1, r, spans, GUI_DRAW_CIRCLE_BL | GUI_DRAW_CIRCLE_BR, color);
+        }
+        return;
+    }
+#endif /* GUI_CIRCLE_CACHE_SIZE */
     GUI_DRAW_FilledCircleCorner(disp, x, y, r, GUI_DRAW_CIRCLE_TL, color);
     GUI_DRAW_FilledCircleCorner(disp, x, y, r, GUI_DRAW_CIRCLE_TR, color);
     GUI_DRAW_FilledCircleCorner(disp, x, y - 1, r, GUI_DRAW_CIRCLE_BL, color);
@@ -872,59 +1469,13 @@ void GUI_DRAW_Triangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1,
 }
 
 void GUI_DRAW_FilledTriangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_iDim_t x3, GUI_iDim_t y3, GUI_Color_t color) {
-    GUI_iDim_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0, 
-    yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0, 
-    curpixel = 0;
-
-    deltax = __GUI_ABS(x2 - x1);
-    deltay = __GUI_ABS(y2 - y1);
-    x = x1;
-    y = y1;
-
-    if (x2 >= x1) {
-        xinc1 = 1;
-        xinc2 = 1;
-    } else {
-        xinc1 = -1;
-        xinc2 = -1;
-    }
-
-    if (y2 >= y1) {
-        yinc1 = 1;
-        yinc2 = 1;
-    } else {
-        yinc1 = -1;
-        yinc2 = -1;
-    }
-
-    if (deltax >= deltay){
-        xinc1 = 0;
-        yinc2 = 0;
-        den = deltax;
-        num = deltax / 2;
-        numadd = deltay;
-        numpixels = deltax;
-    } else {
-        xinc2 = 0;
-        yinc1 = 0;
-        den = deltay;
-        num = deltay / 2;
-        numadd = deltax;
-        numpixels = deltay;
-    }
-
-    for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-        GUI_DRAW_Line(disp, x, y, x3, y3, color);
-
-        num += numadd;
-        if (num >= den) {
-            num -= den;
-            x += xinc1;
-            y += yinc1;
-        }
-        x += xinc2;
-        y += yinc2;
-    }
+    GUI_DRAW_Poly_t points[3];
+    GUI_PolyEdge_t edges[3], *active[3];
+    
+    points[0].X = x1; points[0].Y = y1;
+    points[1].X = x2; points[1].Y = y2;
+    points[2].X = x3; points[2].Y = y3;
+    __FillPoly(disp, points, 3, edges, active, GUI_DRAW_FillRule_EvenOdd, color);
 }
 
 void GUI_DRAW_CircleCorner(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_Byte_t c, GUI_Color_t color) {
@@ -979,6 +1530,9 @@ void GUI_DRAW_FilledCircleCorner(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_i
     GUI_iDim_t ddF_y = -2 * r;
     GUI_iDim_t x = 0;
     GUI_iDim_t y = r;
+#if GUI_CIRCLE_CACHE_SIZE
+    const GUI_iDim_t* spans;
+#endif /* GUI_CIRCLE_CACHE_SIZE */
     
     if (!__GUI_RECT_MATCH(
         disp->X1, disp->Y1, disp->X2, disp->Y2,
@@ -986,6 +1540,13 @@ void GUI_DRAW_FilledCircleCorner(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_i
     )) {
         return;
     }
+    
+#if GUI_CIRCLE_CACHE_SIZE
+    if (r > 0 && (spans = __GetCircleSpans(r)) != NULL) {
+        __DrawCircleSpans(disp, x0, y0, r, spans, c, color);
+        return;
+    }
+#endif /* GUI_CIRCLE_CACHE_SIZE */
 
     while (x < y) {
         if (f >= 0) {
@@ -1096,12 +1657,30 @@ void GUI_DRAW_Poly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, siz
     }
 }
 
+void GUI_DRAW_FilledPoly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, size_t len, GUI_DRAW_FillRule_t rule, GUI_Color_t color) {
+    GUI_PolyEdge_t edgesStatic[POLY_EDGES_STATIC], *activeStatic[POLY_EDGES_STATIC];
+    GUI_PolyEdge_t *edges = edgesStatic, **active = activeStatic;
+    
+    if (len < 3) {
+        return;
+    }
+    
+    if (len > POLY_EDGES_STATIC) {                  /* Too many edges for stack */
+        active = __GUI_MEMALLOC(len * (sizeof(*active) + sizeof(*edges)));
+        if (!active) {
+            return;
+        }
+        edges = (GUI_PolyEdge_t *)&active[len];
+    }
+    __FillPoly(disp, points, len, edges, active, rule, color);
+    if (active != activeStatic) {
+        __GUI_MEMFREE(active);
+    }
+}
+
 void GUI_DRAW_WriteText(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_Char* str, GUI_DRAW_FONT_t* draw) {
     GUI_iDim_t x, y;
-    uint32_t ch;
-    uint8_t i;
     size_t cnt;
-    const GUI_FONT_CharInfo_t* c;
     GUI_StringRect_t rect = {0};                    /* Get string object */
     GUI_STRING_t currStr;
     
@@ -1109,6 +1688,28 @@ void GUI_DRAW_WriteText(const GUI_Display_t* disp, const GUI_FONT_t* font, const
         draw->LineHeight = font->Size;              /* Set font size */
     }
     
+#if GUI_TEXTLAYOUT_CACHE_SIZE
+    {
+        const GUI_TEXTLAYOUT_t* layout;
+        
+        /**
+         * Unchanged text is drawn with cached layout, without measurement and line wrapping
+         */
+        layout = __GUI_TEXTLAYOUT_Get(str, font, draw->Width, draw->LineHeight, draw->Flags);
+        if (layout) {
+            __GUI_STATS_INC(TextLayoutHits);
+        } else {
+            __GUI_STATS_INC(TextLayoutMisses);
+            layout = __CreateTextLayout(font, str, draw);
+        }
+        if (layout) {
+            __DrawTextLayout(disp, font, str, draw, layout);
+            __GUI_BATCH_Flush();                    /* Send batched characters to driver */
+            return;
+        }
+    }
+#endif /* GUI_TEXTLAYOUT_CACHE_SIZE */
+    
     rect.Font = font;                               /* Save font structure */
     rect.StringDraw = draw;                         /* Set drawing pointer */
     rect.IsEditMode = !!(draw->Flags & GUI_FLAG_FONT_EDITMODE); /* Check if in edit mode */
@@ -1124,71 +1725,35 @@ void GUI_DRAW_WriteText(const GUI_Display_t* disp, const GUI_FONT_t* font, const
         }
     }
     
-    x = draw->X;                                    /* Get start X position */
-    y = draw->Y;                                    /* Get start Y position */
-    
-    if (draw->Align & GUI_VALIGN_CENTER) {          /* Check for vertical align center */
-        y += (draw->Height - rect.Height) / 2;      /* Align center of drawing area */
-    } else if (draw->Align & GUI_VALIGN_BOTTOM) {   /* Check for vertical align bottom */
-        y += draw->Height - rect.Height;            /* Align bottom of drawing area */
-    }
-    
-    if (y < draw->Y) {                              /* Check situation first */
-        y = draw->Y;
-    }
-    y -= draw->ScrollY;                             /* Go scroll top */
-    
-    /**
-     * Check Y start value in case of edit mode = allow always on bottom
-     */
-    if (draw->Flags & GUI_FLAG_FONT_MULTILINE && rect.IsEditMode) { /* In multi-line and edit mode */
-        if (rect.Height > draw->Height) {           /* If text is greater than visible area in edit mode, set it to bottom align */
-            y = draw->Y + draw->Height - rect.Height;
-        }
-    }
-    
-    /* Debug purpose only */
-//    x = draw->X;
-//    if (draw->Align & GUI_HALIGN_CENTER) {
-//        x += (draw->Width - rect.Width) / 2;
-//    } else if (draw->Align & GUI_HALIGN_RIGHT) {
-//        x += draw->Width - rect.Width;
-//    }
-//    GUI_DRAW_Rectangle(disp, x, y, rect.Width, rect.Height, GUI_COLOR_BLUE);
-    
+    y = __GetTextStartY(draw, rect.Height);         /* Get Y position of first line */
     
     GUI_STRING_Prepare(&currStr, str);              /* Prepare string again */
     while ((cnt = __StringRectangle(&rect, &currStr, 1)) > 0) {
-        x = draw->X;                                       
-        if (draw->Align & GUI_HALIGN_CENTER) {      /* Check for horizontal align center */
-            x += (draw->Width - rect.Width) / 2;    /* Align center of drawing area */
-        } else if (draw->Align & GUI_HALIGN_RIGHT) {/* Check for horizontal align right */
-            x += draw->Width - rect.Width;          /* Align right of drawing area */
-        }
-//        GUI_DRAW_Rectangle(disp, x, y, rect.Width, rect.Height, GUI_COLOR_RED);
-        while (cnt-- && GUI_STRING_GetCh(&currStr, &ch, &i)) {  /* Read character by character */
-            if (rect.ReadDraw == 0) {               /* Anything to draw? */
-                continue;
-            }
-            rect.ReadDraw--;                        /* Decrease number of drawn elements */
-            
-            if (x > disp->X2) {                     /* Check if X over line */
-                continue;
-            }
-            
-            ch = __GetCharFromValue(ch);            /* Get char from char value */
-            if ((c = __StringGetCharPtr(font, ch)) == 0) {  /* Get character pointer */
-                continue;                           /* Character is not known */
-            }
-            __DRAW_Char(disp, font, draw, x, y, c); /* Draw actual char */
-            
-            x += c->xSize + c->xMargin;             /* Increase X position */
-        }
+        x = __GetTextLineStartX(draw, rect.Width);  /* Get X position of line */
+        __DrawTextLine(disp, font, draw, x, y, &currStr, cnt, rect.ReadDraw);
         y += draw->LineHeight;                      /* Go to next line */
         if (!(draw->Flags & GUI_FLAG_FONT_MULTILINE) || y > disp->Y2) { /* Not multiline or over visible Y area */
             break;
         }
     }
+    __GUI_BATCH_Flush();                            /* Send batched characters to driver */
+}
+
+GUI_iDim_t GUI_DRAW_TextGetWidth(const GUI_FONT_t* font, const GUI_Char* str) {
+    GUI_STRING_t currStr;
+    GUI_iDim_t width = 0;
+    uint32_t ch, prev = 0;
+    uint8_t i;
+    
+    GUI_STRING_Prepare(&currStr, str);              /* Prepare string */
+    while (GUI_STRING_GetCh(&currStr, &ch, &i)) {   /* Read character by character */
+        if (CH_CR == ch || CH_LF == ch) {           /* Ignore new line characters */
+            continue;
+        }
+        width += __StringGetCharAdvance(font, ch) + __StringGetKerning(font, prev, ch);
+        prev = ch;
+    }
+    return width;
 }
 
 void GUI_DRAW_ScrollBar_init(GUI_DRAW_SB_t* sb) {
@@ -200,6 +200,37 @@ typedef struct GUI_DRAW_Poly_t {
     GUI_iDim_t Y;                           /*!< Poly point Y location */
 } GUI_DRAW_Poly_t;
 
+/**
+ * \brief           Polygon fill rules
+ * \sa              GUI_DRAW_FilledPoly
+ */
+typedef enum GUI_DRAW_FillRule_t {
+    GUI_DRAW_FillRule_EvenOdd = 0x00,       /*!< Pixel is filled when ray from it crosses odd number of edges */
+    GUI_DRAW_FillRule_NonZero = 0x01        /*!< Pixel is filled when winding number of polygon around it is not zero */
+} GUI_DRAW_FillRule_t;
+
+/**
+ * \brief           Gradient fill directions
+ * \sa              GUI_DRAW_FillGradient
+ */
+typedef enum GUI_DRAW_GradientDir_t {
+    GUI_DRAW_GradientDir_Horizontal = 0x00, /*!< Color changes from left to right */
+    GUI_DRAW_GradientDir_Vertical = 0x01    /*!< Color changes from top to bottom */
+} GUI_DRAW_GradientDir_t;
+
+/**
+ * \brief           Rendered gradient cache
+ * \note            Structure must be zero initialized before first use and released with \ref GUI_DRAW_GradientCacheFree
+ * \sa              GUI_DRAW_FillGradient
+ */
+typedef struct GUI_DRAW_GradientCache_t {
+    void* Data;                             /*!< Rendered gradient in layer pixel format */
+    GUI_Gradient_t Gradient;                /*!< Gradient used for rendering */
+    GUI_DRAW_GradientDir_t Dir;             /*!< Gradient direction used for rendering */
+    GUI_iDim_t Width;                       /*!< Rendered width in units of pixels */
+    GUI_iDim_t Height;                      /*!< Rendered height in units of pixels */
+} GUI_DRAW_GradientCache_t;
+
 /**
  * \brief           Initialize \ref GUI_DRAW_FONT_t structure for further usage
  * \param[in,out]   *f: Pointer to empty \ref GUI_DRAW_FONT_t structure
@@ -233,9 +264,29 @@ void GUI_DRAW_SetPixel(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GU
  * \param[in]       y: Y position on LCD
  * \retval          Pixel color at desired position
  * \sa              GUI_DRAW_SetPixel
+ * \sa              GUI_DRAW_ReadRect
  */
 GUI_Color_t GUI_DRAW_GetPixel(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y);
 
+/**
+ * \brief           Read rectangle of pixels from drawing layer to buffer
+ *
+ *                  Pixels are converted to desired format in single pass,
+ *                  by low-level driver when it supports it or by CPU from layer memory
+ *
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Top left X position on LCD
+ * \param[in]       y: Top left Y position on LCD
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[out]      *buff: Pointer to buffer for pixels, rows are stored one after another without padding
+ * \param[in]       format: Pixel format in buffer. This parameter can be a value of \ref GUI_PixelFormat_t enumeration
+ * \retval          1: Pixels were read
+ * \retval          0: Rectangle is not inside layer or layer format is not supported
+ * \sa              GUI_DRAW_GetPixel
+ */
+uint8_t GUI_DRAW_ReadRect(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, void* buff, GUI_PixelFormat_t format);
+
 /**
  * \brief           Draw vertical line to LCD
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
@@ -264,6 +315,7 @@ void GUI_DRAW_HLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_i
 
 /**
  * \brief           Draw line from point 1 to point 2
+ * \note            Line is clipped to drawing region and drawn with horizontal or vertical runs of pixels
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
  * \param[in]       x1: Line start X position
  * \param[in]       y1: Line start Y position
@@ -306,6 +358,33 @@ void GUI_DRAW_Rectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, G
  */
 void GUI_DRAW_FilledRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color);
 
+/**
+ * \brief           Fill rectangle with linear color gradient
+ * \note            Horizontal gradient renders one line and replicates it with \ref GUI_LL_t.Copy,
+ *                     vertical gradient fills each line with single color
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Top left X position
+ * \param[in]       y: Top left Y position
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       *gradient: Pointer to \ref GUI_Gradient_t structure with gradient colors
+ * \param[in]       dir: Gradient direction. This parameter can be a value of \ref GUI_DRAW_GradientDir_t enumeration
+ * \param[in,out]   *cache: Optional pointer to \ref GUI_DRAW_GradientCache_t structure owned by caller (widget)
+ *                     to keep rendered gradient between redraws. When gradient and size match, redraw is a single copy.
+ *                     Stops array is compared by pointer, reset cache when its content changes. Set to NULL if not used
+ * \retval          None
+ * \sa              GUI_DRAW_GradientCacheFree
+ */
+void GUI_DRAW_FillGradient(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, const GUI_Gradient_t* gradient, GUI_DRAW_GradientDir_t dir, GUI_DRAW_GradientCache_t* cache);
+
+/**
+ * \brief           Release memory of rendered gradient cache
+ * \param[in,out]   *cache: Pointer to \ref GUI_DRAW_GradientCache_t structure to release
+ * \retval          None
+ * \sa              GUI_DRAW_FillGradient
+ */
+void GUI_DRAW_GradientCacheFree(GUI_DRAW_GradientCache_t* cache);
+
 /**
  * \brief           Draw rectangle with rounded corners
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
@@ -431,6 +510,7 @@ void GUI_DRAW_Triangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1,
  * \param[in]       color: Color used for drawing operation
  * \retval          None
  * \sa              GUI_DRAW_Triangle
+ * \sa              GUI_DRAW_FilledPoly
  */
 void GUI_DRAW_FilledTriangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_iDim_t x3, GUI_iDim_t y3, GUI_Color_t color);
 
@@ -454,6 +534,18 @@ void GUI_DRAW_Image(GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, const GUI_I
  */
 void GUI_DRAW_WriteText(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_Char* str, GUI_DRAW_FONT_t* draw);
 
+/**
+ * \brief           Get width of text in single line
+ *
+ *                  Width is sum of advance widths of all characters with kerning corrections.
+ *                  Characters CR and LF are ignored
+ *
+ * \param[in]       *font: Pointer to \ref GUI_FONT_t structure with font to use
+ * \param[in]       *str: Pointer to string to measure
+ * \retval          Text width in units of pixels
+ */
+GUI_iDim_t GUI_DRAW_TextGetWidth(const GUI_FONT_t* font, const GUI_Char* str);
+
 /**
  * \brief           Draw rectangle with 3D view
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
@@ -475,6 +567,22 @@ void GUI_DRAW_Rectangle3D(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y,
  */
 void GUI_DRAW_Poly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, size_t len, GUI_Color_t color);
 
+/**
+ * \brief           Draw filled polygon
+ *
+ *                  Convex and concave polygons are filled with scanline algorithm.
+ *                  Pixel is filled when its center is inside polygon, each scanline is drawn as horizontal lines
+ *
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       *points: Pointer to array of \ref GUI_DRAW_Poly_t polygon points. Last point is connected with first one
+ * \param[in]       len: Number of points in array. There must be at least 3 points
+ * \param[in]       rule: Fill rule for self-intersecting polygons. This parameter can be a value of \ref GUI_DRAW_FillRule_t enumeration
+ * \param[in]       color: Color to use for drawing
+ * \retval          None
+ * \sa              GUI_DRAW_Poly
+ */
+void GUI_DRAW_FilledPoly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, size_t len, GUI_DRAW_FillRule_t rule, GUI_Color_t color);
+
 /**
  * \brief           Initializes \ref GUI_DRAW_SB_t structure for drawing operations
  * \param[in]       *sb: Pointer to \ref GUI_DRAW_SB_t to initialize to default values
@@ -33,7 +33,37 @@
 /***                           Private structures                            **/
 /******************************************************************************/
 /******************************************************************************/
-    
+#ifndef DMA2D_QUEUE_SIZE
+#define DMA2D_QUEUE_SIZE            32              /* Number of commands in DMA2D queue */
+#endif /* DMA2D_QUEUE_SIZE */
+
+/* DMA2D register values for single transfer */
+typedef struct DMA2D_Command_t {
+    uint32_t CR;                                    /*!< Control register with transfer mode */
+    uint32_t FGMAR;                                 /*!< Foreground memory address */
+    uint32_t FGOR;                                  /*!< Foreground line offset */
+    uint32_t BGMAR;                                 /*!< Background memory address */
+    uint32_t BGOR;                                  /*!< Background line offset */
+    uint32_t FGPFCCR;                               /*!< Foreground pixel format and alpha */
+    uint32_t FGCOLR;                                /*!< Foreground color for A8/A4 input */
+    uint32_t BGPFCCR;                               /*!< Background pixel format and alpha */
+    uint32_t OPFCCR;                                /*!< Output pixel format */
+    uint32_t OCOLR;                                 /*!< Output color for register to memory mode */
+    uint32_t OMAR;                                  /*!< Output memory address */
+    uint32_t OOR;                                   /*!< Output line offset */
+    uint32_t NLR;                                   /*!< Number of pixels per line and number of lines */
+} DMA2D_Command_t;
+
+/* Ring of commands, filled by drawing functions and drained by transfer complete interrupt */
+typedef struct DMA2D_Queue_t {
+    DMA2D_Command_t Cmds[DMA2D_QUEUE_SIZE];         /*!< List of commands */
+    volatile uint16_t Head;                         /*!< Index of next free command, modified by drawing functions only */
+    volatile uint16_t Tail;                         /*!< Index of command currently in transfer, modified by interrupt only */
+    volatile uint8_t Busy;                          /*!< Set to 1 when DMA2D is processing command on tail */
+    uint16_t Pending;                               /*!< Number of commands written after head but not yet added to queue */
+    uint8_t Batch;                                  /*!< Set to 1 when commands are added to queue at the end of batch */
+} DMA2D_Queue_t;
+
 /******************************************************************************/
 /******************************************************************************/
 /***                            Private variables                            **/
@@ -43,6 +73,7 @@ GUI_Layer_t Layers[GUI_LAYERS];
 DMA2D_HandleTypeDef DMA2DHandle;
 LTDC_HandleTypeDef LTDCHandle;
 uint16_t startAddress;
+static DMA2D_Queue_t DMA2DQueue;
 
 /******************************************************************************/
 /******************************************************************************/
@@ -51,10 +82,8 @@ uint16_t startAddress;
 /******************************************************************************/
 #define DMA2D_START(type) do {                  \
     startAddress = __LINE__;                    \
-    DMA2D->CR = (type);                         \
-    DMA2D->CR |= 0 | 0; \
-    DMA2D->CR |= DMA2D_CR_START;                \
-    while (DMA2D->CR & DMA2D_CR_START);         \
+    cmd->CR = (type);                           \
+    DMA2D_Submit();                             \
 } while (0)
 
 /******************************************************************************/
@@ -62,6 +91,69 @@ uint16_t startAddress;
 /***                            Private functions                            **/
 /******************************************************************************/
 /******************************************************************************/
+/* Load command on queue tail to DMA2D and start transfer, called with DMA2D interrupt disabled or from interrupt */
+static
+void DMA2D_StartNext(void) {
+    DMA2D_Command_t* cmd;
+    
+    if (DMA2DQueue.Tail == DMA2DQueue.Head) {       /* Nothing to process */
+        DMA2DQueue.Busy = 0;
+        return;
+    }
+    cmd = &DMA2DQueue.Cmds[DMA2DQueue.Tail];
+    DMA2D->FGMAR = cmd->FGMAR;
+    DMA2D->FGOR = cmd->FGOR;
+    DMA2D->BGMAR = cmd->BGMAR;
+    DMA2D->BGOR = cmd->BGOR;
+    DMA2D->FGPFCCR = cmd->FGPFCCR;
+    DMA2D->FGCOLR = cmd->FGCOLR;
+    DMA2D->BGPFCCR = cmd->BGPFCCR;
+    DMA2D->OPFCCR = cmd->OPFCCR;
+    DMA2D->OCOLR = cmd->OCOLR;
+    DMA2D->OMAR = cmd->OMAR;
+    DMA2D->OOR = cmd->OOR;
+    DMA2D->NLR = cmd->NLR;
+    
+    DMA2DQueue.Busy = 1;
+    DMA2D->CR = cmd->CR | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;   /* Start transfer with interrupts */
+}
+
+/* Add pending commands after queue head to queue and start transfer if DMA2D is idle */
+static
+void DMA2D_Flush(void) {
+    if (!DMA2DQueue.Pending) {
+        return;
+    }
+    HAL_NVIC_DisableIRQ(DMA2D_IRQn);                /* Interrupt must not start next transfer at the same time */
+    DMA2DQueue.Head = (DMA2DQueue.Head + DMA2DQueue.Pending) % DMA2D_QUEUE_SIZE;
+    DMA2DQueue.Pending = 0;
+    if (!DMA2DQueue.Busy) {                         /* Start immediately if nothing is in progress */
+        DMA2D_StartNext();
+    }
+    HAL_NVIC_EnableIRQ(DMA2D_IRQn);
+}
+
+/* Get free command after pending commands, wait if queue is full */
+static
+DMA2D_Command_t* DMA2D_GetCommand(void) {
+    DMA2D_Command_t* cmd;
+    
+    while (((DMA2DQueue.Head + DMA2DQueue.Pending + 1) % DMA2D_QUEUE_SIZE) == DMA2DQueue.Tail) {   /* Wait for interrupt to release at least one command */
+        DMA2D_Flush();                              /* Pending commands must be processed first */
+    }
+    cmd = &DMA2DQueue.Cmds[(DMA2DQueue.Head + DMA2DQueue.Pending) % DMA2D_QUEUE_SIZE];
+    memset(cmd, 0x00, sizeof(*cmd));                /* Reset all registers */
+    return cmd;
+}
+
+/* Add command to queue, or keep it pending until the end of batch */
+static
+void DMA2D_Submit(void) {
+    DMA2DQueue.Pending++;
+    if (!DMA2DQueue.Batch) {
+        DMA2D_Flush();
+    }
+}
 
 /******************************************************************************/
 /******************************************************************************/
@@ -81,6 +173,9 @@ void LCD_Init(GUI_LCD_t* LCD) {
     LTDCHandle.Instance = LTDC;
     DMA2DHandle.Instance = DMA2D;
     
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; /* Enable DWT cycle counter for statistics time */
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    
     _LCD_Init();                                    /* Init LCD */
 }
 
@@ -95,7 +190,20 @@ uint32_t GetPixelFormat(GUI_Layer_t* layer) {
 
 static
 uint8_t LCD_Ready(GUI_LCD_t* LCD) {
-    return !(DMA2D->CR & DMA2D_CR_START);           /* Return status */
+    return DMA2DQueue.Head == DMA2DQueue.Tail;      /* Ready when all queued commands are processed */
+}
+
+/* Convert DWT cycle counter to microseconds, must be called at least once per counter overflow */
+static
+uint32_t LCD_GetTime(GUI_LCD_t* LCD) {
+    static uint32_t last, cycles, time;
+    uint32_t now = DWT->CYCCNT, div = SystemCoreClock / 1000000;
+    
+    cycles += now - last;                           /* Add cycles since last call, overflow safe */
+    last = now;
+    time += cycles / div;                           /* Add full microseconds */
+    cycles %= div;                                  /* Keep remaining cycles */
+    return time;
 }
 
 static
@@ -103,25 +211,41 @@ GUI_Color_t LCD_GetPixel(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Di
 #if defined(LCD_COLOR_FORMAT_ARGB8888)
     return *(GUI_Color_t *)(layer->StartAddress + GUI.LCD.PixelSize * (layer->Width * y + x));
 #else
-    GUI_Color_t color;
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait till end */
+    uint32_t p = *(uint16_t *)(layer->StartAddress + GUI.LCD.PixelSize * (layer->Width * y + x));
+    uint32_t r = (p >> 11) & 0x1F, g = (p >> 5) & 0x3F, b = p & 0x1F;
     
-    DMA2D->FGMAR = (uint32_t)(layer->StartAddress + GUI.LCD.PixelSize * (layer->Width * y + x));
-    DMA2D->OMAR = (uint32_t)&color;                 /* Set output address */
-    DMA2D->FGOR = 0;                                /* Set foreground offline */    
-    DMA2D->OOR = 0;                                 /* Set output offline */
-    DMA2D->FGPFCCR = GetPixelFormat(layer);         /* Get source pixel format */
-    DMA2D->OPFCCR = LTDC_PIXEL_FORMAT_ARGB8888;     /* Set output pixel format */
-    DMA2D->NLR = (uint32_t)(1 << 16) | (uint16_t)1; /* Set X and Y */
+    /* Read pixel directly and expand RGB565 to 8 bits per channel, DMA2D transfer per pixel is not needed */
+    return 0xFF000000UL | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+#endif /* defined(LCD_COLOR_FORMAT_ARGB8888) */
+}
 
+/* Read rectangle from layer to buffer with single pixel format conversion transfer */
+static
+void LCD_ReadRect(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t xSize, GUI_Dim_t ySize, void* buff, GUI_PixelFormat_t format) {
+    DMA2D_Command_t* cmd;
+    
+    cmd = DMA2D_GetCommand();                       /* Get free command from queue */
+    cmd->FGMAR = (uint32_t)(layer->StartAddress + LCD->PixelSize * (layer->Width * y + x));
+    cmd->OMAR = (uint32_t)buff;                     /* Set output address */
+    cmd->FGOR = layer->Width - xSize;               /* Set foreground offline */
+    cmd->OOR = 0;                                   /* Buffer rows are without padding */
+    cmd->FGPFCCR = GetPixelFormat(layer);           /* Get source pixel format */
+    if (format == GUI_PixelFormat_RGB888) {         /* Set output pixel format */
+        cmd->OPFCCR = DMA2D_OUTPUT_RGB888;
+    } else if (format == GUI_PixelFormat_RGB565) {
+        cmd->OPFCCR = DMA2D_OUTPUT_RGB565;
+    } else {
+        cmd->OPFCCR = DMA2D_OUTPUT_ARGB8888;
+    }
+    cmd->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+    
     DMA2D_START(DMA2D_M2M_PFC);                     /* Start DMA2D transfer */
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait till end */
-    return 0xFF000000UL | color;
-#endif /* defined(LCD_COLOR_FORMAT_ARGB8888) */
+    while (!LCD_Ready(LCD));                        /* Wait till end, data must be in buffer on return */
 }
 
 static
 void LCD_Fill(GUI_LCD_t* LCD, GUI_Layer_t* layer, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t OffLine, GUI_Color_t color) {
+    DMA2D_Command_t* cmd;
 #if LCD_PIXEL_SIZE == 2
     uint8_t r, g, b;
 //    r = (color >> 20) & 0x0F;
@@ -136,12 +260,12 @@ void LCD_Fill(GUI_LCD_t* LCD, GUI_Layer_t* layer, void* dst, GUI_Dim_t xSize, GU
     if (!xSize || !ySize) {
         return;
     }
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->OCOLR = color;                           /* Color to be used */
-    DMA2D->OMAR = (uint32_t)dst;                    /* Destination address */
-    DMA2D->OOR = OffLine;                           /* Destination line offset */
-    DMA2D->OPFCCR = GetPixelFormat(layer);          /* Defines the number of pixels to be transfered */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; /* Size configuration of area to be transfered */
+    cmd = DMA2D_GetCommand();                       /* Get free command from queue */
+    cmd->OCOLR = color;                             /* Color to be used */
+    cmd->OMAR = (uint32_t)dst;                      /* Destination address */
+    cmd->OOR = OffLine;                             /* Destination line offset */
+    cmd->OPFCCR = GetPixelFormat(layer);            /* Defines the number of pixels to be transfered */
+    cmd->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;   /* Size configuration of area to be transfered */
     
     DMA2D_START(DMA2D_R2M);                         /* Start DMA2D transfer */
 }
@@ -149,21 +273,22 @@ void LCD_Fill(GUI_LCD_t* LCD, GUI_Layer_t* layer, void* dst, GUI_Dim_t xSize, GU
 static
 void LCD_Copy(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
     uint32_t PixelFormat = GetPixelFormat(layer);
+    DMA2D_Command_t* cmd;
     
     if (!xSize || !ySize) {
         return;
     }
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;
-    DMA2D->FGPFCCR = PixelFormat;
-    DMA2D->BGPFCCR = PixelFormat;
-    DMA2D->OPFCCR = PixelFormat;
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+    cmd = DMA2D_GetCommand();                       /* Get free command from queue */
+    cmd->FGMAR = (uint32_t)src;
+    cmd->BGMAR = (uint32_t)dst;
+    cmd->OMAR = (uint32_t)dst;
+    cmd->FGOR = offLineSrc;
+    cmd->BGOR = offLineDst;
+    cmd->OOR = offLineDst;
+    cmd->FGPFCCR = PixelFormat;
+    cmd->BGPFCCR = PixelFormat;
+    cmd->OPFCCR = PixelFormat;
+    cmd->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
     
     DMA2D_START(DMA2D_M2M);                         /* Start DMA2D transfer */
 }
@@ -172,21 +297,23 @@ void LCD_Copy(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void* dst, GU
 static
 void LCD_CopyBlending(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void* dst, uint8_t alphaSrc, uint8_t alphaDst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
     uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;                       
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;
-    DMA2D->FGPFCCR = PixelFormat;                   /* Foreground PFC Control Register */
-    DMA2D->BGPFCCR = PixelFormat;                   /* Background PFC Control Register (Defines the BG pixel format) */
-    DMA2D->OPFCCR  = PixelFormat;                   /* Output     PFC Control Register (Defines the output pixel format) */
-    
-    DMA2D->FGPFCCR |= DMA2D_FGPFCCR_AM_0 | alphaSrc << 24;               /* Set alpha for source */
-    DMA2D->BGPFCCR |= alphaDst << 24;               /* Set alpha for destination */
-    
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+    DMA2D_Command_t* cmd;
+    
+    cmd = DMA2D_GetCommand();                       /* Get free command from queue */
+    cmd->FGMAR = (uint32_t)src;
+    cmd->BGMAR = (uint32_t)dst;                       
+    cmd->OMAR = (uint32_t)dst;
+    cmd->FGOR = offLineSrc;
+    cmd->BGOR = offLineDst;
+    cmd->OOR = offLineDst;
+    cmd->FGPFCCR = PixelFormat;                     /* Foreground PFC Control Register */
+    cmd->BGPFCCR = PixelFormat;                     /* Background PFC Control Register (Defines the BG pixel format) */
+    cmd->OPFCCR  = PixelFormat;                     /* Output     PFC Control Register (Defines the output pixel format) */
+    
+    cmd->FGPFCCR |= DMA2D_FGPFCCR_AM_0 | alphaSrc << 24;                 /* Set alpha for source */
+    cmd->BGPFCCR |= alphaDst << 24;                 /* Set alpha for destination */
+    
+    cmd->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
     
     DMA2D_START(DMA2D_M2M_BLEND);                   /* Start DMA2D transfer */
 }
@@ -194,25 +321,26 @@ void LCD_CopyBlending(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void*
 static
 void LCD_DrawImage16(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t* img, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
     uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
+    DMA2D_Command_t* cmd;
     if (!xSize || !ySize) {
         return;
     }
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;                       
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;
-    DMA2D->FGPFCCR = DMA2D_INPUT_RGB565;            /* Foreground PFC Control Register */
-    DMA2D->BGPFCCR = PixelFormat;                   /* Background PFC Control Register (Defines the BG pixel format) */
-    DMA2D->OPFCCR  = PixelFormat;                   /* Output     PFC Control Register (Defines the output pixel format) */
+    cmd = DMA2D_GetCommand();                       /* Get free command from queue */
+    cmd->FGMAR = (uint32_t)src;
+    cmd->BGMAR = (uint32_t)dst;                       
+    cmd->OMAR = (uint32_t)dst;
+    cmd->FGOR = offLineSrc;
+    cmd->BGOR = offLineDst;
+    cmd->OOR = offLineDst;
+    cmd->FGPFCCR = DMA2D_INPUT_RGB565;              /* Foreground PFC Control Register */
+    cmd->BGPFCCR = PixelFormat;                     /* Background PFC Control Register (Defines the BG pixel format) */
+    cmd->OPFCCR  = PixelFormat;                     /* Output     PFC Control Register (Defines the output pixel format) */
     
     /* Enable invert alpha and swap R and B values with hardware */
 #if defined(DMA2D_FGPFCCR_AI) && defined(DMA2D_FGPFCCR_RBS)
-    DMA2D->FGPFCCR |= DMA2D_FGPFCCR_RBS;
+    cmd->FGPFCCR |= DMA2D_FGPFCCR_RBS;
 #endif  /* defined(DMA2D_FGPFCCR_AM_1) */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; 
+    cmd->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; 
     
     DMA2D_START(DMA2D_M2M_BLEND);                   /* Start DMA2D transfer */
 }
@@ -220,22 +348,24 @@ void LCD_DrawImage16(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t*
 static
 void LCD_DrawImage24(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t* img, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
     uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;                       
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;
-    DMA2D->FGPFCCR = DMA2D_INPUT_RGB888;            /* Foreground PFC Control Register */
-    DMA2D->BGPFCCR = PixelFormat;                   /* Background PFC Control Register (Defines the BG pixel format) */
-    DMA2D->OPFCCR  = PixelFormat;                   /* Output     PFC Control Register (Defines the output pixel format) */
+    DMA2D_Command_t* cmd;
+    
+    cmd = DMA2D_GetCommand();                       /* Get free command from queue */
+    cmd->FGMAR = (uint32_t)src;
+    cmd->BGMAR = (uint32_t)dst;                       
+    cmd->OMAR = (uint32_t)dst;
+    cmd->FGOR = offLineSrc;
+    cmd->BGOR = offLineDst;
+    cmd->OOR = offLineDst;
+    cmd->FGPFCCR = DMA2D_INPUT_RGB888;              /* Foreground PFC Control Register */
+    cmd->BGPFCCR = PixelFormat;                     /* Background PFC Control Register (Defines the BG pixel format) */
+    cmd->OPFCCR  = PixelFormat;                     /* Output     PFC Control Register (Defines the output pixel format) */
     
     /* Enable invert alpha and swap R and B values with hardware */
 #if defined(DMA2D_FGPFCCR_RBS)
-    DMA2D->FGPFCCR |= DMA2D_FGPFCCR_RBS;
+    cmd->FGPFCCR |= DMA2D_FGPFCCR_RBS;
 #endif  /* defined(DMA2D_FGPFCCR_AM_1) */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+    cmd->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
     
     DMA2D_START(DMA2D_M2M_BLEND);                   /* Start DMA2D transfer */
 }
@@ -243,22 +373,24 @@ void LCD_DrawImage24(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t*
 static
 void LCD_DrawImage32(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t* img, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
     uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;                       
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;
-    DMA2D->FGPFCCR = DMA2D_INPUT_ARGB8888;          /* Foreground PFC Control Register */
-    DMA2D->BGPFCCR = PixelFormat;                   /* Background PFC Control Register (Defines the BG pixel format) */
-    DMA2D->OPFCCR  = PixelFormat;                   /* Output     PFC Control Register (Defines the output pixel format) */
+    DMA2D_Command_t* cmd;
+    
+    cmd = DMA2D_GetCommand();                       /* Get free command from queue */
+    cmd->FGMAR = (uint32_t)src;
+    cmd->BGMAR = (uint32_t)dst;                       
+    cmd->OMAR = (uint32_t)dst;
+    cmd->FGOR = offLineSrc;
+    cmd->BGOR = offLineDst;
+    cmd->OOR = offLineDst;
+    cmd->FGPFCCR = DMA2D_INPUT_ARGB8888;            /* Foreground PFC Control Register */
+    cmd->BGPFCCR = PixelFormat;                     /* Background PFC Control Register (Defines the BG pixel format) */
+    cmd->OPFCCR  = PixelFormat;                     /* Output     PFC Control Register (Defines the output pixel format) */
     
     /* Enable invert alpha and swap R and B values with hardware */
 #if defined(DMA2D_FGPFCCR_AI) && defined(DMA2D_FGPFCCR_RBS)
-    DMA2D->FGPFCCR |= DMA2D_FGPFCCR_AI | DMA2D_FGPFCCR_RBS;
+    cmd->FGPFCCR |= DMA2D_FGPFCCR_AI | DMA2D_FGPFCCR_RBS;
 #endif  /* defined(DMA2D_FGPFCCR_AM_1) */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+    cmd->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
     
     DMA2D_START(DMA2D_M2M_BLEND);                   /* Start DMA2D transfer */
 }
@@ -266,22 +398,23 @@ void LCD_DrawImage32(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t*
 static
 void LCD_CopyChar(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst, GUI_Color_t color) {
     uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
+    DMA2D_Command_t* cmd;
     
     if (!xSize || !ySize) {
         return;
     }
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;                       
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;  
-    DMA2D->FGCOLR = color & 0x00FFFFFFUL;           /* Since foreground input color is A4, value in this register will be used for blending purpose */
-    DMA2D->FGPFCCR = DMA2D_INPUT_A8;                /* Foreground PFC Control Register */
-    DMA2D->BGPFCCR = PixelFormat;                   /* Background PFC Control Register (Defines the BG pixel format) */
-    DMA2D->OPFCCR  = PixelFormat;                   /* Output     PFC Control Register (Defines the output pixel format) */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; 
+    cmd = DMA2D_GetCommand();                       /* Get free command from queue */
+    cmd->FGMAR = (uint32_t)src;
+    cmd->BGMAR = (uint32_t)dst;                       
+    cmd->OMAR = (uint32_t)dst;
+    cmd->FGOR = offLineSrc;
+    cmd->BGOR = offLineDst;
+    cmd->OOR = offLineDst;  
+    cmd->FGCOLR = color & 0x00FFFFFFUL;             /* Since foreground input color is A4, value in this register will be used for blending purpose */
+    cmd->FGPFCCR = DMA2D_INPUT_A8;                  /* Foreground PFC Control Register */
+    cmd->BGPFCCR = PixelFormat;                     /* Background PFC Control Register (Defines the BG pixel format) */
+    cmd->OPFCCR  = PixelFormat;                     /* Output     PFC Control Register (Defines the output pixel format) */
+    cmd->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; 
     
     DMA2D_START(DMA2D_M2M_BLEND);                   /* Start DMA2D transfer */
     
@@ -326,9 +459,70 @@ void LCD_SetPixel(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y,
     LCD_DrawHLine(LCD, layer, x, y, 1, color);
 }
 
-/* Process DMA2D interrupt */
+/* Execute batch of commands, register sets are prepared in queue and added to DMA2D chain at once */
+static
+void LCD_DrawBatch(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_LL_Cmd_t* cmds, size_t count) {
+    GUI_LL_Cmd_t fill;
+    size_t i;
+    
+    DMA2DQueue.Batch = 1;
+    for (i = 0; i < count; i++) {
+        const GUI_LL_Cmd_t* c = &cmds[i];
+        switch (c->Type) {
+            case GUI_LL_CmdType_Fill:
+                /**
+                 * Fills of the same color and width directly below each other,
+                 * such as rows of filled shape, are merged to single transfer
+                 */
+                fill = *c;
+                while (i + 1 < count && cmds[i + 1].Type == GUI_LL_CmdType_Fill
+                    && cmds[i + 1].Color == fill.Color && cmds[i + 1].XSize == fill.XSize && cmds[i + 1].OffLineDst == fill.OffLineDst
+                    && (uint8_t *)cmds[i + 1].Dst == (uint8_t *)fill.Dst + (uint32_t)fill.YSize * (fill.XSize + fill.OffLineDst) * LCD->PixelSize) {
+                    fill.YSize += cmds[++i].YSize;
+                }
+                LCD_Fill(LCD, layer, fill.Dst, fill.XSize, fill.YSize, fill.OffLineDst, fill.Color);
+                break;
+            case GUI_LL_CmdType_Copy:
+                LCD_Copy(LCD, layer, c->Src, c->Dst, c->XSize, c->YSize, c->OffLineSrc, c->OffLineDst);
+                break;
+            case GUI_LL_CmdType_CopyBlend:
+                LCD_CopyBlending(LCD, layer, c->Src, c->Dst, c->AlphaSrc, c->AlphaDst, c->XSize, c->YSize, c->OffLineSrc, c->OffLineDst);
+                break;
+            case GUI_LL_CmdType_CopyChar:
+                LCD_CopyChar(LCD, layer, c->Src, c->Dst, c->XSize, c->YSize, c->OffLineSrc, c->OffLineDst, c->Color);
+                break;
+            case GUI_LL_CmdType_DrawImage:
+                if (c->Img->BPP == 16) {
+                    LCD_DrawImage16(LCD, layer, c->Img, c->Src, c->Dst, c->XSize, c->YSize, c->OffLineSrc, c->OffLineDst);
+                } else if (c->Img->BPP == 24) {
+                    LCD_DrawImage24(LCD, layer, c->Img, c->Src, c->Dst, c->XSize, c->YSize, c->OffLineSrc, c->OffLineDst);
+                } else {
+                    LCD_DrawImage32(LCD, layer, c->Img, c->Src, c->Dst, c->XSize, c->YSize, c->OffLineSrc, c->OffLineDst);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    DMA2DQueue.Batch = 0;
+    DMA2D_Flush();                                  /* Add all transfers to DMA2D chain */
+}
+
+/* Process DMA2D interrupt, release finished command and start next one in queue */
 void DMA2D_IRQHandler(void) {
-    HAL_DMA2D_IRQHandler(&DMA2DHandle);
+    uint32_t isr = DMA2D->ISR;
+    
+    if (isr & (DMA2D_ISR_TEIF | DMA2D_ISR_CEIF)) {  /* Check for transfer or configuration error */
+        DMA2D->IFCR = DMA2D_IFCR_CTEIF | DMA2D_IFCR_CCEIF;
+        if (DMA2DHandle.XferErrorCallback) {
+            DMA2DHandle.XferErrorCallback(&DMA2DHandle);
+        }
+    }
+    if (isr & DMA2D_ISR_TCIF) {                     /* Transfer complete */
+        DMA2D->IFCR = DMA2D_IFCR_CTCIF;
+        DMA2DQueue.Tail = (DMA2DQueue.Tail + 1) % DMA2D_QUEUE_SIZE;
+        DMA2D_StartNext();                          /* Start next command if available */
+    }
 }
 
 void TransferErrorCallback(DMA2D_HandleTypeDef* hdma2d) {
@@ -412,6 +606,9 @@ uint8_t GUI_LL_Control(GUI_LCD_t* LCD, GUI_LL_Command_t cmd, void* param, void*
             LL->DrawImage24 = LCD_DrawImage24;  /* Set draw function for 24bit image (RGB888) format */
             LL->DrawImage32 = LCD_DrawImage32;  /* Set draw function for 32bit image (ARGB8888/ABGR8888) format */
             LL->CopyChar = LCD_CopyChar;        /* Set draw function for char copy with alpha information */
+            LL->DrawBatch = LCD_DrawBatch;      /* Set function for batch of commands */
+            LL->ReadRect = LCD_ReadRect;        /* Set function for reading rectangle with format conversion */
+            LL->GetTime = LCD_GetTime;          /* Set time function for statistics */
             
             if (result) {
                 *(uint8_t *)result = 0;         /* Successful initialization */
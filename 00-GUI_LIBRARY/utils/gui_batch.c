@@ -0,0 +1,116 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_batch.h"
+
+#if GUI_LL_BATCH_SIZE
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+static GUI_LL_Cmd_t Cmds[GUI_LL_BATCH_SIZE];       /* Collected commands */
+static size_t Count;                                /* Number of collected commands */
+static GUI_Layer_t* Layer;                          /* Target layer of collected commands */
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Get next free command for drawing layer, flush batch first if needed */
+static
+GUI_LL_Cmd_t* __Add(GUI_LL_CmdType_t type) {
+    GUI_LL_Cmd_t* cmd;
+    
+    if (Count == GUI_LL_BATCH_SIZE || (Count && Layer != GUI.LCD.DrawingLayer)) {
+        __GUI_BATCH_Flush();
+    }
+    Layer = GUI.LCD.DrawingLayer;
+    cmd = &Cmds[Count++];
+    memset(cmd, 0x00, sizeof(*cmd));
+    cmd->Type = type;
+    return cmd;
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+void __GUI_BATCH_Fill(GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color) {
+    GUI_LL_Cmd_t* cmd;
+    
+    if (!GUI.LL.DrawBatch) {                        /* Driver does not support batches */
+        GUI.LL.FillRect(&GUI.LCD, GUI.LCD.DrawingLayer, x, y, width, height, color);
+        return;
+    }
+    cmd = __Add(GUI_LL_CmdType_Fill);
+    cmd->Dst = (void *)(GUI.LCD.DrawingLayer->StartAddress + ((size_t)y * GUI.LCD.DrawingLayer->Width + x) * GUI.LCD.PixelSize);
+    cmd->XSize = width;
+    cmd->YSize = height;
+    cmd->OffLineDst = GUI.LCD.DrawingLayer->Width - width;
+    cmd->Color = color;
+}
+
+void __GUI_BATCH_CopyChar(const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst, GUI_Color_t color) {
+    GUI_LL_Cmd_t* cmd;
+    
+    if (!GUI.LL.DrawBatch) {                        /* Driver does not support batches */
+        GUI.LL.CopyChar(&GUI.LCD, GUI.LCD.DrawingLayer, src, dst, xSize, ySize, offLineSrc, offLineDst, color);
+        return;
+    }
+    cmd = __Add(GUI_LL_CmdType_CopyChar);
+    cmd->Src = src;
+    cmd->Dst = dst;
+    cmd->XSize = xSize;
+    cmd->YSize = ySize;
+    cmd->OffLineSrc = offLineSrc;
+    cmd->OffLineDst = offLineDst;
+    cmd->Color = color;
+}
+
+void __GUI_BATCH_Flush(void) {
+    if (Count) {
+        GUI.LL.DrawBatch(&GUI.LCD, Layer, Cmds, Count);
+        Count = 0;
+    }
+}
+
+#endif /* GUI_LL_BATCH_SIZE */
@@ -0,0 +1,118 @@
+/**
+ * \author  Tilen Majerle <tilen@majerle.eu>
+ * \brief   Batched submission of low-level drawing commands
+ *  
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2017 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software, 
+    and to permit persons to whom the Software is furnished to do so, 
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GUI_BATCH_H
+#define GUI_BATCH_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_UTILS
+ * \{
+ */
+#include "gui_utils.h"
+
+/**
+ * \defgroup        GUI_BATCH Drawing batch
+ * \brief           Batched submission of low-level drawing commands
+ * \{
+ *
+ * Primitives made of many small operations, such as text, lines and filled shapes,
+ * collect their commands in array of \ref GUI_LL_Cmd_t and pass them to \ref GUI_LL_t.DrawBatch at once.
+ *
+ * Commands are collected only when driver sets \ref GUI_LL_t.DrawBatch, otherwise they are executed immediately.
+ * Batch is flushed when it is full, when drawing layer changes, by \ref __GUI_LL_FENCE and at the end of each primitive.
+ * Number of commands in batch is set with \ref GUI_LL_BATCH_SIZE.
+ */
+
+#if defined(GUI_INTERNAL) || defined(DOXYGEN)
+
+#if GUI_LL_BATCH_SIZE || defined(DOXYGEN)
+
+/**
+ * \brief           Add fill of rectangle on drawing layer to batch
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       x: Top left X position relative to drawing layer
+ * \param[in]       y: Top left Y position relative to drawing layer
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       color: Fill color
+ * \retval          None
+ */
+void __GUI_BATCH_Fill(GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color);
+
+/**
+ * \brief           Add copy of A8 character with color to batch
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \note            Source memory must stay valid until batch is flushed
+ * \param[in]       *src: Pointer to 8-bit alpha values
+ * \param[in]       *dst: Pointer to destination on drawing layer
+ * \param[in]       xSize: Area width
+ * \param[in]       ySize: Area height
+ * \param[in]       offLineSrc: Source line offset
+ * \param[in]       offLineDst: Destination line offset
+ * \param[in]       color: Character color
+ * \retval          None
+ */
+void __GUI_BATCH_CopyChar(const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst, GUI_Color_t color);
+
+/**
+ * \brief           Send collected commands to low-level driver
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \retval          None
+ */
+void __GUI_BATCH_Flush(void);
+
+#else
+#define __GUI_BATCH_Fill(x, y, width, height, color)    GUI.LL.FillRect(&GUI.LCD, GUI.LCD.DrawingLayer, x, y, width, height, color)
+#define __GUI_BATCH_CopyChar(src, dst, xSize, ySize, offLineSrc, offLineDst, color) \
+    GUI.LL.CopyChar(&GUI.LCD, GUI.LCD.DrawingLayer, src, dst, xSize, ySize, offLineSrc, offLineDst, color)
+#define __GUI_BATCH_Flush()
+#endif /* GUI_LL_BATCH_SIZE || defined(DOXYGEN) */
+
+#endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,227 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_glyph.h"
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+#define GLYPH_HASH_BITS             7               /* Number of bits for hash table index */
+#define GLYPH_HASH_SIZE             (1 << GLYPH_HASH_BITS)  /* Number of buckets in hash table */
+
+#define __GetEntryData(e)           ((uint8_t *)(e) + sizeof(GUI_FONT_CharEntry_t))
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+static GUI_FONT_CharEntry_t* Table[GLYPH_HASH_SIZE];/* Hash table of cached characters */
+static GUI_FONT_CharEntry_t* Newest;                /* Most recently used character */
+static GUI_FONT_CharEntry_t* Oldest;                /* Least recently used character */
+static size_t CacheSize;                            /* Number of bytes used by cached characters */
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Get hash table index for font and character */
+static
+uint32_t __GetHash(const GUI_FONT_t* font, uint32_t ch) {
+    uint32_t hash = (uint32_t)((uintptr_t)font >> 2) ^ ch;
+    hash *= (uint32_t)0x9E3779B1;                   /* Multiplicative hashing, top bits are used as index */
+    return hash >> (32 - GLYPH_HASH_BITS);
+}
+
+/* Remove entry from list of used entries */
+static
+void __UnlinkEntry(GUI_FONT_CharEntry_t* e) {
+    if (e->Newer) {
+        e->Newer->Older = e->Older;
+    } else {
+        Newest = e->Older;
+    }
+    if (e->Older) {
+        e->Older->Newer = e->Newer;
+    } else {
+        Oldest = e->Newer;
+    }
+}
+
+/* Put entry to the top of list of used entries */
+static
+void __LinkEntry(GUI_FONT_CharEntry_t* e) {
+    e->Newer = NULL;
+    e->Older = Newest;
+    if (Newest) {
+        Newest->Newer = e;
+    } else {
+        Oldest = e;
+    }
+    Newest = e;
+}
+
+/* Remove entry from cache and free its memory, low-level must not use it anymore */
+static
+void __FreeEntry(GUI_FONT_CharEntry_t* e) {
+    GUI_FONT_CharEntry_t** pp;
+    
+    for (pp = &Table[__GetHash(e->Font, e->Ch)]; *pp != e; pp = &(*pp)->Next) {}
+    *pp = e->Next;                                  /* Remove from hash bucket */
+    __UnlinkEntry(e);
+    CacheSize -= e->Size;
+    __GUI_MEMFREE(e);
+}
+
+/* Convert character from font to 8-bit alpha values */
+static
+void __ConvertChar(const GUI_FONT_t* font, const GUI_FONT_CharInfo_t* c, uint8_t* ptr) {
+    uint16_t columns, i, x;
+    uint8_t b, k, t;
+    
+    if (font->Flags & GUI_FLAG_FONT_AA) {           /* Anti-alliased font */
+        columns = c->xSize >> 2;                    /* Calculate number of bytes used for single character line */
+        if (c->xSize % 4) {                         /* If only 1 column used */
+            columns++;
+        }
+        x = 0;
+        for (i = 0; i < c->ySize * columns; i++) {  /* Inspect all vertical lines */
+            b = c->Data[i];                         /* Get byte of data */
+            for (k = 0; k < 4; k++) {               /* Scan each bit in byte */
+                t = (b >> (6 - 2 * k)) & 0x03;      /* Get temporary bits on bottom */
+                switch (t) {
+                    case 0:
+                        *ptr |= 0x00;
+                        break;
+                    case 1:
+                        *ptr |= 0x55;
+                        break;
+                    case 2:
+                        *ptr |= 0xAA;
+                        break;
+                    default:
+                        *ptr |= 0xFF;
+                }
+                ptr++;
+                x++;
+                if (x == c->xSize) {
+                    x = 0;
+                    break;
+                }
+            }
+        }
+    } else {
+        columns = c->xSize >> 3;                    /* Calculate number of bytes used for single character line */
+        if (c->xSize % 8) {                         /* If only 1 column used */
+            columns++;
+        }
+        x = 0;
+        for (i = 0; i < c->ySize * columns; i++) {  /* Inspect all vertical lines */
+            b = c->Data[i];                         /* Get byte of data */
+            for (k = 0; k < 8; k++) {               /* Scan each bit in byte */
+                if ((b >> (7 - k)) & 0x01) {
+                    *ptr++ = 0xFF;
+                } else {
+                    *ptr++ = 0x00;
+                }
+                x++;
+                if (x == c->xSize) {
+                    x = 0;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+const uint8_t* __GUI_GLYPH_Get(const GUI_FONT_t* font, uint32_t ch, const GUI_FONT_CharInfo_t* c) {
+    GUI_FONT_CharEntry_t* e;
+    GUI_FONT_CharEntry_t** bucket = &Table[__GetHash(font, ch)];
+    size_t size = sizeof(*e) + (size_t)c->xSize * (size_t)c->ySize;
+    
+    if (size > GUI_GLYPH_CACHE_SIZE) {              /* Character can never fit to cache */
+        return NULL;
+    }
+    for (e = *bucket; e; e = e->Next) {             /* Search for character in bucket */
+        if (e->Font == font && e->Ch == ch) {
+            if (e != Newest) {                      /* Mark entry as most recently used */
+                __UnlinkEntry(e);
+                __LinkEntry(e);
+            }
+            __GUI_STATS_INC(GlyphCacheHits);
+            return __GetEntryData(e);
+        }
+    }
+    __GUI_STATS_INC(GlyphCacheMisses);
+    
+    /**
+     * Low-level may still copy characters from entries we are going to free.
+     * Wait once for all operations and then free as many entries as needed
+     */
+    if (CacheSize + size > GUI_GLYPH_CACHE_SIZE) {
+        __GUI_LL_FENCE();
+        while (Oldest && CacheSize + size > GUI_GLYPH_CACHE_SIZE) {
+            __FreeEntry(Oldest);
+        }
+    }
+    
+    e = __GUI_MEMALLOC(size);                       /* Allocate memory for entry and alpha values */
+    if (!e && Oldest) {                             /* Free cache to get memory for drawing */
+        __GUI_LL_FENCE();
+        while (Oldest) {
+            __FreeEntry(Oldest);
+        }
+        e = __GUI_MEMALLOC(size);
+    }
+    if (!e) {
+        return NULL;
+    }
+    
+    e->Font = font;
+    e->Ch = ch;
+    e->Size = size;
+    __ConvertChar(font, c, __GetEntryData(e));      /* Memory is cleared after allocation */
+    
+    e->Next = *bucket;                              /* Add entry to hash bucket */
+    *bucket = e;
+    __LinkEntry(e);
+    CacheSize += size;
+    return __GetEntryData(e);
+}
@@ -0,0 +1,89 @@
+/**
+ * \author  Tilen Majerle <tilen@majerle.eu>
+ * \brief   Glyph cache for character drawing
+ *  
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2017 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software, 
+    and to permit persons to whom the Software is furnished to do so, 
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GUI_GLYPH_H
+#define GUI_GLYPH_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_UTILS
+ * \{
+ */
+#include "gui_utils.h"
+
+/**
+ * \defgroup        GUI_GLYPH Glyph cache
+ * \brief           Cache of characters prepared for copy with alpha
+ * \{
+ *
+ * Character from font is converted to 8-bit alpha values before it is drawn with \ref GUI_LL_t.CopyChar.
+ * Converted characters are kept in RAM and found by font and character code with hash table.
+ *
+ * Memory used by cache is limited with \ref GUI_GLYPH_CACHE_SIZE.
+ * Least recently used characters are freed when limit is reached.
+ * Number of cache hits and misses is counted in \ref GUI_STATS_t statistics.
+ */
+
+#if defined(GUI_INTERNAL) || defined(DOXYGEN)
+
+/**
+ * \brief           Get character alpha values for fast drawing operations
+ *
+ *                  Character is converted and added to cache if not there yet
+ *
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       *font: Pointer to \ref GUI_FONT_t font structure
+ * \param[in]       ch: Character code
+ * \param[in]       *c: Pointer to \ref GUI_FONT_CharInfo_t character information for character code
+ * \retval          > 0: Pointer to 8-bit alpha values, one byte per pixel
+ * \retval          0: Memory allocation failed
+ */
+const uint8_t* __GUI_GLYPH_Get(const GUI_FONT_t* font, uint32_t ch, const GUI_FONT_CharInfo_t* c);
+
+#endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
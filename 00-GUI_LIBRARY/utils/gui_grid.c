@@ -0,0 +1,361 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_grid.h"
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+#define RECT_IS_EMPTY(r)            ((r)->X1 >= (r)->X2 || (r)->Y1 >= (r)->Y2)
+#define RECT_IS_INVERTED(r)         ((r)->X1 > (r)->X2 || (r)->Y1 > (r)->Y2)
+#define RECT_INTERSECTS(a, b)       ((a)->X1 < (b)->X2 && (b)->X1 < (a)->X2 && (a)->Y1 < (b)->Y2 && (b)->Y1 < (a)->Y2)
+#define RECT_SET_INVERTED(r)        do { (r)->X1 = (r)->Y1 = 0; (r)->X2 = (r)->Y2 = -1; } while (0)
+#define GRID_MAX_SIDE               64              /* Maximal number of columns or rows */
+#define GRID_CELL_FREE(used)        ((used) / 2 + 2)    /* Free references in cell for moved widgets */
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/**
+ * Get range of cells for rectangle.
+ * Right and bottom edges are included as touch on edge hits the widget
+ */
+static
+uint8_t __GetCells(const GUI_Grid_t* grid, const GUI_Display_t* r, size_t* c1, size_t* r1, size_t* c2, size_t* r2) {
+    GUI_iDim_t x1 = r->X1 - grid->X, y1 = r->Y1 - grid->Y;
+    GUI_iDim_t x2 = r->X2 - grid->X, y2 = r->Y2 - grid->Y;
+    
+    if (RECT_IS_INVERTED(r)) {
+        return 0;                                   /* Rectangle is not indexed */
+    }
+    if (x2 < 0 || y2 < 0 || x1 >= (GUI_iDim_t)(grid->Cols * grid->CellWidth) || y1 >= (GUI_iDim_t)(grid->Rows * grid->CellHeight)) {
+        return 0;                                   /* Rectangle is outside grid */
+    }
+    *c1 = x1 < 0 ? 0 : (size_t)(x1 / grid->CellWidth);
+    *r1 = y1 < 0 ? 0 : (size_t)(y1 / grid->CellHeight);
+    *c2 = __GUI_MIN((size_t)(x2 / grid->CellWidth), grid->Cols - 1);
+    *r2 = __GUI_MIN((size_t)(y2 / grid->CellHeight), grid->Rows - 1);
+    return 1;
+}
+
+/* Remove item from all cells of its rectangle */
+static
+void __RemoveRefs(GUI_Grid_t* grid, size_t index) {
+    size_t c, r, c1, r1, c2, r2, k, cell;
+    
+    if (!__GetCells(grid, &grid->Rects[index], &c1, &r1, &c2, &r2)) {
+        return;
+    }
+    for (r = r1; r <= r2; r++) {
+        for (c = c1; c <= c2; c++) {
+            size_t* refs;
+            cell = r * grid->Cols + c;
+            refs = &grid->Refs[grid->Cells[cell]];
+            for (k = 0; k < grid->Used[cell]; k++) {
+                if (refs[k] == index) {             /* Remove reference and keep order of others */
+                    grid->Used[cell]--;
+                    memmove(&refs[k], &refs[k + 1], (grid->Used[cell] - k) * sizeof(*refs));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/* Add item to all cells of its rectangle, references in each cell stay sorted from bottom to top item */
+static
+uint8_t __AddRefs(GUI_Grid_t* grid, size_t index) {
+    size_t c, r, c1, r1, c2, r2, k, cell;
+    
+    if (!__GetCells(grid, &grid->Rects[index], &c1, &r1, &c2, &r2)) {
+        return 1;
+    }
+    for (r = r1; r <= r2; r++) {
+        for (c = c1; c <= c2; c++) {
+            size_t* refs;
+            cell = r * grid->Cols + c;
+            if (grid->Cells[cell] + grid->Used[cell] >= grid->Cells[cell + 1]) {
+                grid->Valid = 0;                    /* Cell is full, index must be built again */
+                return 0;
+            }
+            refs = &grid->Refs[grid->Cells[cell]];
+            for (k = grid->Used[cell]; k > 0 && refs[k - 1] > index; k--) {
+                refs[k] = refs[k - 1];
+            }
+            refs[k] = index;
+            grid->Used[cell]++;
+        }
+    }
+    return 1;
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+uint8_t __GUI_GRID_Reserve(GUI_Grid_t* grid, size_t count) {
+    grid->Valid = 0;
+    grid->Count = 0;
+    grid->DirtyCount = 0;
+    if (count > grid->Size) {
+        uint8_t* mem;
+        size_t size = count + count / 4;            /* Allocate some more for new widgets */
+        
+        if (grid->Items) {
+            __GUI_MEMFREE(grid->Items);
+        }
+        grid->Size = 0;
+        
+        /* Use one memory block for all arrays, sorted by alignment requirements */
+        mem = __GUI_MEMALLOC(size * (sizeof(*grid->Items) + sizeof(*grid->Found) + sizeof(*grid->Dirty) + sizeof(*grid->Marks) + sizeof(*grid->Rects)));
+        if (!mem) {
+            return 0;
+        }
+        grid->Items = (GUI_HANDLE_p *)mem;
+        grid->Found = (size_t *)(mem + size * sizeof(*grid->Items));
+        grid->Dirty = grid->Found + size;
+        grid->Marks = (uint32_t *)(grid->Dirty + size);
+        grid->Rects = (GUI_Display_t *)(grid->Marks + size);
+        grid->Pass = 0;                             /* New memory has all marks cleared */
+        grid->Size = size;
+    }
+    grid->Count = count;
+    return 1;
+}
+
+uint8_t __GUI_GRID_Build(GUI_Grid_t* grid, const GUI_Display_t* area) {
+    size_t i, c, r, c1, r1, c2, r2, cells, refs;
+    
+    grid->Valid = 0;
+    grid->DirtyCount = 0;
+    
+    /* Use about one cell per widget */
+    for (grid->Cols = 1; grid->Cols < GRID_MAX_SIDE && (grid->Cols + 1) * (grid->Cols + 1) <= grid->Count; grid->Cols++);
+    grid->Rows = grid->Cols;
+    grid->X = area->X1;
+    grid->Y = area->Y1;
+    grid->CellWidth = (area->X2 - area->X1) / (GUI_iDim_t)grid->Cols + 1;   /* Right and bottom edges are part of last cell too */
+    grid->CellHeight = (area->Y2 - area->Y1) / (GUI_iDim_t)grid->Rows + 1;
+    if (grid->CellWidth < 1)    { grid->CellWidth = 1; }    /* Area is not visible */
+    if (grid->CellHeight < 1)   { grid->CellHeight = 1; }
+    cells = grid->Cols * grid->Rows;
+    
+    if (cells + 1 > grid->CellsSize) {
+        if (grid->Cells) {
+            __GUI_MEMFREE(grid->Cells);
+        }
+        grid->CellsSize = 0;
+        grid->Cells = __GUI_MEMALLOC((2 * cells + 1) * sizeof(*grid->Cells));  /* Start positions and counters together */
+        if (!grid->Cells) {
+            return 0;
+        }
+        grid->CellsSize = cells + 1;
+    }
+    grid->Used = grid->Cells + grid->CellsSize;
+    memset(grid->Used, 0x00, cells * sizeof(*grid->Used));
+    
+    /* Count references in each cell */
+    for (i = 0; i < grid->Count; i++) {
+        if (!__GetCells(grid, &grid->Rects[i], &c1, &r1, &c2, &r2)) {
+            continue;
+        }
+        for (r = r1; r <= r2; r++) {
+            for (c = c1; c <= c2; c++) {
+                grid->Used[r * grid->Cols + c]++;
+            }
+        }
+    }
+    
+    /* Set start positions, each cell has some free references for moved widgets */
+    grid->Cells[0] = 0;
+    for (i = 0; i < cells; i++) {
+        grid->Cells[i + 1] = grid->Cells[i] + grid->Used[i] + GRID_CELL_FREE(grid->Used[i]);
+        grid->Used[i] = 0;
+    }
+    
+    refs = grid->Cells[cells];
+    if (refs > grid->RefsSize) {
+        if (grid->Refs) {
+            __GUI_MEMFREE(grid->Refs);
+        }
+        grid->RefsSize = 0;
+        grid->Refs = __GUI_MEMALLOC((refs + refs / 4) * sizeof(*grid->Refs));
+        if (!grid->Refs) {
+            return 0;
+        }
+        grid->RefsSize = refs + refs / 4;
+    }
+    
+    /* Fill references, items are processed in order so each cell is sorted */
+    for (i = 0; i < grid->Count; i++) {
+        if (!__GetCells(grid, &grid->Rects[i], &c1, &r1, &c2, &r2)) {
+            continue;
+        }
+        for (r = r1; r <= r2; r++) {
+            for (c = c1; c <= c2; c++) {
+                size_t cell = r * grid->Cols + c;
+                grid->Refs[grid->Cells[cell] + grid->Used[cell]++] = i;
+            }
+        }
+    }
+    
+    grid->Valid = 1;
+    return 1;
+}
+
+uint8_t __GUI_GRID_Add(GUI_Grid_t* grid, GUI_HANDLE_p h) {
+    size_t i;
+    
+    if (!grid->Valid) {
+        return 0;
+    }
+    if (grid->Count >= grid->Size || grid->DirtyCount >= grid->Size) {
+        grid->Valid = 0;                            /* No memory, index must be built again */
+        return 0;
+    }
+    i = grid->Count++;
+    grid->Items[i] = h;
+    RECT_SET_INVERTED(&grid->Rects[i]);             /* Widget is not in any cell yet */
+    grid->Marks[i] = 0;
+    grid->Dirty[grid->DirtyCount++] = i;            /* Set rectangle on next update */
+    __GH(h)->Index = i;
+    return 1;
+}
+
+void __GUI_GRID_Remove(GUI_Grid_t* grid, GUI_HANDLE_p h) {
+    size_t i = __GH(h)->Index;
+    
+    if (!grid->Valid || !__GUI_GRID_IsItem(grid, h)) {
+        return;
+    }
+    __RemoveRefs(grid, i);
+    grid->Items[i] = NULL;                          /* Position stays empty until index is built again */
+    RECT_SET_INVERTED(&grid->Rects[i]);
+}
+
+void __GUI_GRID_SetDirty(GUI_Grid_t* grid, GUI_HANDLE_p h) {
+    if (!grid->Valid || !__GUI_GRID_IsItem(grid, h)) {
+        return;
+    }
+    if (grid->DirtyCount >= grid->Size) {           /* Too many changes, build index again */
+        grid->Valid = 0;
+        return;
+    }
+    grid->Dirty[grid->DirtyCount++] = __GH(h)->Index;
+}
+
+uint8_t __GUI_GRID_Move(GUI_Grid_t* grid, size_t index, const GUI_Display_t* rect) {
+    __RemoveRefs(grid, index);                      /* Remove from old cells */
+    memcpy(&grid->Rects[index], rect, sizeof(*rect));
+    return __AddRefs(grid, index);                  /* Add to new cells */
+}
+
+size_t __GUI_GRID_FindAbove(GUI_Grid_t* grid, size_t index) {
+    size_t cnt = 0, pos = 0, cur = index, c, r, c1, r1, c2, r2, k, j, cell;
+    
+    if (!++grid->Pass) {                            /* Counter overflow, clear all marks */
+        memset(grid->Marks, 0x00, grid->Size * sizeof(*grid->Marks));
+        grid->Pass = 1;
+    }
+    grid->Marks[index] = grid->Pass;
+    
+    /**
+     * Found list is used as queue, every found item is checked for overlaps too.
+     * Each item is added only once, so list never has more than Count entries
+     */
+    while (1) {
+        const GUI_Display_t* rect = &grid->Rects[cur];
+        if (!RECT_IS_EMPTY(rect) && __GetCells(grid, rect, &c1, &r1, &c2, &r2)) {
+            for (r = r1; r <= r2; r++) {
+                for (c = c1; c <= c2; c++) {
+                    cell = r * grid->Cols + c;
+                    for (k = grid->Cells[cell]; k < grid->Cells[cell] + grid->Used[cell]; k++) {
+                        j = grid->Refs[k];
+                        if (j <= cur || grid->Marks[j] == grid->Pass) {
+                            continue;               /* Widget is below or already found */
+                        }
+                        if (RECT_INTERSECTS(rect, &grid->Rects[j])) {
+                            grid->Marks[j] = grid->Pass;
+                            grid->Found[cnt++] = j;
+                        }
+                    }
+                }
+            }
+        }
+        if (pos >= cnt) {
+            break;
+        }
+        cur = grid->Found[pos++];                   /* Check next found item */
+    }
+    return cnt;
+}
+
+uint8_t __GUI_GRID_GetCell(const GUI_Grid_t* grid, GUI_iDim_t x, GUI_iDim_t y, size_t* start, size_t* end) {
+    size_t c, r;
+    
+    x -= grid->X;
+    y -= grid->Y;
+    if (x < 0 || y < 0 || (size_t)(x / grid->CellWidth) >= grid->Cols || (size_t)(y / grid->CellHeight) >= grid->Rows) {
+        return 0;                                   /* Point is outside grid */
+    }
+    c = x / grid->CellWidth;
+    r = y / grid->CellHeight;
+    *start = grid->Cells[r * grid->Cols + c];
+    *end = *start + grid->Used[r * grid->Cols + c];
+    return 1;
+}
+
+void __GUI_GRID_Free(GUI_Grid_t* grid) {
+    if (grid->Items) {
+        __GUI_MEMFREE(grid->Items);
+    }
+    if (grid->Cells) {
+        __GUI_MEMFREE(grid->Cells);
+    }
+    if (grid->Refs) {
+        __GUI_MEMFREE(grid->Refs);
+    }
+    grid->Size = grid->CellsSize = grid->RefsSize = 0;
+    grid->Count = grid->DirtyCount = 0;
+    grid->Valid = 0;
+}
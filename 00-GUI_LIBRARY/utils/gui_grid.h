@@ -0,0 +1,202 @@
+/**
+ * \author  Tilen Majerle <tilen@majerle.eu>
+ * \brief   Spatial index of children widgets
+ *  
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2017 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software, 
+    and to permit persons to whom the Software is furnished to do so, 
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GUI_GRID_H
+#define GUI_GRID_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_UTILS
+ * \brief       
+ * \{
+ */
+#include "gui_utils.h"
+
+/**
+ * \defgroup        GUI_GRID Spatial index
+ * \brief           Uniform grid of children widgets rectangles
+ * \{
+ *
+ * Area covered by children widgets is split to cells and every widget is referenced
+ * from all cells its visible rectangle touches. Overlap search then checks only widgets
+ * in cells of searched rectangle instead of all children widgets.
+ *
+ * Widgets are indexed in linked list order, higher index means widget is drawn later (above).
+ * Grid covers visible area of parent widget, which also limits visible rectangles of children widgets.
+ *
+ * Index is updated for each change of one widget: widget added on top of others is appended,
+ * removed widget is cleared from its cells and moved or resized widget is marked dirty
+ * and moved to new cells on next use. Cells have some free references for that purpose.
+ * Index is built again when order of widgets or geometry of parent widget changes or when cell is full.
+ */
+
+#if defined(GUI_INTERNAL) || defined(DOXYGEN)
+
+/**
+ * \brief           Mark index as not valid anymore
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   grid: Pointer to \ref GUI_Grid_t structure. When set to NULL, nothing happens
+ * \hideinitializer
+ */
+#define __GUI_GRID_Invalidate(grid)     do { if (grid) { (grid)->Valid = 0; } } while (0)
+
+/**
+ * \brief           Check if widget is part of index
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       grid: Pointer to \ref GUI_Grid_t structure
+ * \param[in]       h: Widget handle
+ * \retval          1: Widget is indexed on position __GH(h)->Index
+ * \retval          0: Widget is not indexed
+ * \hideinitializer
+ */
+#define __GUI_GRID_IsItem(grid, h)      (__GH(h)->Index < (grid)->Count && (grid)->Items[__GH(h)->Index] == (h))
+
+/**
+ * \brief           Allocate memory for items of index
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *grid: Pointer to \ref GUI_Grid_t structure
+ * \param[in]       count: Number of items to index
+ * \retval          1: Memory is ready, Items and Rects can be filled for count entries
+ * \retval          0: Memory allocation failed
+ */
+uint8_t __GUI_GRID_Reserve(GUI_Grid_t* grid, size_t count);
+
+/**
+ * \brief           Sort items to cells after Items and Rects are filled
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *grid: Pointer to \ref GUI_Grid_t structure
+ * \param[in]       *area: Area on LCD where all item rectangles are, now and after any update
+ * \retval          1: Index is built
+ * \retval          0: Memory allocation failed
+ */
+uint8_t __GUI_GRID_Build(GUI_Grid_t* grid, const GUI_Display_t* area);
+
+/**
+ * \brief           Add widget on top of all indexed widgets
+ *
+ *                  Widget is added with empty rectangle and marked dirty,
+ *                  its rectangle is set on next update
+ *
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *grid: Pointer to \ref GUI_Grid_t structure
+ * \param[in]       h: Widget handle, its Index is set to position in index
+ * \retval          1: Widget is added
+ * \retval          0: No memory for new widget, index is marked invalid
+ */
+uint8_t __GUI_GRID_Add(GUI_Grid_t* grid, GUI_HANDLE_p h);
+
+/**
+ * \brief           Remove widget from index
+ *
+ *                  Position of widget stays empty until index is built again,
+ *                  so indexes of other widgets are not changed
+ *
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *grid: Pointer to \ref GUI_Grid_t structure
+ * \param[in]       h: Widget handle
+ */
+void __GUI_GRID_Remove(GUI_Grid_t* grid, GUI_HANDLE_p h);
+
+/**
+ * \brief           Mark rectangle of widget as not valid anymore
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *grid: Pointer to \ref GUI_Grid_t structure
+ * \param[in]       h: Widget handle
+ */
+void __GUI_GRID_SetDirty(GUI_Grid_t* grid, GUI_HANDLE_p h);
+
+/**
+ * \brief           Set new rectangle of item and move it to new cells
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *grid: Pointer to \ref GUI_Grid_t structure
+ * \param[in]       index: Index of item
+ * \param[in]       *rect: New rectangle of item, it must be inside area of grid
+ * \retval          1: Item is moved
+ * \retval          0: Cell is full, index is marked invalid and must be built again
+ */
+uint8_t __GUI_GRID_Move(GUI_Grid_t* grid, size_t index, const GUI_Display_t* rect);
+
+/**
+ * \brief           Find all items above item which overlap with it or with any item found before
+ *
+ *                  Search is transitive, item found above start item is used as search rectangle too.
+ *                  Result is written to Found list of grid
+ *
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *grid: Pointer to \ref GUI_Grid_t structure
+ * \param[in]       index: Index of start item
+ * \retval          Number of found items, start item is not included
+ */
+size_t __GUI_GRID_FindAbove(GUI_Grid_t* grid, size_t index);
+
+/**
+ * \brief           Get references of cell where point is
+ *
+ *                  References from start to end are indexes of items whose rectangle can include point,
+ *                  sorted from bottom to top item. Right and bottom edges of rectangles are included.
+ *
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       *grid: Pointer to \ref GUI_Grid_t structure
+ * \param[in]       x: X position of point on LCD
+ * \param[in]       y: Y position of point on LCD
+ * \param[out]      *start: Position of first reference in Refs list
+ * \param[out]      *end: Position after last reference in Refs list
+ * \retval          1: Point is inside grid
+ * \retval          0: Point is outside of all items
+ */
+uint8_t __GUI_GRID_GetCell(const GUI_Grid_t* grid, GUI_iDim_t x, GUI_iDim_t y, size_t* start, size_t* end);
+
+/**
+ * \brief           Free memory used by index, structure itself is not freed
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *grid: Pointer to \ref GUI_Grid_t structure
+ */
+void __GUI_GRID_Free(GUI_Grid_t* grid);
+
+#endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
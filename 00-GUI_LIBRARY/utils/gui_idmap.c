@@ -0,0 +1,170 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_idmap.h"
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+#define MAP_MIN_SIZE                16              /* Minimal number of entries when memory is allocated */
+#define MAP_HASH(map, id)           ((size_t)((uint32_t)(id) * 2654435761UL) & ((map)->Size - 1))
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Get entry where ID is or where it should be inserted */
+static
+GUI_IdMapEntry_t* __GetSlot(const GUI_IdMap_t* map, GUI_ID_t id) {
+    size_t i = MAP_HASH(map, id);
+    
+    while (map->Entries[i].Count && map->Entries[i].Id != id) {
+        i = (i + 1) & (map->Size - 1);              /* Linear probing */
+    }
+    return &map->Entries[i];
+}
+
+/* Move all entries to new memory with different size */
+static
+uint8_t __Resize(GUI_IdMap_t* map, size_t size) {
+    GUI_IdMapEntry_t* old = map->Entries;
+    size_t i, oldSize = map->Size;
+    
+    map->Entries = __GUI_MEMALLOC(size * sizeof(*map->Entries));
+    if (!map->Entries) {
+        map->Entries = old;                         /* Keep old memory */
+        return 0;
+    }
+    map->Size = size;
+    for (i = 0; i < oldSize; i++) {
+        if (old[i].Count) {
+            *__GetSlot(map, old[i].Id) = old[i];
+        }
+    }
+    if (old) {
+        __GUI_MEMFREE(old);
+    }
+    return 1;
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+uint8_t __GUI_IDMAP_Add(GUI_IdMap_t* map, GUI_ID_t id, GUI_HANDLE_p h) {
+    GUI_IdMapEntry_t* e;
+    
+    if (!map->Valid) {                              /* Map is built from widget tree later */
+        return 0;
+    }
+    if ((map->Used + 1) * 2 > map->Size) {          /* Keep at least half of entries empty */
+        if (!__Resize(map, map->Size ? map->Size * 2 : MAP_MIN_SIZE)) {
+            __GUI_IDMAP_Reset(map);                 /* Map can't include all widgets */
+            return 0;
+        }
+    }
+    e = __GetSlot(map, id);
+    if (!e->Count) {                                /* New ID */
+        e->Id = id;
+        e->Handle = h;
+        map->Used++;
+    }
+    e->Count++;
+    return 1;
+}
+
+void __GUI_IDMAP_Remove(GUI_IdMap_t* map, GUI_ID_t id, GUI_HANDLE_p h) {
+    GUI_IdMapEntry_t* e;
+    size_t i, j, k;
+    
+    if (!map->Valid || !map->Size) {
+        return;
+    }
+    e = __GetSlot(map, id);
+    if (!e->Count) {                                /* ID is not in map */
+        return;
+    }
+    if (--e->Count) {                               /* Other widgets still use this ID */
+        if (e->Handle == h) {
+            e->Handle = NULL;                       /* Remaining widget must be found in tree */
+        }
+        return;
+    }
+    
+    /**
+     * Remove entry and move following entries of the same probe sequence back,
+     * so search can still stop on first empty entry
+     */
+    i = e - map->Entries;
+    for (j = (i + 1) & (map->Size - 1); map->Entries[j].Count; j = (j + 1) & (map->Size - 1)) {
+        k = MAP_HASH(map, map->Entries[j].Id);      /* Home position of entry */
+        if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j))) {
+            map->Entries[i] = map->Entries[j];
+            i = j;
+        }
+    }
+    map->Entries[i].Count = 0;
+    map->Used--;
+    
+    if (map->Size > MAP_MIN_SIZE && map->Used * 8 < map->Size) {
+        __Resize(map, map->Size / 2);               /* Shrink, keep current size on failure */
+    }
+}
+
+GUI_IdMapEntry_t* __GUI_IDMAP_Find(const GUI_IdMap_t* map, GUI_ID_t id) {
+    GUI_IdMapEntry_t* e;
+    
+    if (!map->Size) {
+        return NULL;
+    }
+    e = __GetSlot(map, id);
+    return e->Count ? e : NULL;
+}
+
+void __GUI_IDMAP_Reset(GUI_IdMap_t* map) {
+    if (map->Entries) {
+        __GUI_MEMFREE(map->Entries);
+    }
+    map->Size = 0;
+    map->Used = 0;
+    map->Valid = 0;
+}
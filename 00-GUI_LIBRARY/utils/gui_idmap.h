@@ -0,0 +1,112 @@
+/**
+ * \author  Tilen Majerle <tilen@majerle.eu>
+ * \brief   Hash map of widget IDs
+ *  
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2017 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software, 
+    and to permit persons to whom the Software is furnished to do so, 
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GUI_IDMAP_H
+#define GUI_IDMAP_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_UTILS
+ * \brief       
+ * \{
+ */
+#include "gui_utils.h"
+
+/**
+ * \defgroup        GUI_IDMAP ID hash map
+ * \brief           Fast search of widgets by ID
+ * \{
+ *
+ * Map uses open addressing with linear probing and has at most half of entries used.
+ * It grows and shrinks with number of different IDs of live widgets.
+ *
+ * More widgets may have the same ID. Entry then counts them and search in widget tree
+ * is still required to get the first of them in tree order.
+ */
+
+#if defined(GUI_INTERNAL) || defined(DOXYGEN)
+
+/**
+ * \brief           Add widget to map
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *map: Pointer to \ref GUI_IdMap_t structure
+ * \param[in]       id: Widget ID
+ * \param[in]       h: Widget handle
+ * \retval          1: Widget added
+ * \retval          0: Memory allocation failed, map is not valid anymore
+ */
+uint8_t __GUI_IDMAP_Add(GUI_IdMap_t* map, GUI_ID_t id, GUI_HANDLE_p h);
+
+/**
+ * \brief           Remove widget from map
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *map: Pointer to \ref GUI_IdMap_t structure
+ * \param[in]       id: Widget ID
+ * \param[in]       h: Widget handle
+ */
+void __GUI_IDMAP_Remove(GUI_IdMap_t* map, GUI_ID_t id, GUI_HANDLE_p h);
+
+/**
+ * \brief           Get map entry for ID
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       *map: Pointer to \ref GUI_IdMap_t structure
+ * \param[in]       id: Widget ID
+ * \retval          > 0: Pointer to \ref GUI_IdMapEntry_t entry
+ * \retval          0: There is no widget with this ID
+ */
+GUI_IdMapEntry_t* __GUI_IDMAP_Find(const GUI_IdMap_t* map, GUI_ID_t id);
+
+/**
+ * \brief           Remove all entries and free map memory
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *map: Pointer to \ref GUI_IdMap_t structure
+ */
+void __GUI_IDMAP_Reset(GUI_IdMap_t* map);
+
+#endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
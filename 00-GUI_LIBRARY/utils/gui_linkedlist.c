@@ -281,18 +281,37 @@ uint8_t __GUI_LINKEDLIST_MULTI_FIND_REMOVE(GUI_LinkedListRoot_t* root, void* ele
 /******************************************************************************/
 /******************************************************************************/
 void __GUI_LINKEDLIST_WidgetAdd(GUI_HANDLE_ROOT_t* root, GUI_HANDLE_p h) {    
+    uint8_t indexed = 0;
+    
     if (root) {
+        indexed = root->Grid && root->Grid->Valid;  /* Spatial index matches children before new widget */
         __GUI_LINKEDLIST_ADD_GEN(&root->RootList, (GUI_LinkedList_t *)h);
     } else {
         __GUI_LINKEDLIST_ADD_GEN(&GUI.Root, (GUI_LinkedList_t *)h);
     }
     __GUI_LINKEDLIST_WidgetMoveToTop(h);            /* Reset by moving to top */
     __GUI_LINKEDLIST_WidgetMoveToBottom(h);         /* Reset by moving to bottom with reorder */
+    
+    /**
+     * Order of other widgets is not changed by reorder,
+     * new widget on the end of list is only added on top of spatial index
+     */
+    if (root && root->Grid) {
+        if (indexed && !__GH(h)->List.Next) {
+            root->Grid->Valid = 1;                  /* Moves during reorder marked index invalid */
+            __GUI_GRID_Add(root->Grid, h);
+        } else {
+            __GUI_GRID_Invalidate(root->Grid);      /* Spatial index does not match children anymore */
+        }
+    }
 }
 
 void __GUI_LINKEDLIST_WidgetRemove(GUI_HANDLE_p h) {    
     if (__GH(h)->Parent) {
         __GUI_LINKEDLIST_REMOVE_GEN(&((GUI_HANDLE_ROOT_t *)__GH(h)->Parent)->RootList, (GUI_LinkedList_t *)h);
+        if (__GHR(__GH(h)->Parent)->Grid) {
+            __GUI_GRID_Remove(__GHR(__GH(h)->Parent)->Grid, h); /* Order of other widgets is not changed */
+        }
     } else {
         __GUI_LINKEDLIST_REMOVE_GEN(&GUI.Root, (GUI_LinkedList_t *)h);
     }
@@ -300,6 +319,7 @@ void __GUI_LINKEDLIST_WidgetRemove(GUI_HANDLE_p h) {
 
 GUI_Byte __GUI_LINKEDLIST_WidgetMoveUp(GUI_HANDLE_p h) {
     if (__GH(h)->Parent) {
+        __GUI_GRID_Invalidate(__GHR(__GH(h)->Parent)->Grid);    /* Order of children is changed */
         return __GUI_LINKEDLIST_MOVEUP_GEN(&__GHR(__GH(h)->Parent)->RootList, (GUI_LinkedList_t *)h);
     }
     return __GUI_LINKEDLIST_MOVEUP_GEN(&GUI.Root, (GUI_LinkedList_t *)h);
@@ -307,6 +327,7 @@ GUI_Byte __GUI_LINKEDLIST_WidgetMoveUp(GUI_HANDLE_p h) {
 
 GUI_Byte __GUI_LINKEDLIST_WidgetMoveDown(GUI_HANDLE_p h) {
     if (__GH(h)->Parent) {
+        __GUI_GRID_Invalidate(__GHR(__GH(h)->Parent)->Grid);    /* Order of children is changed */
         return __GUI_LINKEDLIST_MOVEDOWN_GEN(&__GHR(__GH(h)->Parent)->RootList, (GUI_LinkedList_t *)h);
     }
     return __GUI_LINKEDLIST_MOVEDOWN_GEN(&GUI.Root, (GUI_LinkedList_t *)h);
@@ -430,7 +451,7 @@ void PrintList(GUI_HANDLE_ROOT_t* root) {
         list = &GUI.Root;
     }
     for (h = (GUI_HANDLE_ROOT_t *)list->First; h; h = h->Handle.List.Next) {
-        __GUI_DEBUG("%*d: W: %s; A: 0x%08X; R: %lu; D: %lu\r\n", depth, depth, h->Handle.Widget->Name, (unsigned int)h, h->Handle.Flags & GUI_FLAG_REDRAW, h->Handle.Flags & GUI_FLAG_REMOVE);
+        __GUI_DEBUG("%*d: W: %s; A: %p; R: %lu; D: %lu\r\n", depth, depth, h->Handle.Widget->Name, (void *)h, (unsigned long)(h->Handle.Flags & GUI_FLAG_REDRAW), (unsigned long)(h->Handle.Flags & GUI_FLAG_REMOVE));
         if (__GUI_WIDGET_AllowChildren(h)) {
             PrintList(h);
         }
@@ -31,20 +31,21 @@
 /***                           Private structures                            **/
 /******************************************************************************/
 /******************************************************************************/
+#define GUI_USE_MEM                 1               /*!< Use internal memory allocation */
+
+#if !GUI_MEM_TLSF
 typedef struct MemBlock {
     struct MemBlock* NextFreeBlock;                 /*!< Pointer to next free block */
     size_t Size;                                    /*!< Size of block */
 } MemBlock_t;
 #define MEMBLOCK_METASIZE           sizeof(MemBlock_t)
 
-
-#define GUI_USE_MEM                 1               /*!< Use internal memory allocation */
-
 /**
  * \brief           Memory alignment bits and absolute number
  */
-#define MEM_ALIGN_BITS              ((size_t)0x03)
+#define MEM_ALIGN_BITS              ((size_t)(sizeof(void *) - 1))   /* 4 bytes on 32-bit, 8 bytes on 64-bit systems */
 #define MEM_ALIGN_NUM               ((size_t)MEM_ALIGN_BITS + (size_t)1)
+#endif /* !GUI_MEM_TLSF */
 
 /******************************************************************************/
 /******************************************************************************/
@@ -57,6 +58,7 @@ typedef struct MemBlock {
 /***                            Private variables                            **/
 /******************************************************************************/
 /******************************************************************************/
+#if !GUI_MEM_TLSF
 static MemBlock_t StartBlock;
 static MemBlock_t* EndBlock = 0;
 static size_t MemAvailableBytes = 0;
@@ -64,12 +66,14 @@ static size_t MemMinAvailableBytes = 0;
 static size_t MemAllocBit = 0;
 
 static size_t MemTotalSize = 0;                     /* Size of memory in units of bytes */
+#endif /* !GUI_MEM_TLSF */
 
 /******************************************************************************/
 /******************************************************************************/
 /***                            Private functions                            **/
 /******************************************************************************/
 /******************************************************************************/
+#if !GUI_MEM_TLSF
 /* Insert block to list of free blocks */
 static
 void __mem_insertfreeblock(MemBlock_t* newBlock) {
@@ -208,6 +212,7 @@ uint8_t mem_assignmem(const mem_region_t* regions, size_t len) {
          * Set number of free bytes available to allocate in region
          */
         MemAvailableBytes += FirstBlock->Size;
+        MemTotalSize += FirstBlock->Size;
         
         regions++;                                  /* Go to next region */
     }
@@ -336,6 +341,8 @@ size_t mem_getusersize(void* ptr) {
     return 0;
 }
 
+#endif /* !GUI_MEM_TLSF */
+
 /* Allocate memory and set it to 0 */
 void* mem_calloc(size_t num, size_t size) {
     void* ptr;
@@ -366,6 +373,7 @@ void* mem_realloc(void* ptr, size_t size) {
     return 0;
 }
 
+#if !GUI_MEM_TLSF
 size_t mem_getfree(void) {
     return MemAvailableBytes;                       /* Return free bytes available for allocation */
 }
@@ -377,6 +385,7 @@ size_t mem_getfull(void) {
 size_t mem_getminfree(void) {
     return MemMinAvailableBytes;                    /* Return minimal bytes ever available */
 }
+#endif /* !GUI_MEM_TLSF */
 
 /******************************************************************************/
 /******************************************************************************/
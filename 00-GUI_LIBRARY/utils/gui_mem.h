@@ -202,6 +202,17 @@ size_t GUI_MEM_GetFull(void);
  */
 size_t GUI_MEM_GetMinFree(void);
     
+#if defined(GUI_INTERNAL) && !defined(DOXYGEN)
+//Allocator implementation, first-fit in gui_mem.c or two-level segregated fit in gui_mem_tlsf.c
+uint8_t mem_assignmem(const mem_region_t* regions, size_t len);
+void* mem_alloc(size_t size);
+void mem_free(void* ptr);
+size_t mem_getusersize(void* ptr);
+size_t mem_getfree(void);
+size_t mem_getfull(void);
+size_t mem_getminfree(void);
+#endif /* defined(GUI_INTERNAL) && !defined(DOXYGEN) */
+
 /**
  * \}
  */
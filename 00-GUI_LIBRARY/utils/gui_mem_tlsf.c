@@ -0,0 +1,359 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_mem.h"
+
+#if GUI_MEM_TLSF || defined(DOXYGEN)
+
+/**
+ * Two-level segregated fit allocator
+ *
+ * Free blocks are kept in lists by their size. First level splits sizes by power of 2,
+ * second level splits each power of 2 range to linear parts. Bitmaps of non-empty lists
+ * give suitable list with bit scan, so allocation and free take bounded time
+ * regardless of number of free blocks.
+ *
+ * Each block knows previous block in memory when it is free, so free block is merged
+ * with both neighbours without any search. Every region ends with used block of zero size,
+ * so blocks from different regions are never merged.
+ */
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+typedef struct MemBlock {
+    struct MemBlock* PrevPhys;                      /*!< Previous block in memory, valid only when previous block is free */
+    size_t Size;                                    /*!< Size of block including meta data and status bits */
+    struct MemBlock* NextFree;                      /*!< Next block in free list, used only in free block */
+    struct MemBlock* PrevFree;                      /*!< Previous block in free list, used only in free block */
+} MemBlock_t;
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+#define MEMBLOCK_METASIZE           (2 * sizeof(void *))    /* Meta data of used block, free list pointers are part of user memory */
+#define MEMBLOCK_MINSIZE            sizeof(MemBlock_t)      /* Minimal block size, free block must hold list pointers */
+
+#define MEM_ALIGN_BITS              ((size_t)(sizeof(void *) - 1))   /* 4 bytes on 32-bit, 8 bytes on 64-bit systems */
+#define MEM_ALIGN_NUM               ((size_t)MEM_ALIGN_BITS + (size_t)1)
+#define MEM_ALIGN_LOG2              (sizeof(void *) == 8 ? 3 : 2)
+
+#define BLOCK_FREE                  ((size_t)0x01)  /* Block is free */
+#define BLOCK_PREV_FREE             ((size_t)0x02)  /* Previous block in memory is free */
+#define BLOCK_SIZE(b)               ((b)->Size & ~(BLOCK_FREE | BLOCK_PREV_FREE))
+#define BLOCK_NEXT(b)               ((MemBlock_t *)((uint8_t *)(b) + BLOCK_SIZE(b)))
+
+#define SL_BITS                     4               /* Number of second level lists is 2 ^ SL_BITS */
+#define SL_COUNT                    (1 << SL_BITS)
+#define FL_SHIFT                    (SL_BITS + MEM_ALIGN_LOG2)  /* Blocks smaller than 2 ^ FL_SHIFT are all on first list */
+#define FL_MAX                      27              /* Highest bit of block size */
+#define FL_COUNT                    (FL_MAX - FL_SHIFT + 2)
+#define MEMBLOCK_MAXSIZE            (((size_t)1 << (FL_MAX + 1)) - MEM_ALIGN_NUM)
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+static uint32_t FlBitmap;                           /* Bit is set when any second level list is not empty */
+static uint32_t SlBitmap[FL_COUNT];                 /* Bit is set when list is not empty */
+static MemBlock_t* Blocks[FL_COUNT][SL_COUNT];      /* Lists of free blocks */
+static uint8_t MemAssigned = 0;
+static size_t MemAvailableBytes = 0;
+static size_t MemMinAvailableBytes = 0;
+static size_t MemTotalSize = 0;                     /* Size of memory in units of bytes */
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Get position of highest set bit, value must not be 0 */
+static
+uint8_t __mem_fls(uint32_t x) {
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(x);
+#elif defined(__CC_ARM)
+    return 31 - __clz(x);
+#else
+    uint8_t bit = 0;
+    while (x >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/* Get position of lowest set bit, value must not be 0 */
+#define __mem_ffs(x)                __mem_fls((x) & (~(x) + 1))
+
+/* Get list indexes where block of specific size belongs */
+static
+void __mem_mapping(size_t size, uint8_t* fl, uint8_t* sl) {
+    if (size < ((size_t)1 << FL_SHIFT)) {           /* Small blocks are linear on first list */
+        *fl = 0;
+        *sl = (uint8_t)(size >> MEM_ALIGN_LOG2);
+    } else {
+        uint8_t bit = __mem_fls((uint32_t)size);
+        *sl = (uint8_t)((size >> (bit - SL_BITS)) ^ SL_COUNT);
+        *fl = bit - FL_SHIFT + 1;
+    }
+}
+
+/* Insert block to free list */
+static
+void __mem_insertfreeblock(MemBlock_t* block) {
+    uint8_t fl, sl;
+    
+    __mem_mapping(BLOCK_SIZE(block), &fl, &sl);
+    block->PrevFree = 0;
+    block->NextFree = Blocks[fl][sl];
+    if (block->NextFree) {
+        block->NextFree->PrevFree = block;
+    }
+    Blocks[fl][sl] = block;
+    FlBitmap |= (uint32_t)1 << fl;
+    SlBitmap[fl] |= (uint32_t)1 << sl;
+}
+
+/* Remove block from free list */
+static
+void __mem_removefreeblock(MemBlock_t* block) {
+    uint8_t fl, sl;
+    
+    __mem_mapping(BLOCK_SIZE(block), &fl, &sl);
+    if (block->NextFree) {
+        block->NextFree->PrevFree = block->PrevFree;
+    }
+    if (block->PrevFree) {
+        block->PrevFree->NextFree = block->NextFree;
+    } else {                                        /* Block is first on list */
+        Blocks[fl][sl] = block->NextFree;
+        if (!Blocks[fl][sl]) {                      /* List is empty now */
+            SlBitmap[fl] &= ~((uint32_t)1 << sl);
+            if (!SlBitmap[fl]) {
+                FlBitmap &= ~((uint32_t)1 << fl);
+            }
+        }
+    }
+}
+
+/* Find free block with at least size bytes, first block of any list after size is rounded up is good enough */
+static
+MemBlock_t* __mem_findfreeblock(size_t size) {
+    uint8_t fl, sl;
+    uint32_t map;
+    
+    if (size >= ((size_t)1 << FL_SHIFT)) {          /* Round up to next list so every block on it is big enough */
+        size += ((size_t)1 << (__mem_fls((uint32_t)size) - SL_BITS)) - 1;
+    }
+    __mem_mapping(size, &fl, &sl);
+    if (fl >= FL_COUNT) {
+        return 0;
+    }
+    
+    map = SlBitmap[fl] & (~(uint32_t)0 << sl);      /* Lists with the same first level and bigger blocks */
+    if (!map) {
+        map = FlBitmap & (~(uint32_t)0 << (fl + 1));    /* Any first level list with bigger blocks */
+        if (!map) {
+            return 0;                               /* Out of memory */
+        }
+        fl = __mem_ffs(map);
+        map = SlBitmap[fl];
+    }
+    sl = __mem_ffs(map);
+    return Blocks[fl][sl];
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                          Allocator implementation                       **/
+/******************************************************************************/
+/******************************************************************************/
+uint8_t mem_assignmem(const mem_region_t* regions, size_t len) {
+    uint8_t* MemStartAddr;
+    size_t MemSize, i;
+    MemBlock_t *FirstBlock, *EndBlock;
+    
+    if (MemAssigned) {                              /* Regions already defined */
+        return 0;
+    }
+    
+    /**
+     * Check if region address are linear and rising
+     */
+    MemStartAddr = (uint8_t *)0;
+    for (i = 0; i < len; i++) {
+        if (MemStartAddr >= (uint8_t *)regions[i].StartAddress) {   /* Check if previous greater than current */
+            return 0;                               /* Return as invalid and failed */
+        }
+        MemStartAddr = (uint8_t *)regions[i].StartAddress;  /* Save as previous address */
+    }
+    
+    for (; len--; regions++) {
+        /**
+         * Get start address and check memory alignment
+         * if necessary, decrease memory region size
+         */
+        MemStartAddr = (uint8_t *)regions->StartAddress;
+        MemSize = regions->Size;
+        if ((size_t)MemStartAddr & MEM_ALIGN_BITS) {
+            i = MEM_ALIGN_NUM - ((size_t)MemStartAddr & MEM_ALIGN_BITS);
+            if (MemSize < i) {
+                continue;
+            }
+            MemStartAddr += i;
+            MemSize -= i;
+        }
+        MemSize &= ~MEM_ALIGN_BITS;
+        if (MemSize < MEMBLOCK_MINSIZE + MEMBLOCK_METASIZE) {   /* Check minimum region size */
+            continue;
+        }
+        if (MemSize > MEMBLOCK_MAXSIZE + MEMBLOCK_METASIZE) {   /* Use only part which fits to lists */
+            MemSize = MEMBLOCK_MAXSIZE + MEMBLOCK_METASIZE;
+        }
+        
+        /**
+         * Region is one free block followed by used block of zero size
+         */
+        FirstBlock = (MemBlock_t *)MemStartAddr;
+        FirstBlock->PrevPhys = 0;
+        FirstBlock->Size = (MemSize - MEMBLOCK_METASIZE) | BLOCK_FREE;
+        EndBlock = BLOCK_NEXT(FirstBlock);
+        EndBlock->PrevPhys = FirstBlock;
+        EndBlock->Size = BLOCK_PREV_FREE;
+        __mem_insertfreeblock(FirstBlock);
+        
+        MemAvailableBytes += BLOCK_SIZE(FirstBlock);
+        MemTotalSize += BLOCK_SIZE(FirstBlock);
+        MemAssigned = 1;
+    }
+    MemMinAvailableBytes = MemAvailableBytes;       /* Save minimum ever available bytes in region */
+    
+    return MemAssigned;
+}
+
+void* mem_alloc(size_t size) {
+    MemBlock_t *block, *next;
+    
+    if (!size || size > MEMBLOCK_MAXSIZE - MEMBLOCK_METASIZE) { /* Check input parameters */
+        return 0;
+    }
+    size = (size + MEMBLOCK_METASIZE + MEM_ALIGN_BITS) & ~MEM_ALIGN_BITS;   /* Add meta data and align size */
+    if (size < MEMBLOCK_MINSIZE) {
+        size = MEMBLOCK_MINSIZE;
+    }
+    
+    block = __mem_findfreeblock(size);              /* Get block from list */
+    if (!block) {
+        return 0;
+    }
+    __mem_removefreeblock(block);
+    
+    /**
+     * If found free block is bigger than required,
+     * split it and return remaining part to free lists
+     */
+    if (BLOCK_SIZE(block) - size >= MEMBLOCK_MINSIZE) {
+        next = (MemBlock_t *)((uint8_t *)block + size);
+        next->Size = (BLOCK_SIZE(block) - size) | BLOCK_FREE;   /* Previous block is used */
+        block->Size = size | (block->Size & BLOCK_PREV_FREE);
+        BLOCK_NEXT(next)->PrevPhys = next;          /* Block after remaining part still has free block before */
+        __mem_insertfreeblock(next);
+    } else {
+        BLOCK_NEXT(block)->Size &= ~BLOCK_PREV_FREE;    /* Block is used as whole */
+    }
+    block->Size &= ~BLOCK_FREE;                     /* Block is in use */
+    
+    MemAvailableBytes -= BLOCK_SIZE(block);         /* Decrease available memory */
+    if (MemAvailableBytes < MemMinAvailableBytes) { /* Check if current available memory is less than ever before */
+        MemMinAvailableBytes = MemAvailableBytes;   /* Update minimal available memory */
+    }
+    return (uint8_t *)block + MEMBLOCK_METASIZE;
+}
+
+void mem_free(void* ptr) {
+    MemBlock_t *block, *next;
+    
+    if (!ptr) {                                     /* To be in compliance with C free function */
+        return;
+    }
+    block = (MemBlock_t *)((uint8_t *)ptr - MEMBLOCK_METASIZE); /* Get block meta data pointer */
+    if ((block->Size & BLOCK_FREE) || BLOCK_SIZE(block) < MEMBLOCK_MINSIZE) {   /* Block must be in use */
+        return;
+    }
+    MemAvailableBytes += BLOCK_SIZE(block);         /* Increase available bytes back */
+    block->Size |= BLOCK_FREE;
+    
+    /* Merge with free neighbour blocks */
+    if (block->Size & BLOCK_PREV_FREE) {
+        MemBlock_t* prev = block->PrevPhys;
+        __mem_removefreeblock(prev);
+        prev->Size += BLOCK_SIZE(block);
+        block = prev;
+    }
+    next = BLOCK_NEXT(block);
+    if (next->Size & BLOCK_FREE) {
+        __mem_removefreeblock(next);
+        block->Size += BLOCK_SIZE(next);
+        next = BLOCK_NEXT(block);
+    }
+    next->Size |= BLOCK_PREV_FREE;                  /* Tell next block about free block before */
+    next->PrevPhys = block;
+    __mem_insertfreeblock(block);
+}
+
+/* Get size of user memory from input pointer */
+size_t mem_getusersize(void* ptr) {
+    MemBlock_t* block;
+    
+    if (!ptr) {
+        return 0;
+    }
+    block = (MemBlock_t *)((uint8_t *)ptr - MEMBLOCK_METASIZE); /* Get block meta data pointer */
+    if (!(block->Size & BLOCK_FREE)) {              /* Memory is actually allocated */
+        return BLOCK_SIZE(block) - MEMBLOCK_METASIZE;
+    }
+    return 0;
+}
+
+size_t mem_getfree(void) {
+    return MemAvailableBytes;                       /* Return free bytes available for allocation */
+}
+
+size_t mem_getfull(void) {
+    return MemTotalSize - MemAvailableBytes;        /* Return remaining bytes */
+}
+
+size_t mem_getminfree(void) {
+    return MemMinAvailableBytes;                    /* Return minimal bytes ever available */
+}
+
+#endif /* GUI_MEM_TLSF || defined(DOXYGEN) */
@@ -0,0 +1,232 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_region.h"
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+#define RECT_AREA(r)                ((uint32_t)((r)->X2 - (r)->X1) * (uint32_t)((r)->Y2 - (r)->Y1))
+#define RECT_IS_EMPTY(r)            ((r)->X1 >= (r)->X2 || (r)->Y1 >= (r)->Y2)
+#define RECT_CONTAINS(a, b)         ((a)->X1 <= (b)->X1 && (a)->Y1 <= (b)->Y1 && (a)->X2 >= (b)->X2 && (a)->Y2 >= (b)->Y2)
+#define RECT_INTERSECTS(a, b)       ((a)->X1 < (b)->X2 && (b)->X1 < (a)->X2 && (a)->Y1 < (b)->Y2 && (b)->Y1 < (a)->Y2)
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Get bounding rectangle of 2 rectangles */
+static
+void __Union(const GUI_Display_t* a, const GUI_Display_t* b, GUI_Display_t* out) {
+    out->X1 = __GUI_MIN(a->X1, b->X1);
+    out->Y1 = __GUI_MIN(a->Y1, b->Y1);
+    out->X2 = __GUI_MAX(a->X2, b->X2);
+    out->Y2 = __GUI_MAX(a->Y2, b->Y2);
+}
+
+/* Get number of pixels in merged rectangle which are not part of any input rectangle */
+static
+uint32_t __MergeWaste(const GUI_Display_t* a, const GUI_Display_t* b, GUI_Display_t* merged) {
+    uint32_t area = RECT_AREA(a) + RECT_AREA(b);
+    
+    __Union(a, b, merged);
+    if (RECT_INTERSECTS(a, b)) {                    /* Overlapped part is counted twice */
+        GUI_Display_t i;
+        i.X1 = __GUI_MAX(a->X1, b->X1);
+        i.Y1 = __GUI_MAX(a->Y1, b->Y1);
+        i.X2 = __GUI_MIN(a->X2, b->X2);
+        i.Y2 = __GUI_MIN(a->Y2, b->Y2);
+        area -= RECT_AREA(&i);
+    }
+    return RECT_AREA(merged) - area;
+}
+
+/* Check if rectangle overlaps part of any region rectangle other than the one with skip index */
+static
+uint8_t __OverlapsOthers(const GUI_Region_t* region, size_t skip, const GUI_Display_t* rect) {
+    size_t i;
+    
+    for (i = 0; i < region->Count; i++) {
+        if (i != skip && RECT_INTERSECTS(&region->Rects[i], rect) && !RECT_CONTAINS(rect, &region->Rects[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Remove rectangle from list, order of rectangles is not important */
+static
+void __Remove(GUI_Region_t* region, size_t index) {
+    region->Rects[index] = region->Rects[--region->Count];
+}
+
+/* Split rectangle to up to 4 parts which are not covered by cut rectangle */
+size_t __GUI_REGION_Subtract(const GUI_Display_t* rect, const GUI_Display_t* cut, GUI_Display_t* parts) {
+    GUI_Display_t r = *rect;
+    size_t cnt = 0;
+    
+    if (r.Y1 < cut->Y1) {                           /* Top part, full width */
+        parts[cnt] = r;
+        parts[cnt++].Y2 = cut->Y1;
+        r.Y1 = cut->Y1;
+    }
+    if (r.Y2 > cut->Y2) {                           /* Bottom part, full width */
+        parts[cnt] = r;
+        parts[cnt++].Y1 = cut->Y2;
+        r.Y2 = cut->Y2;
+    }
+    if (r.X1 < cut->X1) {                           /* Left part of middle band */
+        parts[cnt] = r;
+        parts[cnt++].X2 = cut->X1;
+    }
+    if (r.X2 > cut->X2) {                           /* Right part of middle band */
+        parts[cnt] = r;
+        parts[cnt++].X1 = cut->X2;
+    }
+    return cnt;
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+void __GUI_REGION_Reset(GUI_Region_t* region) {
+    region->Count = 0;
+}
+
+uint8_t __GUI_REGION_Add(GUI_Region_t* region, const GUI_Display_t* rect) {
+    GUI_Display_t add = *rect, merged;
+    size_t i, best;
+    uint32_t waste, bestWaste;
+    
+    if (RECT_IS_EMPTY(&add)) {                      /* Nothing to add */
+        return 0;
+    }
+    
+    /**
+     * Merge new rectangle with existing ones when it is cheap enough.
+     * Merged rectangle must not overlap only part of other rectangle,
+     * otherwise it would be split again to the same parts it was created from.
+     * After each merge start from the beginning as bigger rectangle may now touch others
+     */
+    for (i = 0; i < region->Count; ) {
+        GUI_Display_t* r = &region->Rects[i];
+        if (RECT_CONTAINS(r, &add)) {               /* Already part of region */
+            return 1;
+        }
+        if (RECT_CONTAINS(&add, r)) {               /* Existing rectangle is covered by new one */
+            __Remove(region, i);
+            continue;
+        }
+        waste = __MergeWaste(r, &add, &merged);
+        if (waste * 100 <= RECT_AREA(&merged) * GUI_DISPLAY_REGIONS_WASTE && !__OverlapsOthers(region, i, &merged)) {
+            add = merged;                           /* Use merged rectangle as new one */
+            __Remove(region, i);
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+    
+    /**
+     * New rectangle overlaps with rectangle which is not worth to merge,
+     * add only parts which are not covered yet to keep rectangles disjoint
+     */
+    for (i = 0; i < region->Count; i++) {
+        if (RECT_INTERSECTS(&region->Rects[i], &add)) {
+            GUI_Display_t parts[4];
+            size_t cnt = __GUI_REGION_Subtract(&add, &region->Rects[i], parts);
+            for (i = 0; i < cnt; i++) {
+                __GUI_REGION_Add(region, &parts[i]);
+            }
+            return 1;
+        }
+    }
+    
+    /**
+     * List is full, merge with rectangle which gives the smallest waste
+     * and absorb all rectangles merged one overlaps with
+     */
+    if (region->Count >= GUI_DISPLAY_REGIONS) {
+        best = 0;
+        bestWaste = 0xFFFFFFFFUL;
+        for (i = 0; i < region->Count; i++) {
+            waste = __MergeWaste(&region->Rects[i], &add, &merged);
+            if (waste < bestWaste) {
+                bestWaste = waste;
+                best = i;
+            }
+        }
+        __Union(&region->Rects[best], &add, &add);
+        __Remove(region, best);
+        for (i = 0; i < region->Count; ) {
+            if (RECT_INTERSECTS(&region->Rects[i], &add)) {
+                __Union(&region->Rects[i], &add, &add);
+                __Remove(region, i);
+                i = 0;
+                continue;
+            }
+            i++;
+        }
+    }
+    region->Rects[region->Count++] = add;           /* Add rectangle to the end of list */
+    return 1;
+}
+
+uint8_t __GUI_REGION_Intersects(const GUI_Region_t* region, size_t start, const GUI_Display_t* rect) {
+    for (; start < region->Count; start++) {
+        if (RECT_INTERSECTS(&region->Rects[start], rect)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint32_t __GUI_REGION_GetArea(const GUI_Region_t* region) {
+    uint32_t area = 0;
+    size_t i;
+    
+    for (i = 0; i < region->Count; i++) {
+        area += RECT_AREA(&region->Rects[i]);       /* Rectangles are disjoint */
+    }
+    return area;
+}
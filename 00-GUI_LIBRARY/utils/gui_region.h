@@ -0,0 +1,131 @@
+/**
+ * \author  Tilen Majerle <tilen@majerle.eu>
+ * \brief   Dirty region management
+ *  
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2017 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software, 
+    and to permit persons to whom the Software is furnished to do so, 
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GUI_REGION_H
+#define GUI_REGION_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_UTILS
+ * \brief       
+ * \{
+ */
+#include "gui_utils.h"
+
+/**
+ * \defgroup        GUI_REGION Dirty regions
+ * \brief           List of disjoint rectangles which need redraw
+ * \{
+ *
+ * Every invalidated widget adds its visible rectangle to the list.
+ * New rectangle is merged with existing one when merged rectangle does not waste
+ * more than \ref GUI_DISPLAY_REGIONS_WASTE percent of its area on pixels which are not dirty,
+ * otherwise it is split to parts which do not overlap existing rectangles.
+ *
+ * When list is full, rectangle is merged with the one which gives the smallest merged area.
+ */
+
+#if defined(GUI_INTERNAL) || defined(DOXYGEN)
+
+/**
+ * \brief           Remove all rectangles from region
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *region: Pointer to \ref GUI_Region_t structure
+ */
+void __GUI_REGION_Reset(GUI_Region_t* region);
+
+/**
+ * \brief           Add rectangle to region
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *region: Pointer to \ref GUI_Region_t structure
+ * \param[in]       *rect: Pointer to rectangle to add
+ * \retval          1: Rectangle added or already part of region
+ * \retval          0: Rectangle is empty
+ */
+uint8_t __GUI_REGION_Add(GUI_Region_t* region, const GUI_Display_t* rect);
+
+/**
+ * \brief           Check if rectangle intersects with any region rectangle
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       *region: Pointer to \ref GUI_Region_t structure
+ * \param[in]       start: Index of first region rectangle to check
+ * \param[in]       *rect: Pointer to rectangle to check
+ * \retval          1: Rectangle intersects with region
+ * \retval          0: Rectangle is outside region
+ */
+uint8_t __GUI_REGION_Intersects(const GUI_Region_t* region, size_t start, const GUI_Display_t* rect);
+
+/**
+ * \brief           Get number of pixels covered by region
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       *region: Pointer to \ref GUI_Region_t structure
+ * \retval          Region area in units of pixels
+ */
+uint32_t __GUI_REGION_GetArea(const GUI_Region_t* region);
+
+/**
+ * \brief           Split rectangle to parts which are not covered by cut rectangle
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       *rect: Pointer to rectangle to split
+ * \param[in]       *cut: Pointer to rectangle to remove. It must intersect with split rectangle
+ * \param[out]      *parts: Pointer to array of at least 4 rectangles for output parts
+ * \retval          Number of parts, 0 when rectangle is completely covered
+ */
+size_t __GUI_REGION_Subtract(const GUI_Display_t* rect, const GUI_Display_t* cut, GUI_Display_t* parts);
+
+/**
+ * \brief           Get number of rectangles in region
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       region: Pointer to \ref GUI_Region_t structure
+ * \retval          Number of rectangles
+ * \hideinitializer
+ */
+#define __GUI_REGION_GetCount(region)   ((region)->Count)
+
+#endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
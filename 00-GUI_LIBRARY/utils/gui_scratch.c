@@ -0,0 +1,254 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_scratch.h"
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+static GUI_Scratch_t* Pool;                         /* List of layers kept in pool */
+static size_t PoolSize;                             /* Number of bytes of pixel data in pool */
+static uint32_t Stamp;                              /* Use stamp of last used layer */
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Check if widget is on the same position with the same size as when content has been cached */
+static
+uint8_t __IsSameGeometry(GUI_Scratch_t* s, GUI_HANDLE_p h) {
+    return s->X == __GUI_WIDGET_GetAbsoluteX(h) && s->Y == __GUI_WIDGET_GetAbsoluteY(h) &&
+        s->Width == __GUI_WIDGET_GetWidth(h) && s->Height == __GUI_WIDGET_GetHeight(h);
+}
+
+/* Get size class for number of bytes, there are 4 classes between 2 powers of 2 */
+static
+size_t __GetSizeClass(size_t size) {
+    size_t step = 1;
+    
+    while ((step << 3) < size) {
+        step <<= 1;
+    }
+    return (size + step - 1) & ~(step - 1);         /* Round up to multiple of step */
+}
+
+/* Wait for low-level to finish, no layer is read anymore */
+static
+void __WaitPending(void) {
+    GUI_Scratch_t* s;
+    
+    __GUI_LL_FENCE();                               /* Wait queued drawing operations */
+    for (s = Pool; s; s = s->Next) {
+        s->Pending = 0;
+    }
+}
+
+/* Free layer memory */
+static
+void __FreeLayer(GUI_Scratch_t* s) {
+    if (s->Pending) {
+        __WaitPending();                            /* Layer must not be used by low-level anymore */
+    }
+    if (s->Owner) {
+        __GH(s->Owner)->Cache = NULL;               /* Widget content is not cached anymore */
+    }
+    __GUI_MEMFREE(s);
+}
+
+/* Free least recently used layer which is not currently used for drawing */
+static
+uint8_t __EvictLayer(void) {
+    GUI_Scratch_t *s, *prev, *best = NULL, *bestPrev = NULL;
+    
+    for (prev = NULL, s = Pool; s; prev = s, s = s->Next) {
+        if (s->InUse) {
+            continue;
+        }
+        /* Layers without owner are freed before cached content of widgets */
+        if (!best || (!s->Owner && best->Owner) || 
+            (!s->Owner == !best->Owner && (int32_t)(s->Used - best->Used) < 0)) {
+            best = s;
+            bestPrev = prev;
+        }
+    }
+    if (!best) {
+        return 0;
+    }
+    
+    if (bestPrev) {                                 /* Remove layer from pool */
+        bestPrev->Next = best->Next;
+    } else {
+        Pool = best->Next;
+    }
+    PoolSize -= best->Size;
+    __FreeLayer(best);
+    return 1;
+}
+
+/* Get free layer from pool or allocate new one */
+static
+GUI_Scratch_t* __GetLayer(GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height) {
+    GUI_Scratch_t* s;
+    size_t size = (size_t)width * (size_t)height * GUI.LCD.PixelSize;
+    size_t cls = __GetSizeClass(size);
+    
+    for (s = Pool; s; s = s->Next) {                /* Find free layer of the same class */
+        if (!s->InUse && !s->Owner && s->Size == cls && s->PixelSize == GUI.LCD.PixelSize) {
+            break;
+        }
+    }
+    if (s) {
+        if (s->Pending) {                           /* Previous content may still be read */
+            __WaitPending();
+        }
+        memset((void *)((char *)s + sizeof(*s)), 0x00, size);  /* Clear layer as after allocation */
+    } else {
+        uint8_t pooled = cls <= GUI_SCRATCH_POOL_SIZE;
+        
+        if (pooled) {                               /* Make space in pool for new layer */
+            while (PoolSize + cls > GUI_SCRATCH_POOL_SIZE && __EvictLayer()) {}
+            pooled = PoolSize + cls <= GUI_SCRATCH_POOL_SIZE;
+        }
+        if (!pooled) {                              /* Layer is freed after use, do not waste memory */
+            cls = size;
+        }
+        
+        s = __GUI_MEMALLOC(sizeof(*s) + cls);       /* Allocate layer and pixel data together */
+        if (!s) {
+            while (__EvictLayer()) {}               /* Free unused layers and try again */
+            s = __GUI_MEMALLOC(sizeof(*s) + cls);
+        }
+        if (!s) {
+            return NULL;
+        }
+        s->Size = cls;
+        s->PixelSize = GUI.LCD.PixelSize;
+        s->Pooled = pooled;
+        if (pooled) {                               /* Add layer to pool */
+            s->Next = Pool;
+            Pool = s;
+            PoolSize += cls;
+        }
+    }
+    
+    s->InUse = 1;
+    s->Used = ++Stamp;
+    s->Layer.Width = width;
+    s->Layer.Height = height;
+    s->Layer.OffsetX = x;
+    s->Layer.OffsetY = y;
+    s->Layer.StartAddress = (uintptr_t)((char *)s) + sizeof(*s);
+    return s;
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+GUI_Layer_t* __GUI_SCRATCH_Get(GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height) {
+    GUI_Scratch_t* s = __GetLayer(x, y, width, height);
+    return s ? &s->Layer : NULL;
+}
+
+void __GUI_SCRATCH_Release(GUI_Layer_t* layer) {
+    GUI_Scratch_t* s = (GUI_Scratch_t *)layer;      /* Layer is first member */
+    
+    s->InUse = 0;
+    if (s->Pooled) {                                /* Keep layer in pool */
+        s->Pending = 1;                             /* Low-level may still blend it */
+    } else {
+        __GUI_LL_FENCE();                           /* Layer must not be used by low-level anymore */
+        __GUI_MEMFREE(s);
+    }
+}
+
+GUI_Layer_t* __GUI_SCRATCH_GetCache(GUI_HANDLE_p h, const GUI_Display_t* area) {
+    GUI_Scratch_t* s = __GH(h)->Cache;
+    
+    if (s && s->Valid && __IsSameGeometry(s, h) &&
+        s->Layer.OffsetX == area->X1 && s->Layer.OffsetY == area->Y1 &&
+        s->Layer.Width == area->X2 - area->X1 && s->Layer.Height == area->Y2 - area->Y1) {
+        s->InUse = 1;
+        s->Used = ++Stamp;
+        return &s->Layer;
+    }
+    return NULL;
+}
+
+GUI_Layer_t* __GUI_SCRATCH_NewCache(GUI_HANDLE_p h, const GUI_Display_t* area) {
+    GUI_Scratch_t* s;
+    
+    __GUI_SCRATCH_DropCache(h);                     /* Old content is not valid anymore */
+    s = __GetLayer(area->X1, area->Y1, area->X2 - area->X1, area->Y2 - area->Y1);
+    if (s && !s->Pooled) {                          /* Layer would not fit to pool */
+        __GUI_SCRATCH_Release(&s->Layer);
+        s = NULL;
+    }
+    if (s) {
+        s->Owner = h;
+        s->Valid = 1;
+        s->X = __GUI_WIDGET_GetAbsoluteX(h);       /* Content is valid only on this position and size */
+        s->Y = __GUI_WIDGET_GetAbsoluteY(h);
+        s->Width = __GUI_WIDGET_GetWidth(h);
+        s->Height = __GUI_WIDGET_GetHeight(h);
+        __GH(h)->Cache = s;
+    }
+    return s ? &s->Layer : NULL;
+}
+
+void __GUI_SCRATCH_DropCache(GUI_HANDLE_p h) {
+    GUI_Scratch_t* s = __GH(h)->Cache;
+    
+    if (s) {                                        /* Layer stays in pool as free layer */
+        s->Owner = NULL;
+        s->Valid = 0;
+        __GH(h)->Cache = NULL;
+    }
+}
+
+void __GUI_SCRATCH_InvalidateCache(GUI_HANDLE_p h) {
+    for (; h; h = __GH(h)->Parent) {                /* Parent content includes children widgets */
+        if (__GH(h)->Cache) {
+            __GH(h)->Cache->Valid = 0;
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * \author  Tilen Majerle <tilen@majerle.eu>
+ * \brief   Scratch layers for transparent widgets
+ *  
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2017 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software, 
+    and to permit persons to whom the Software is furnished to do so, 
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GUI_SCRATCH_H
+#define GUI_SCRATCH_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_UTILS
+ * \{
+ */
+#include "gui_utils.h"
+
+/**
+ * \defgroup        GUI_SCRATCH Scratch layers
+ * \brief           Pool of virtual layers for drawing of transparent widgets
+ * \{
+ *
+ * Transparent widget is drawn to virtual layer first and then blended to drawing layer.
+ * Layers are allocated in size classes and kept in pool after use, so next redraw
+ * of the same widget does not allocate memory again. Pool is limited with \ref GUI_SCRATCH_POOL_SIZE
+ * and least recently used layers are freed when limit is reached.
+ *
+ * Widget with \ref GUI_FLAG_CACHE flag owns its layer between redraws.
+ * When content of widget or any of its children has not changed,
+ * layer is only blended again without drawing widgets.
+ *
+ * Low-level may still read layer after it has been blended. Layer is used again
+ * or freed only after all queued drawing operations are finished.
+ */
+
+#if defined(GUI_INTERNAL) || defined(DOXYGEN)
+
+/**
+ * \brief           Get scratch layer for drawing
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       x: Absolute X position of layer on screen
+ * \param[in]       y: Absolute Y position of layer on screen
+ * \param[in]       width: Layer width in units of pixels
+ * \param[in]       height: Layer height in units of pixels
+ * \retval          > 0: Pointer to \ref GUI_Layer_t virtual layer
+ * \retval          0: Memory allocation failed
+ */
+GUI_Layer_t* __GUI_SCRATCH_Get(GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height);
+
+/**
+ * \brief           Release scratch layer after its content has been blended
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       *layer: Layer returned by \ref __GUI_SCRATCH_Get
+ */
+void __GUI_SCRATCH_Release(GUI_Layer_t* layer);
+
+/**
+ * \brief           Get layer with valid cached content of widget
+ * \note            Content is valid until widget or any of its children is invalidated, or widget is moved or resized
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       h: Widget handle
+ * \param[in]       *area: Visible area of widget, cached layer must cover exactly this area
+ * \retval          > 0: Pointer to \ref GUI_Layer_t with widget content
+ * \retval          0: Widget has no valid cached content
+ */
+GUI_Layer_t* __GUI_SCRATCH_GetCache(GUI_HANDLE_p h, const GUI_Display_t* area);
+
+/**
+ * \brief           Get new layer for widget content which is kept for next redraws
+ * \note            Previous cached layer of widget is released
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       h: Widget handle
+ * \param[in]       *area: Visible area of widget
+ * \retval          > 0: Pointer to \ref GUI_Layer_t virtual layer to draw widget to
+ * \retval          0: Memory allocation failed
+ */
+GUI_Layer_t* __GUI_SCRATCH_NewCache(GUI_HANDLE_p h, const GUI_Display_t* area);
+
+/**
+ * \brief           Release cached layer of widget
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       h: Widget handle
+ */
+void __GUI_SCRATCH_DropCache(GUI_HANDLE_p h);
+
+/**
+ * \brief           Mark cached content of widget and all its parent widgets as changed
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       h: Widget handle
+ */
+void __GUI_SCRATCH_InvalidateCache(GUI_HANDLE_p h);
+
+#endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,226 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_stats.h"
+
+#if GUI_USE_STATS || defined(DOXYGEN)
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+#define __CountLL(func, field, pixels)      do {    \
+    GUI.Stats.LLCalls[GUI_STATS_LL_ ## func]++;     \
+    GUI.Stats.field += (pixels);                    \
+} while (0)
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+static GUI_LL_t LL;                                 /* Low-level functions set by driver */
+static GUI_STATS_t StatsLast;                       /* Statistics of last drawn frame */
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+static
+void __SetPixel(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Color_t color) {
+    __CountLL(SetPixel, PixelsFilled, 1);
+    LL.SetPixel(LCD, layer, x, y, color);
+}
+
+static
+GUI_Color_t __GetPixel(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y) {
+    GUI.Stats.LLCalls[GUI_STATS_LL_GetPixel]++;
+    return LL.GetPixel(LCD, layer, x, y);
+}
+
+static
+void __Fill(GUI_LCD_t* LCD, GUI_Layer_t* layer, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLine, GUI_Color_t color) {
+    __CountLL(Fill, PixelsFilled, (uint32_t)xSize * ySize);
+    LL.Fill(LCD, layer, dst, xSize, ySize, offLine, color);
+}
+
+static
+void __Copy(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    __CountLL(Copy, PixelsCopied, (uint32_t)xSize * ySize);
+    LL.Copy(LCD, layer, src, dst, xSize, ySize, offLineSrc, offLineDst);
+}
+
+static
+void __CopyBlend(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void* dst, uint8_t alphaSrc, uint8_t alphaDst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    __CountLL(CopyBlend, PixelsBlended, (uint32_t)xSize * ySize);
+    LL.CopyBlend(LCD, layer, src, dst, alphaSrc, alphaDst, xSize, ySize, offLineSrc, offLineDst);
+}
+
+static
+void __DrawHLine(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t length, GUI_Color_t color) {
+    __CountLL(DrawHLine, PixelsFilled, length);
+    LL.DrawHLine(LCD, layer, x, y, length, color);
+}
+
+static
+void __DrawVLine(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t length, GUI_Color_t color) {
+    __CountLL(DrawVLine, PixelsFilled, length);
+    LL.DrawVLine(LCD, layer, x, y, length, color);
+}
+
+static
+void __FillRect(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Color_t color) {
+    __CountLL(FillRect, PixelsFilled, (uint32_t)xSize * ySize);
+    LL.FillRect(LCD, layer, x, y, xSize, ySize, color);
+}
+
+static
+void __DrawImage16(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t* img, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    __CountLL(DrawImage16, PixelsCopied, (uint32_t)xSize * ySize);
+    LL.DrawImage16(LCD, layer, img, src, dst, xSize, ySize, offLineSrc, offLineDst);
+}
+
+static
+void __DrawImage24(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t* img, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    __CountLL(DrawImage24, PixelsCopied, (uint32_t)xSize * ySize);
+    LL.DrawImage24(LCD, layer, img, src, dst, xSize, ySize, offLineSrc, offLineDst);
+}
+
+static
+void __DrawImage32(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t* img, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    __CountLL(DrawImage32, PixelsBlended, (uint32_t)xSize * ySize);  /* Image with alpha channel */
+    LL.DrawImage32(LCD, layer, img, src, dst, xSize, ySize, offLineSrc, offLineDst);
+}
+
+static
+void __CopyChar(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst, GUI_Color_t color) {
+    __CountLL(CopyChar, PixelsBlended, (uint32_t)xSize * ySize);    /* Alpha only source blended with color */
+    LL.CopyChar(LCD, layer, src, dst, xSize, ySize, offLineSrc, offLineDst, color);
+}
+
+static
+void __DrawBatch(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_LL_Cmd_t* cmds, size_t count) {
+    size_t i;
+    
+    GUI.Stats.LLCalls[GUI_STATS_LL_DrawBatch]++;
+    GUI.Stats.BatchedCommands += count;
+    for (i = 0; i < count; i++) {                   /* Count pixels of each command */
+        uint32_t pixels = (uint32_t)cmds[i].XSize * cmds[i].YSize;
+        switch (cmds[i].Type) {
+            case GUI_LL_CmdType_Fill:
+                GUI.Stats.PixelsFilled += pixels;
+                break;
+            case GUI_LL_CmdType_Copy:
+                GUI.Stats.PixelsCopied += pixels;
+                break;
+            case GUI_LL_CmdType_DrawImage:
+                if (cmds[i].Img->BPP == 32) {       /* Image with alpha channel */
+                    GUI.Stats.PixelsBlended += pixels;
+                } else {
+                    GUI.Stats.PixelsCopied += pixels;
+                }
+                break;
+            default:
+                GUI.Stats.PixelsBlended += pixels;
+                break;
+        }
+    }
+    LL.DrawBatch(LCD, layer, cmds, count);
+}
+
+static
+void __ReadRect(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t xSize, GUI_Dim_t ySize, void* buff, GUI_PixelFormat_t format) {
+    GUI.Stats.LLCalls[GUI_STATS_LL_ReadRect]++;
+    LL.ReadRect(LCD, layer, x, y, xSize, ySize, buff, format);
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+void __GUI_STATS_Init(void) {
+    memcpy(&LL, &GUI.LL, sizeof(LL));               /* Save driver functions */
+    
+    /* Replace only functions set by driver, optional ones must stay 0 */
+#define SET_WRAPPER(func)   if (LL.func) { GUI.LL.func = __ ## func; }
+    SET_WRAPPER(SetPixel);
+    SET_WRAPPER(GetPixel);
+    SET_WRAPPER(Fill);
+    SET_WRAPPER(Copy);
+    SET_WRAPPER(CopyBlend);
+    SET_WRAPPER(DrawHLine);
+    SET_WRAPPER(DrawVLine);
+    SET_WRAPPER(FillRect);
+    SET_WRAPPER(DrawImage16);
+    SET_WRAPPER(DrawImage24);
+    SET_WRAPPER(DrawImage32);
+    SET_WRAPPER(CopyChar);
+    SET_WRAPPER(DrawBatch);
+    SET_WRAPPER(ReadRect);
+#undef SET_WRAPPER
+    
+    memset(&GUI.Stats, 0x00, sizeof(GUI.Stats));
+    memset(&StatsLast, 0x00, sizeof(StatsLast));
+}
+
+void __GUI_STATS_FrameDone(void) {
+    uint32_t frame = GUI.Stats.Frame;
+    
+    memcpy(&StatsLast, &GUI.Stats, sizeof(StatsLast));  /* Save finished frame */
+    memset(&GUI.Stats, 0x00, sizeof(GUI.Stats));    /* Start new frame */
+    GUI.Stats.Frame = frame + 1;
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                  Thread safe version of public API                      **/
+/******************************************************************************/
+/******************************************************************************/
+uint8_t GUI_STATS_Get(GUI_STATS_t* stats) {
+    uint8_t ret;
+    
+    __GUI_ASSERTPARAMS(stats);                      /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    ret = GUI.Stats.Frame > 0;                      /* At least one frame must be finished */
+    if (ret) {
+        memcpy(stats, &StatsLast, sizeof(*stats));  /* Copy last frame */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+#endif /* GUI_USE_STATS || defined(DOXYGEN) */
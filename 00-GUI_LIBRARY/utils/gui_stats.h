@@ -0,0 +1,144 @@
+/**
+ * \author  Tilen Majerle <tilen@majerle.eu>
+ * \brief   Render statistics
+ *  
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2017 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software, 
+    and to permit persons to whom the Software is furnished to do so, 
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GUI_STATS_H
+#define GUI_STATS_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_UTILS
+ * \{
+ */
+#include "gui_utils.h"
+
+/**
+ * \defgroup        GUI_STATS Render statistics
+ * \brief           Per frame counters of drawing work and processing time
+ * \{
+ *
+ * Counters are collected during \ref GUI_Process calls and saved when new frame is drawn.
+ * Low-level drawing calls are counted by wrappers around functions set in \ref GUI_LL_t structure,
+ * time is read with \ref GUI_LL_t.GetTime function of low-level driver.
+ *
+ * Statistics are only available when \ref GUI_USE_STATS is enabled in configuration
+ */
+
+#if defined(GUI_INTERNAL) || defined(DOXYGEN)
+
+#if GUI_USE_STATS || defined(DOXYGEN)
+
+/**
+ * \brief           Increase counter of current frame
+ * \param[in]       field: Member of \ref GUI_STATS_t structure
+ * \hideinitializer
+ */
+#define __GUI_STATS_INC(field)              (GUI.Stats.field++)
+
+/**
+ * \brief           Add value to counter of current frame
+ * \param[in]       field: Member of \ref GUI_STATS_t structure
+ * \param[in]       val: Value to add
+ * \hideinitializer
+ */
+#define __GUI_STATS_ADD(field, val)         (GUI.Stats.field += (val))
+
+/**
+ * \brief           Get current time for statistics
+ * \retval          Time in units of microseconds or 0 if low-level driver does not support it
+ * \hideinitializer
+ */
+#define __GUI_STATS_GetTime()               (GUI.LL.GetTime ? GUI.LL.GetTime(&GUI.LCD) : 0)
+
+/**
+ * \brief           Add time elapsed since start to time counter and set start to current time
+ * \param[in]       field: Time member of \ref GUI_STATS_t structure
+ * \param[in,out]   start: Variable with start time
+ * \hideinitializer
+ */
+#define __GUI_STATS_TIME(field, start)      do {    \
+    uint32_t __now = __GUI_STATS_GetTime();         \
+    GUI.Stats.field += __now - (start);             \
+    (start) = __now;                                \
+} while (0)
+
+/**
+ * \brief           Install counting wrappers around low-level drawing functions
+ * \note            Must be called after low-level driver has set \ref GUI_LL_t functions
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ */
+void __GUI_STATS_Init(void);
+
+/**
+ * \brief           Save counters of current frame and reset them for next frame
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ */
+void __GUI_STATS_FrameDone(void);
+
+#else /* GUI_USE_STATS || defined(DOXYGEN) */
+#define __GUI_STATS_INC(field)
+#define __GUI_STATS_ADD(field, val)
+#define __GUI_STATS_GetTime()               0
+#define __GUI_STATS_TIME(field, start)
+#define __GUI_STATS_Init()
+#define __GUI_STATS_FrameDone()
+#endif /* !(GUI_USE_STATS || defined(DOXYGEN)) */
+
+#endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
+
+#if GUI_USE_STATS || defined(DOXYGEN)
+
+/**
+ * \brief           Get statistics of last drawn frame
+ * \param[out]      *stats: Pointer to \ref GUI_STATS_t structure to fill
+ * \retval          1: Statistics copied
+ * \retval          0: No frame has been drawn yet
+ */
+uint8_t GUI_STATS_Get(GUI_STATS_t* stats);
+
+#endif /* GUI_USE_STATS || defined(DOXYGEN) */
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
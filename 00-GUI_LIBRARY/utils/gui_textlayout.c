@@ -0,0 +1,213 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_textlayout.h"
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+#define LAYOUT_HASH_BITS            5               /* Number of bits for hash table index */
+#define LAYOUT_HASH_SIZE            (1 << LAYOUT_HASH_BITS) /* Number of buckets in hash table */
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+static GUI_TEXTLAYOUT_t* Table[LAYOUT_HASH_SIZE];   /* Hash table of cached layouts */
+static GUI_TEXTLAYOUT_t* Newest;                    /* Most recently used layout */
+static GUI_TEXTLAYOUT_t* Oldest;                    /* Least recently used layout */
+static size_t CacheSize;                            /* Number of bytes used by cached layouts */
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Get FNV-1a hash of string content and string length */
+static
+uint32_t __GetStringHash(const GUI_Char* str, size_t* len) {
+    uint32_t hash = 0x811C9DC5UL;
+    const GUI_Char* s;
+    
+    for (s = str; *s; s++) {
+        hash = (hash ^ *s) * (uint32_t)0x01000193;
+    }
+    *len = s - str;
+    return hash;
+}
+
+/* Get hash table index for layout key */
+static
+uint32_t __GetIndex(uint32_t hash, const GUI_FONT_t* font, GUI_iDim_t width) {
+    hash ^= (uint32_t)((uintptr_t)font >> 2) ^ ((uint32_t)width << 16);
+    hash *= (uint32_t)0x9E3779B1;                   /* Multiplicative hashing, top bits are used as index */
+    return hash >> (32 - LAYOUT_HASH_BITS);
+}
+
+/* Check if layout has been created with the same drawing parameters */
+static
+uint8_t __IsSameDraw(const GUI_TEXTLAYOUT_t* l, const GUI_Char* str, const GUI_FONT_t* font, GUI_iDim_t width, GUI_Dim_t lineHeight, uint8_t flags) {
+    return l->Str == str && l->Font == font && l->Width == width &&
+        l->LineHeight == lineHeight && l->Flags == flags;
+}
+
+/* Remove entry from list of used entries */
+static
+void __UnlinkEntry(GUI_TEXTLAYOUT_t* l) {
+    if (l->Newer) {
+        l->Newer->Older = l->Older;
+    } else {
+        Newest = l->Older;
+    }
+    if (l->Older) {
+        l->Older->Newer = l->Newer;
+    } else {
+        Oldest = l->Newer;
+    }
+}
+
+/* Put entry to the top of list of used entries */
+static
+void __LinkEntry(GUI_TEXTLAYOUT_t* l) {
+    l->Newer = NULL;
+    l->Older = Newest;
+    if (Newest) {
+        Newest->Newer = l;
+    } else {
+        Oldest = l;
+    }
+    Newest = l;
+}
+
+/* Remove entry from cache and free its memory */
+static
+void __FreeEntry(GUI_TEXTLAYOUT_t* l) {
+    GUI_TEXTLAYOUT_t** pp;
+    
+    for (pp = &Table[__GetIndex(l->Hash, l->Font, l->Width)]; *pp != l; pp = &(*pp)->Next) {}
+    *pp = l->Next;                                  /* Remove from hash bucket */
+    __UnlinkEntry(l);
+    CacheSize -= l->Size;
+    __GUI_MEMFREE(l);
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+const GUI_TEXTLAYOUT_t* __GUI_TEXTLAYOUT_Get(const GUI_Char* str, const GUI_FONT_t* font, GUI_iDim_t width, GUI_Dim_t lineHeight, uint8_t flags) {
+    GUI_TEXTLAYOUT_t* l;
+    uint32_t hash;
+    size_t len;
+    
+    if (!Newest) {                                  /* Cache is empty */
+        return NULL;
+    }
+    
+    hash = __GetStringHash(str, &len);
+    for (l = Table[__GetIndex(hash, font, width)]; l; l = l->Next) {
+        if (l->Hash == hash && l->Length == len && __IsSameDraw(l, str, font, width, lineHeight, flags)) {
+            if (l != Newest) {                      /* Mark entry as most recently used */
+                __UnlinkEntry(l);
+                __LinkEntry(l);
+            }
+            return l;
+        }
+    }
+    return NULL;
+}
+
+GUI_TEXTLAYOUT_t* __GUI_TEXTLAYOUT_Add(const GUI_Char* str, const GUI_FONT_t* font, GUI_iDim_t width, GUI_Dim_t lineHeight, uint8_t flags, size_t lines) {
+    GUI_TEXTLAYOUT_t *l, *next;
+    GUI_TEXTLAYOUT_t** bucket;
+    size_t size = sizeof(*l) + lines * sizeof(GUI_TEXTLAYOUT_Line_t);
+    uint32_t hash;
+    size_t len;
+    
+    if (size > GUI_TEXTLAYOUT_CACHE_SIZE) {         /* Layout can never fit to cache */
+        return NULL;
+    }
+    
+    /**
+     * Content of string has changed, remove old layout
+     * so texts edited in place do not fill the cache
+     */
+    for (l = Newest; l; l = next) {
+        next = l->Older;
+        if (__IsSameDraw(l, str, font, width, lineHeight, flags)) {
+            __FreeEntry(l);
+        }
+    }
+    while (Oldest && CacheSize + size > GUI_TEXTLAYOUT_CACHE_SIZE) {
+        __FreeEntry(Oldest);                        /* Free least recently used layouts */
+    }
+    
+    l = __GUI_MEMALLOC(size);                       /* Allocate memory for layout and lines */
+    if (!l) {
+        return NULL;
+    }
+    hash = __GetStringHash(str, &len);
+    l->Size = size;
+    l->Str = str;
+    l->Length = len;
+    l->Hash = hash;
+    l->Font = font;
+    l->Width = width;
+    l->LineHeight = lineHeight;
+    l->Flags = flags;
+    l->LinesCount = lines;
+    
+    bucket = &Table[__GetIndex(hash, font, width)];
+    l->Next = *bucket;                              /* Add entry to hash bucket */
+    *bucket = l;
+    __LinkEntry(l);
+    CacheSize += size;
+    return l;
+}
+
+void __GUI_TEXTLAYOUT_Invalidate(const GUI_Char* str) {
+    GUI_TEXTLAYOUT_t *l, *next;
+    
+    if (!str) {
+        return;
+    }
+    for (l = Newest; l; l = next) {                 /* Check all layouts */
+        next = l->Older;
+        if (l->Str == str) {
+            __FreeEntry(l);
+        }
+    }
+}
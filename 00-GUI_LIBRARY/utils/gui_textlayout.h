@@ -0,0 +1,119 @@
+/**
+ * \author  Tilen Majerle <tilen@majerle.eu>
+ * \brief   Text layout cache
+ *  
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2017 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software, 
+    and to permit persons to whom the Software is furnished to do so, 
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GUI_TEXTLAYOUT_H
+#define GUI_TEXTLAYOUT_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_UTILS
+ * \{
+ */
+#include "gui_utils.h"
+
+/**
+ * \defgroup        GUI_TEXTLAYOUT Text layout cache
+ * \brief           Cache of line breaks and widths of drawn texts
+ * \{
+ *
+ * Before text is drawn, it is measured and wrapped to lines for drawing rectangle.
+ * Result is kept in RAM and found by string pointer and content, font, rectangle width,
+ * line height and font flags, so unchanged texts are drawn again without measurement.
+ *
+ * Memory used by cache is limited with \ref GUI_TEXTLAYOUT_CACHE_SIZE.
+ * Least recently used layouts are freed when limit is reached.
+ */
+
+#if defined(GUI_INTERNAL) || defined(DOXYGEN)
+
+/**
+ * \brief           Get pointer to array of lines of layout
+ * \param[in]       l: Pointer to \ref GUI_TEXTLAYOUT_t layout
+ * \retval          Pointer to first \ref GUI_TEXTLAYOUT_Line_t line
+ */
+#define __GUI_TEXTLAYOUT_GetLines(l)    ((GUI_TEXTLAYOUT_Line_t *)((uint8_t *)(l) + sizeof(GUI_TEXTLAYOUT_t)))
+
+/**
+ * \brief           Get cached layout of text
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       *str: Pointer to string to draw
+ * \param[in]       *font: Pointer to \ref GUI_FONT_t font structure
+ * \param[in]       width: Width of drawing rectangle
+ * \param[in]       lineHeight: Line height
+ * \param[in]       flags: Font flags used for drawing
+ * \retval          > 0: Pointer to \ref GUI_TEXTLAYOUT_t layout
+ * \retval          0: Layout is not in cache
+ */
+const GUI_TEXTLAYOUT_t* __GUI_TEXTLAYOUT_Get(const GUI_Char* str, const GUI_FONT_t* font, GUI_iDim_t width, GUI_Dim_t lineHeight, uint8_t flags);
+
+/**
+ * \brief           Add new layout of text to cache
+ *
+ *                  Previous layout of the same string with other content is removed
+ *
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       *str: Pointer to string to draw
+ * \param[in]       *font: Pointer to \ref GUI_FONT_t font structure
+ * \param[in]       width: Width of drawing rectangle
+ * \param[in]       lineHeight: Line height
+ * \param[in]       flags: Font flags used for drawing
+ * \param[in]       lines: Number of lines in layout
+ * \retval          > 0: Pointer to \ref GUI_TEXTLAYOUT_t layout with key set, rectangle and lines must be set by caller
+ * \retval          0: Layout does not fit to cache or memory allocation failed
+ */
+GUI_TEXTLAYOUT_t* __GUI_TEXTLAYOUT_Add(const GUI_Char* str, const GUI_FONT_t* font, GUI_iDim_t width, GUI_Dim_t lineHeight, uint8_t flags, size_t lines);
+
+/**
+ * \brief           Remove all layouts of string from cache
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       *str: Pointer to string
+ */
+void __GUI_TEXTLAYOUT_Invalidate(const GUI_Char* str);
+
+#endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -56,7 +56,7 @@ const static GUI_Color_t Colors[] = {
 const static GUI_WIDGET_t Widget = {
     .Name = _GT("EDITTEXT"),                        /*!< Widget name */
     .Size = sizeof(GUI_EDITTEXT_t),                 /*!< Size of widget for memory allocation */
-    .Flags = 0,                                     /*!< List of widget flags */
+    .Flags = GUI_FLAG_WIDGET_OPAQUE,                /*!< List of widget flags */
     .Callback = GUI_EDITTEXT_Callback,              /*!< Control function */
     .Colors = Colors,                               /*!< List of default colors */
     .ColorsCount = GUI_COUNT_OF(Colors),            /*!< Number of colors */
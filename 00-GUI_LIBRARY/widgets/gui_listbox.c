@@ -59,7 +59,7 @@ const static GUI_Color_t Colors[] = {
 const static GUI_WIDGET_t Widget = {
     .Name = _GT("LISTBOX"),                         /*!< Widget name */
     .Size = sizeof(GUI_LISTBOX_t),                  /*!< Size of widget for memory allocation */
-    .Flags = 0,                                     /*!< List of widget flags */
+    .Flags = GUI_FLAG_WIDGET_OPAQUE,                /*!< List of widget flags */
     .Callback = GUI_LISTBOX_Callback,               /*!< Callback function */
     .Colors = Colors,
     .ColorsCount = GUI_COUNT_OF(Colors),            /*!< Define number of colors */
@@ -131,6 +131,7 @@ uint8_t GUI_PROGBAR_Callback(GUI_HANDLE_p h, GUI_WC_t ctrl, void* param, void* r
                     GUI_DRAW_WriteText(disp, __GUI_WIDGET_GetFont(h), text, &f);
                 }
             }
+            return 1;
         }
 #if GUI_USE_TOUCH
         case GUI_WC_TouchStart: {
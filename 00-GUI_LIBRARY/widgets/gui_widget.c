@@ -79,6 +79,7 @@ uint8_t __RemoveWidget(GUI_HANDLE_p h) {
     }
     
     __GUI_WIDGET_InvalidateWithParent(h);           /* Invalidate object and its parent */
+    __GUI_SCRATCH_DropCache(h);                     /* Return cached layer to pool */
     __GUI_WIDGET_FreeTextMemory(h);                 /* Free text memory */
     if (__GH(h)->Timer) {                           /* Check timer memory */
         __GUI_TIMER_Remove(&__GH(h)->Timer);        /* Free timer memory */
@@ -86,6 +87,11 @@ uint8_t __RemoveWidget(GUI_HANDLE_p h) {
     if (__GH(h)->Colors) {                          /* Check colors memory */
         __GUI_MEMFREE(__GH(h)->Colors);             /* Free colors memory */
     }
+    if (__GUI_WIDGET_AllowChildren(h) && __GHR(h)->Grid) {  /* Check spatial index memory */
+        __GUI_GRID_Free(__GHR(h)->Grid);            /* Free index memory */
+        __GUI_MEMFREE(__GHR(h)->Grid);
+    }
+    __GUI_IDMAP_Remove(&GUI.IdMap, __GUI_WIDGET_GetId(h), h);   /* Remove widget from ID map */
     __GUI_LINKEDLIST_WidgetRemove(h);               /* Remove entry from linked list of parent widget */
     __GUI_MEMFREE(h);                               /* Free memory for widget */
     
@@ -134,69 +140,226 @@ void __RemoveWidgets(GUI_HANDLE_p parent) {
     }
 }
 
-/* Get where on LCD is widget visible and what is visible width and height on screen */
+/* Calculate widget width according to current setup (expanded, fill, percent, etc.) */
 static
-uint8_t __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(GUI_HANDLE_p h, GUI_iDim_t* x1, GUI_iDim_t* y1, GUI_iDim_t* x2, GUI_iDim_t* y2) {
-    GUI_iDim_t x, y, wi, hi;
+GUI_Dim_t __CalculateWidth(GUI_HANDLE_p h) {
+    if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_EXPANDED)) {   /* Maximize window over parent */
+        return __GUI_WIDGET_GetParentInnerWidth(h); /* Return parent inner width */
+    } else if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_WIDTH_FILL)) {  /* "fill_parent" mode for width */
+        GUI_iDim_t parent = __GUI_WIDGET_GetParentInnerWidth(h);
+        if (parent > __GUI_WIDGET_GetRelativeX(h)) {
+            return parent - __GUI_WIDGET_GetRelativeX(h);   /* Return widget width */
+        }
+    } else if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_WIDTH_PERCENT)) {   /* Percentage width */
+        GUI_Dim_t parent = __GUI_WIDGET_GetParentInnerWidth(h);
+        return __GUI_WIDGET_GeomSize(__GH(h)->Width, parent);
+    } else {                                        /* Normal width */
+        return __GH(h)->Width;
+    }
+    return 0;
+}
+
+/* Calculate widget height according to current setup (expanded, fill, percent, etc.) */
+static
+GUI_Dim_t __CalculateHeight(GUI_HANDLE_p h) {
+    if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_EXPANDED)) {   /* Maximize window over parent */
+        return __GUI_WIDGET_GetParentInnerHeight(h);/* Return parent inner height */
+    } else if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_HEIGHT_FILL)) { /* "fill_parent" mode for height */
+        GUI_Dim_t parent = __GUI_WIDGET_GetParentInnerHeight(h);
+        if (parent > __GUI_WIDGET_GetRelativeY(h)) {
+            return parent - __GUI_WIDGET_GetRelativeY(h);   /* Return widget width */
+        }
+    } else if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_HEIGHT_PERCENT)) {  /* Percentage height */
+        return __GUI_WIDGET_GeomSize(__GH(h)->Height, __GUI_WIDGET_GetParentInnerHeight(h));
+    } else {                                        /* Normal height */
+        return __GH(h)->Height;
+    }
+    return 0;
+}
+
+/**
+ * Get widget geometry, calculate it first if cached values are not valid anymore.
+ * Values are valid when widget itself did not change and parent values are the same as used for calculation,
+ * change of widget is therefore seen only by widget and its children widgets
+ */
+static
+const GUI_Geometry_t* __GetGeometry(GUI_HANDLE_p h) {
+    GUI_Geometry_t* g = &__GH(h)->Geometry;
+    GUI_HANDLE_p p;
+    const GUI_Geometry_t* pg;
+    GUI_iDim_t x1, y1, x2, y2;
     
-    __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
+    /* Check values of widget and all parents without recursion first */
+    for (p = h; __GH(p)->Geometry.Valid; p = __GH(p)->Parent) {
+        if (!__GH(p)->Parent) {                     /* Cached values are still valid */
+            return g;
+        }
+        if (__GH(p)->Geometry.ParentGen != __GH(__GH(p)->Parent)->Geometry.Gen) {
+            break;
+        }
+    }
     
-    x = __GUI_WIDGET_GetAbsoluteX(h);               /* Get absolute X position */
-    y = __GUI_WIDGET_GetAbsoluteY(h);               /* Get absolute Y position */
-    wi = __GUI_WIDGET_GetWidth(h);                  /* Get absolute width */
-    hi = __GUI_WIDGET_GetHeight(h);                 /* Get absolute height */
+    p = __GH(h)->Parent;
+    pg = p ? __GetGeometry(p) : NULL;               /* Parent values are calculated first */
+    if (g->Valid && (!pg || g->ParentGen == pg->Gen)) { /* Widget values are still valid */
+        return g;
+    }
     
     /**
-     * Set widget visible positions with X and Y coordinates
+     * Calculate size first and then position, both use parent values
+     * which are calculated on first call and used from cache later
      */
-    *x1 = x;
-    *y1 = y;
-    *x2 = x + wi;
-    *y2 = y + hi;
+    g->Width = __CalculateWidth(h);
+    g->Height = __CalculateHeight(h);
+    g->X = __GUI_WIDGET_GetRelativeX(h);
+    g->Y = __GUI_WIDGET_GetRelativeY(h);
     
     /**
-     * Check if widget is hidden by any parent or any parent is hidden by its parent
+     * Get parent inner area where widget can be visible
      */
-    for (; h; h = __GH(h)->Parent) {
-        x = __GUI_WIDGET_GetParentAbsoluteX(h);     /* Parent absolute X position for inner widgets */
-        y = __GUI_WIDGET_GetParentAbsoluteY(h);     /* Parent absolute Y position for inner widgets */
-        wi = __GUI_WIDGET_GetParentInnerWidth(h);   /* Get parent inner width */
-        hi = __GUI_WIDGET_GetParentInnerHeight(h);  /* Get parent inner height */
-    
-        if (*x1 < x)        { *x1 = x; }
-        if (*x2 > x + wi)   { *x2 = x + wi; }
-        if (*y1 < y)        { *y1 = y; }
-        if (*y2 > y + hi)   { *y2 = y + hi; }
+    if (pg) {
+        x1 = pg->X + __GUI_WIDGET_GetPaddingLeft(p);    /* Parent inner area on LCD */
+        y1 = pg->Y + __GUI_WIDGET_GetPaddingTop(p);
+        x2 = x1 + pg->Width - (__GUI_WIDGET_GetPaddingLeft(p) + __GUI_WIDGET_GetPaddingRight(p));
+        y2 = y1 + pg->Height - (__GUI_WIDGET_GetPaddingTop(p) + __GUI_WIDGET_GetPaddingBottom(p));
+        
+        g->X += x1 - __GHR(p)->ScrollX;             /* Widget is moved by parent scroll */
+        g->Y += y1 - __GHR(p)->ScrollY;
+        
+        /* Parent inner area is also limited with visible area of parent */
+        if (x1 < pg->Visible.X1)    { x1 = pg->Visible.X1; }
+        if (x2 > pg->Visible.X2)    { x2 = pg->Visible.X2; }
+        if (y1 < pg->Visible.Y1)    { y1 = pg->Visible.Y1; }
+        if (y2 > pg->Visible.Y2)    { y2 = pg->Visible.Y2; }
+    } else {
+        x1 = 0;
+        y1 = 0;
+        x2 = GUI.LCD.Width;
+        y2 = GUI.LCD.Height;
     }
     
+    /**
+     * Set widget visible positions and clip them to parent area
+     */
+    g->Visible.X1 = g->X;
+    g->Visible.Y1 = g->Y;
+    g->Visible.X2 = g->X + g->Width;
+    g->Visible.Y2 = g->Y + g->Height;
+    if (g->Visible.X1 < x1)     { g->Visible.X1 = x1; }
+    if (g->Visible.X2 > x2)     { g->Visible.X2 = x2; }
+    if (g->Visible.Y1 < y1)     { g->Visible.Y1 = y1; }
+    if (g->Visible.Y2 > y2)     { g->Visible.Y2 = y2; }
+    
+    g->ParentGen = pg ? pg->Gen : 0;                /* Values are valid now */
+    g->Gen++;                                       /* Children widgets must calculate values again */
+    g->Valid = 1;
+    return g;
+}
+
+/* Get where on LCD is widget visible and what is visible width and height on screen */
+static
+uint8_t __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(GUI_HANDLE_p h, GUI_iDim_t* x1, GUI_iDim_t* y1, GUI_iDim_t* x2, GUI_iDim_t* y2) {
+    const GUI_Geometry_t* g;
+    
+    __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
+    
+    g = __GetGeometry(h);                           /* Get visible part of widget, clipped by all parents */
+    *x1 = g->Visible.X1;
+    *y1 = g->Visible.Y1;
+    *x2 = g->Visible.X2;
+    *y2 = g->Visible.Y2;
+    
     return 1;
 }
 
 /* Set widget clipping region */
 static
 uint8_t __SetClippingRegion(GUI_HANDLE_p h) {
-    GUI_Dim_t x1, y1, x2, y2;
+    GUI_Display_t rect;
     
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     
     /* Get visible widget part and absolute position on screen */
-    __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(h, &x1, &y1, &x2, &y2);
+    __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(h, &rect.X1, &rect.Y1, &rect.X2, &rect.Y2);
+    
+    /* Limit region to LCD area */
+    if (rect.X1 < 0)                { rect.X1 = 0; }
+    if (rect.Y1 < 0)                { rect.Y1 = 0; }
+    if (rect.X2 > GUI.LCD.Width)    { rect.X2 = GUI.LCD.Width; }
+    if (rect.Y2 > GUI.LCD.Height)   { rect.Y2 = GUI.LCD.Height; }
     
-    /* Set invalid clipping region */
-    if (GUI.Display.X1 > x1)    { GUI.Display.X1 = x1; }
-    if (GUI.Display.X2 < x2)    { GUI.Display.X2 = x2; }
-    if (GUI.Display.Y1 > y1)    { GUI.Display.Y1 = y1; }
-    if (GUI.Display.Y2 < y2)    { GUI.Display.Y2 = y2; }
+    /* Add visible part to list of invalid regions */
+    __GUI_REGION_Add(&GUI.Region, &rect);
     
     return 1;
 }
 
+#if GUI_WIDGET_GRID_CHILDREN || defined(DOXYGEN)
+/**
+ * Get spatial index of children widgets, update it first for changed children widgets.
+ * Index is built again only when order of children widgets or geometry of parent widget changed
+ */
+GUI_Grid_t* __GUI_WIDGET_GetChildrenGrid(GUI_HANDLE_p parent) {
+    GUI_Grid_t* grid = __GHR(parent)->Grid;
+    const GUI_Geometry_t* pg = __GetGeometry(parent);
+    GUI_HANDLE_p h;
+    size_t cnt = 0, i;
+    
+    if (grid && grid->Valid && grid->ParentGen == pg->Gen) {    /* Index matches children widgets */
+        for (i = 0; i < grid->DirtyCount; i++) {    /* Move changed widgets to new cells */
+            h = grid->Items[grid->Dirty[i]];
+            if (h && !__GUI_GRID_Move(grid, grid->Dirty[i], &__GetGeometry(h)->Visible)) {
+                break;                              /* Cell is full, build index again */
+            }
+        }
+        if (grid->Valid) {
+            grid->DirtyCount = 0;
+            return grid;
+        }
+    }
+    for (h = __GUI_LINKEDLIST_WidgetGetNext(__GHR(parent), NULL); h; h = __GUI_LINKEDLIST_WidgetGetNext(NULL, h)) {
+        cnt++;
+    }
+    if (cnt < GUI_WIDGET_GRID_CHILDREN) {           /* Not worth to use index for small number of widgets */
+        if (grid) {
+            __GUI_GRID_Free(grid);
+            __GUI_MEMFREE(__GHR(parent)->Grid);
+        }
+        return NULL;
+    }
+    if (!grid) {
+        grid = __GUI_MEMALLOC(sizeof(*grid));       /* Allocate memory for index */
+        if (!grid) {
+            return NULL;
+        }
+        __GHR(parent)->Grid = grid;
+    }
+    if (!__GUI_GRID_Reserve(grid, cnt)) {
+        return NULL;
+    }
+    
+    /* Set widgets to index in linked list order */
+    cnt = 0;
+    for (h = __GUI_LINKEDLIST_WidgetGetNext(__GHR(parent), NULL); h; h = __GUI_LINKEDLIST_WidgetGetNext(NULL, h)) {
+        grid->Items[cnt] = h;
+        grid->Rects[cnt] = __GetGeometry(h)->Visible;
+        __GH(h)->Index = cnt++;
+    }
+    if (!__GUI_GRID_Build(grid, &pg->Visible)) {    /* Children widgets are visible only inside parent */
+        return NULL;
+    }
+    grid->ParentGen = pg->Gen;                      /* Index is valid for current geometry of parent */
+    return grid;
+}
+#endif /* GUI_WIDGET_GRID_CHILDREN || defined(DOXYGEN) */
+
 /* Invalidate widget procedure */
 static
 uint8_t __InvalidatePrivate(GUI_HANDLE_p h, uint8_t setclipping) {
     GUI_HANDLE_p h1, h2;
-    GUI_iDim_t h1x1, h1x2, h2x1, h2x2;
-    GUI_iDim_t h1y1, h1y2, h2y1, h2y2;
+#if GUI_WIDGET_GRID_CHILDREN
+    GUI_Grid_t* grid = NULL;
+#endif /* GUI_WIDGET_GRID_CHILDREN */
     
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     
@@ -224,19 +387,42 @@ uint8_t __InvalidatePrivate(GUI_HANDLE_p h, uint8_t setclipping) {
     if (__GUI_WIDGET_IsTransparent(h1)) {
         __InvalidatePrivate(__GH(h1)->Parent, 0);   /* Invalidate parent widget */
     }
-    for (; h1; h1 = __GUI_LINKEDLIST_WidgetGetNext(NULL, h1)) {
-        __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(h1, &h1x1, &h1y1, &h1x2, &h1y2); /* Get visible position on LCD for widget */
-        for (h2 = __GUI_LINKEDLIST_WidgetGetNext(NULL, h1); h2; h2 = __GUI_LINKEDLIST_WidgetGetNext(NULL, h2)) {
-            __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(h2, &h2x1, &h2y1, &h2x2, &h2y2);
-            if (
-                __GUI_WIDGET_GetFlag(h2, GUI_FLAG_REDRAW) ||    /* Flag is already set */
-                !__GUI_RECT_MATCH(                  /* Widgets are not one over another */
-                    h1x1, h1y1, h1x2, h1y2,
-                    h2x1, h2y1, h2x2, h2y2)
-            ) {
+    
+    /**
+     * Widget which is redrawn may cover widgets above it, which must be redrawn too.
+     * Redrawn widget above may again cover other widgets above it, check them too.
+     *
+     * Parent with many children uses spatial index to check only widgets
+     * which are in the same area instead of all widgets above
+     */
+#if GUI_WIDGET_GRID_CHILDREN
+    if (__GH(h)->Parent && !__GUI_LINKEDLIST_IsWidgetLast(h)) { /* Last widget can't cover any sibling */
+        grid = __GUI_WIDGET_GetChildrenGrid(__GH(h)->Parent);
+    }
+    if (grid && __GUI_GRID_IsItem(grid, h)) {       /* Widget must be part of index */
+        size_t i, cnt = __GUI_GRID_FindAbove(grid, __GH(h)->Index);
+        for (i = 0; i < cnt; i++) {
+            __GUI_WIDGET_SetFlag(grid->Items[grid->Found[i]], GUI_FLAG_REDRAW); /* Redraw widget on next loop */
+        }
+    } else
+#endif /* GUI_WIDGET_GRID_CHILDREN */
+    {
+        for (; h1; h1 = __GUI_LINKEDLIST_WidgetGetNext(NULL, h1)) {
+            const GUI_Display_t* r1;
+            if (!__GUI_WIDGET_GetFlag(h1, GUI_FLAG_REDRAW)) {   /* Widget is not redrawn and can't cover others */
                 continue;
             }
-            __GUI_WIDGET_SetFlag(h2, GUI_FLAG_REDRAW);  /* Redraw widget on next loop */
+            r1 = &__GetGeometry(h1)->Visible;       /* Get visible position on LCD for widget */
+            for (h2 = __GUI_LINKEDLIST_WidgetGetNext(NULL, h1); h2; h2 = __GUI_LINKEDLIST_WidgetGetNext(NULL, h2)) {
+                const GUI_Display_t* r2;
+                if (__GUI_WIDGET_GetFlag(h2, GUI_FLAG_REDRAW)) {    /* Flag is already set */
+                    continue;
+                }
+                r2 = &__GetGeometry(h2)->Visible;
+                if (r1->X1 < r2->X2 && r2->X1 < r1->X2 && r1->Y1 < r2->Y2 && r2->Y1 < r1->Y2) { /* Widgets are one over another */
+                    __GUI_WIDGET_SetFlag(h2, GUI_FLAG_REDRAW);  /* Redraw widget on next loop */
+                }
+            }
         }
     }
     
@@ -269,19 +455,60 @@ static
 GUI_HANDLE_p __GetWidgetById(GUI_HANDLE_p parent, GUI_ID_t id, uint8_t deep) {
     GUI_HANDLE_p h;
     
-    for (h = __GUI_LINKEDLIST_WidgetGetNext(__GHR(parent), NULL); h; h = __GUI_LINKEDLIST_WidgetGetNext(NULL, h)) {
+    for (h = __GUI_LINKEDLIST_WidgetGetNext(__GHR(parent), NULL); h; 
+            h = deep ? __GUI_WIDGET_GetNextInTree(parent, h, 1) : __GUI_LINKEDLIST_WidgetGetNext(NULL, h)) {
         if (__GUI_WIDGET_GetId(h) == id) {          /* Compare ID values */
             return h;
-        } else if (deep && __GUI_WIDGET_AllowChildren(h)) { /* Check children if possible */
-            GUI_HANDLE_p tmp = __GetWidgetById(h, id, deep);
-            if (tmp) {
-                return tmp;
-            }
         }
     }
     return 0;
 }
 
+/* Add all widgets from tree to ID map */
+static
+uint8_t __AddWidgetsToIdMap(GUI_HANDLE_p parent) {
+    GUI_HANDLE_p h;
+    
+    for (h = __GUI_LINKEDLIST_WidgetGetNext(__GHR(parent), NULL); h; h = __GUI_WIDGET_GetNextInTree(parent, h, 1)) {
+        if (!__GUI_IDMAP_Add(&GUI.IdMap, __GUI_WIDGET_GetId(h), h)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Get first widget by given ID in tree order, use ID map when possible */
+static
+GUI_HANDLE_p __FindWidgetById(GUI_ID_t id) {
+    GUI_IdMapEntry_t* e;
+    GUI_HANDLE_p h;
+    
+    /**
+     * Map is built from tree on first search or after memory allocation failed,
+     * later it is updated by widget create and remove functions
+     */
+    if (!GUI.IdMap.Valid) {
+        GUI.IdMap.Valid = 1;
+        __AddWidgetsToIdMap(NULL);                  /* Map is reset on failure */
+    }
+    if (!GUI.IdMap.Valid) {                         /* Map is not available */
+        return __GetWidgetById(NULL, id, 1);        /* Search widget tree */
+    }
+    
+    e = __GUI_IDMAP_Find(&GUI.IdMap, id);
+    if (!e) {                                       /* There is no widget with this ID */
+        return 0;
+    }
+    if (e->Count == 1 && e->Handle) {               /* Only one widget with this ID */
+        return e->Handle;
+    }
+    h = __GetWidgetById(NULL, id, 1);               /* First widget in tree order is returned */
+    if (e->Count == 1) {
+        e->Handle = h;                              /* Save remaining widget for next time */
+    }
+    return h;
+}
+
 /* Returns first common widget between 2 widgets */
 static
 GUI_HANDLE_p __GetCommonParentWidget(GUI_HANDLE_p h1, GUI_HANDLE_p h2) {
@@ -301,20 +528,25 @@ GUI_HANDLE_p __GetCommonParentWidget(GUI_HANDLE_p h1, GUI_HANDLE_p h2) {
 
 /* Set widget size */
 static
-uint8_t __SetWidgetSize(GUI_HANDLE_p h, float wi, float hi) {
+uint8_t __SetWidgetSize(GUI_HANDLE_p h, GUI_Geom_t wi, GUI_Geom_t hi) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     
     if (wi != __GH(h)->Width || hi != __GH(h)->Height) {    /* Check any differences */
-        uint8_t invalidateSecond = 0;
+        GUI_Dim_t width = __GUI_WIDGET_GetWidth(h); /* Current size in units of pixels */
+        GUI_Dim_t height = __GUI_WIDGET_GetHeight(h);
         if (!__GUI_WIDGET_IsExpanded(h)) {          /* First invalidate current position if not expanded before change of size */
             __GUI_WIDGET_InvalidateWithParent(h);   /* Set old clipping region first */
-            if (wi > __GH(h)->Width || hi > __GH(h)->Height) {
-                invalidateSecond = 1;
-            }
         }
+        __GUI_TEXTLAYOUT_Invalidate(__GH(h)->Text); /* Text is wrapped for new width */
         __GH(h)->Width = wi;                        /* Set parameter */
         __GH(h)->Height = hi;                       /* Set parameter */
-        if (invalidateSecond) {                     /* Invalidate second time only if widget greater than before */
+        __GUI_WIDGET_GeometryChanged(h);            /* Cached geometry is not valid anymore */
+        
+        /**
+         * Invalidate second time only if widget is greater than before,
+         * sizes are compared in pixels as values may be in percent
+         */
+        if (!__GUI_WIDGET_IsExpanded(h) && (__GUI_WIDGET_GetWidth(h) > width || __GUI_WIDGET_GetHeight(h) > height)) {
             __GUI_WIDGET_InvalidateWithParent(h);   /* Set new clipping region */
         }
     }
@@ -323,7 +555,7 @@ uint8_t __SetWidgetSize(GUI_HANDLE_p h, float wi, float hi) {
 
 /* Set widget position */
 static
-uint8_t __SetWidgetPosition(GUI_HANDLE_p h, float x, float y) {
+uint8_t __SetWidgetPosition(GUI_HANDLE_p h, GUI_Geom_t x, GUI_Geom_t y) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     
     if (__GH(h)->X != x || __GH(h)->Y != y) {       /* Check any differences */
@@ -332,6 +564,7 @@ uint8_t __SetWidgetPosition(GUI_HANDLE_p h, float x, float y) {
         }
         __GH(h)->X = x;                             /* Set parameter */
         __GH(h)->Y = y;                             /* Set parameter */
+        __GUI_WIDGET_GeometryChanged(h);            /* Cached geometry is not valid anymore */
         if (!__GUI_WIDGET_IsExpanded(h)) {
             __GUI_WIDGET_InvalidateWithParent(h);   /* Set new clipping region */
         }
@@ -388,6 +621,56 @@ uint8_t __GUI_WIDGET_IsInsideClippingRegion(GUI_HANDLE_p h) {
     );
 }
 
+/* Check if widget is inside any region rectangle, starting at rectangle with start index */
+uint8_t __GUI_WIDGET_IsInsideRegion(GUI_HANDLE_p h, const GUI_Region_t* region, size_t start) {
+    GUI_Display_t rect;
+    __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h) && region); /* Check valid parameter */
+    
+    /* Get widget visible section */
+    __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(h, &rect.X1, &rect.Y1, &rect.X2, &rect.Y2);
+    return __GUI_REGION_Intersects(region, start, &rect);
+}
+
+/* Get visible part of widget on LCD, clipped by all parent widgets */
+uint8_t __GUI_WIDGET_GetVisibleRect(GUI_HANDLE_p h, GUI_Display_t* rect) {
+    __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h) && rect);   /* Check valid parameter */
+    return __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(h, &rect->X1, &rect->Y1, &rect->X2, &rect->Y2);
+}
+
+/* Get level of widget in tree, base widgets are on level 1 */
+static
+size_t __GetDepth(GUI_HANDLE_p h) {
+    size_t depth;
+    
+    for (depth = 0; h; h = __GH(h)->Parent) {
+        depth++;
+    }
+    return depth;
+}
+
+/**
+ * Get next widget after h in tree order below parent, children widgets are returned before next sibling
+ * when children parameter is set to 1, otherwise they are skipped.
+ * Tree is walked with parent pointers so no stack is needed regardless of tree depth
+ */
+GUI_HANDLE_p __GUI_WIDGET_GetNextInTree(GUI_HANDLE_p parent, GUI_HANDLE_p h, uint8_t children) {
+    GUI_HANDLE_p next;
+    
+    if (children && __GUI_WIDGET_AllowChildren(h)) {    /* Go to first child widget */
+        next = __GUI_LINKEDLIST_WidgetGetNext(__GHR(h), NULL);
+        if (next) {
+            return next;
+        }
+    }
+    for (; h != parent; h = __GH(h)->Parent) {      /* Go up until widget with next sibling is found */
+        next = __GUI_LINKEDLIST_WidgetGetNext(NULL, h);
+        if (next) {
+            return next;
+        }
+    }
+    return 0;
+}
+
 void __GUI_WIDGET_Init(void) {
     GUI_WINDOW_CreateDesktop(GUI_ID_WINDOW_BASE, NULL); /* Create base window object */
 }
@@ -401,79 +684,38 @@ uint8_t __GUI_WIDGET_ExecuteRemove(void) {
     return 0;
 }
 
+void __GUI_WIDGET_GeometryChanged(GUI_HANDLE_p h) {
+    __GH(h)->Geometry.Valid = 0;                    /* Values are calculated again on next use */
+    __GUI_SCRATCH_InvalidateCache(h);               /* Content of widget and its parents has changed */
+#if GUI_WIDGET_GRID_CHILDREN
+    if (__GH(h)->Parent && __GHR(__GH(h)->Parent)->Grid) {
+        __GUI_GRID_SetDirty(__GHR(__GH(h)->Parent)->Grid, h);   /* Widget is moved to new cells in index of parent */
+    }
+#endif /* GUI_WIDGET_GRID_CHILDREN */
+}
+
 GUI_Dim_t __GUI_WIDGET_GetWidth(GUI_HANDLE_p h) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
-    
-    if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_EXPANDED)) {   /* Maximize window over parent */
-        return __GUI_WIDGET_GetParentInnerWidth(h); /* Return parent inner width */
-    } else if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_WIDTH_FILL)) {  /* "fill_parent" mode for width */
-        GUI_iDim_t parent = __GUI_WIDGET_GetParentInnerWidth(h);
-        if (parent > __GUI_WIDGET_GetRelativeX(h)) {
-            return parent - __GUI_WIDGET_GetRelativeX(h);   /* Return widget width */
-        }
-    } else if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_WIDTH_PERCENT)) {   /* Percentage width */
-        GUI_Dim_t parent = __GUI_WIDGET_GetParentInnerWidth(h);
-        return GUI_ROUND(__GH(h)->Width * parent / 100);
-    } else {                                        /* Normal width */
-        return __GH(h)->Width;
-    }
-    return 0;
+    return __GetGeometry(h)->Width;                 /* Return cached width */
 }
 
 GUI_Dim_t __GUI_WIDGET_GetHeight(GUI_HANDLE_p h) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
-    
-    if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_EXPANDED)) {   /* Maximize window over parent */
-        return __GUI_WIDGET_GetParentInnerHeight(h);/* Return parent inner height */
-    } else if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_HEIGHT_FILL)) { /* "fill_parent" mode for height */
-        GUI_Dim_t parent = __GUI_WIDGET_GetParentInnerHeight(h);
-        if (parent > __GUI_WIDGET_GetRelativeY(h)) {
-            return parent - __GUI_WIDGET_GetRelativeY(h);   /* Return widget width */
-        }
-    } else if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_HEIGHT_PERCENT)) {  /* Percentage height */
-        return GUI_ROUND(__GH(h)->Height * __GUI_WIDGET_GetParentInnerHeight(h) / 100);
-    } else {                                        /* Normal height */
-        return __GH(h)->Height;
-    }
-    return 0;
+    return __GetGeometry(h)->Height;                /* Return cached height */
 }
 
 GUI_iDim_t __GUI_WIDGET_GetAbsoluteX(GUI_HANDLE_p h) {
-    GUI_HANDLE_p w = 0;
-    GUI_iDim_t out = 0;
-    
     if (!h) {                                       /* Check input value */
         return 0;                                   /* At left value */
     }
-    
-    /* If widget is not expanded, use actual value */
-    out = __GUI_WIDGET_GetRelativeX(h);             /* Get start relative position */
-    
-    /* Process all parent widgets to get real absolute screen value */
-    for (w = __GH(h)->Parent; w; w = __GH(w)->Parent) { /* Go through all parent windows */
-        out += __GUI_WIDGET_GetRelativeX(w) + __GUI_WIDGET_GetPaddingLeft(w);   /* Add X offset from parent and left padding of parent */
-        out -= __GHR(w)->ScrollX;                   /* Decrease by scroll value */
-    }
-    return out;
+    return __GetGeometry(h)->X;                     /* Return cached absolute position */
 }
 
 GUI_iDim_t __GUI_WIDGET_GetAbsoluteY(GUI_HANDLE_p h) {
-    GUI_HANDLE_p w = 0;
-    GUI_iDim_t out = 0;
-    
     if (!h) {                                       /* Check input value */
         return 0;                                   /* At top value */
     }
-    
-    /* If widget is not expanded, use actual value */
-    out = __GUI_WIDGET_GetRelativeY(h);             /* Get start relative position */
-    
-    /* Process all parent widgets to get real absolute screen value */
-    for (w = __GH(h)->Parent; w; w = __GH(w)->Parent) { /* Go through all parent windows */
-        out += __GUI_WIDGET_GetRelativeY(w) + __GUI_WIDGET_GetPaddingTop(w);    /* Add X offset from parent and left padding of parent */
-        out -= __GHR(w)->ScrollX;                   /* Decrease by scroll value */
-    }
-    return out;
+    return __GetGeometry(h)->Y;                     /* Return cached absolute position */
 }
 
 GUI_iDim_t __GUI_WIDGET_GetParentAbsoluteX(GUI_HANDLE_p h) {
@@ -510,6 +752,7 @@ uint8_t __GUI_WIDGET_Invalidate(GUI_HANDLE_p h) {
     uint8_t ret;
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     
+    __GUI_SCRATCH_InvalidateCache(h);               /* Content of widget and its parents has changed */
     ret = __InvalidatePrivate(h, 1);                /* Invalidate widget with clipping */
     
     if (
@@ -525,6 +768,7 @@ uint8_t __GUI_WIDGET_Invalidate(GUI_HANDLE_p h) {
 
 uint8_t __GUI_WIDGET_InvalidateWithParent(GUI_HANDLE_p h) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
+    __GUI_SCRATCH_InvalidateCache(h);               /* Content of widget and its parents has changed */
     __InvalidatePrivate(h, 1);                      /* Invalidate object with clipping */
     if (__GH(h)->Parent) {                          /* If parent exists, invalid only parent */
         __InvalidatePrivate(__GH(h)->Parent, 0);    /* Invalidate parent object without clipping */
@@ -554,6 +798,17 @@ uint8_t __GUI_WIDGET_Set3DStyle(GUI_HANDLE_p h, uint8_t enable) {
     return 1;
 }
 
+uint8_t __GUI_WIDGET_SetCache(GUI_HANDLE_p h, uint8_t enable) {
+    __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
+    if (enable) {
+        __GUI_WIDGET_SetFlag(h, GUI_FLAG_CACHE);    /* Content is cached on next redraw */
+    } else {
+        __GUI_WIDGET_ClrFlag(h, GUI_FLAG_CACHE);    /* Disable cache */
+        __GUI_SCRATCH_DropCache(h);                 /* Return cached layer to pool */
+    }
+    return 1;
+}
+
 /*******************************************/
 /**  Widget create and remove management  **/
 /*******************************************/
@@ -601,6 +856,17 @@ void* __GUI_WIDGET_Create(const GUI_WIDGET_t* widget, GUI_ID_t id, GUI_iDim_t x,
             }
         }
         
+        /**
+         * Redraw and touch walk widget tree with fixed size stack,
+         * widget nested deeper than GUI_WIDGET_MAX_DEPTH levels could not be drawn
+         */
+        if (__GetDepth(h) > GUI_WIDGET_MAX_DEPTH) {
+            __GUI_DEBUG("Widget tree is deeper than GUI_WIDGET_MAX_DEPTH, widget not created\r\n");
+            __GUI_MEMFREE(h);                       /* Clear widget memory */
+            return 0;
+        }
+        __GUI_WIDGET_GeometryChanged(h);            /* New widget has no valid geometry yet */
+        
         result = 1;                                 /* We are OK at starting point */
         __GUI_WIDGET_Callback(h, GUI_WC_PreInit, NULL, &result);    /* Notify internal widget library about init successful */
         
@@ -623,6 +889,7 @@ void* __GUI_WIDGET_Create(const GUI_WIDGET_t* widget, GUI_ID_t id, GUI_iDim_t x,
         __GUI_WIDGET_Callback(h, GUI_WC_ExcludeLinkedList, 0, &result);
         if (!result) {                              /* Check if widget should be added to linked list */
             __GUI_LINKEDLIST_WidgetAdd((GUI_HANDLE_ROOT_t *)__GH(h)->Parent, h);    /* Add entry to linkedlist of parent widget */
+            __GUI_IDMAP_Add(&GUI.IdMap, id, h);     /* Add widget to ID map */
         }
         __GUI_WIDGET_Callback(h, GUI_WC_Init, NULL, NULL);  /* Notify user about init successful */
         __GUI_WIDGET_Invalidate(h);                 /* Invalidate object */
@@ -651,6 +918,7 @@ uint8_t __GUI_WIDGET_Remove(GUI_HANDLE_p h) {
 uint8_t __GUI_WIDGET_SetFont(GUI_HANDLE_p h, GUI_Const GUI_FONT_t* font) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     if (__GH(h)->Font != font) {                    /* Any parameter changed */
+        __GUI_TEXTLAYOUT_Invalidate(__GH(h)->Text); /* Text is not drawn with old font anymore */
         __GH(h)->Font = font;                       /* Set parameter */
         __GUI_WIDGET_InvalidateWithParent(h);       /* Invalidate object */
     }
@@ -659,6 +927,7 @@ uint8_t __GUI_WIDGET_SetFont(GUI_HANDLE_p h, GUI_Const GUI_FONT_t* font) {
 
 uint8_t __GUI_WIDGET_SetText(GUI_HANDLE_p h, const GUI_Char* text) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
+    __GUI_TEXTLAYOUT_Invalidate(__GH(h)->Text);     /* Layout of old text is not used anymore */
     if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_DYNAMICTEXTALLOC)) {   /* Memory for text is dynamically allocated */
         if (__GH(h)->TextMemSize) {
             if (GUI_STRING_LengthTotal(text) > (__GH(h)->TextMemSize - 1)) {    /* Check string length */
@@ -711,6 +980,7 @@ uint8_t __GUI_WIDGET_AllocateTextMemory(GUI_HANDLE_p h, uint32_t size) {
 uint8_t __GUI_WIDGET_FreeTextMemory(GUI_HANDLE_p h) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_DYNAMICTEXTALLOC) && __GH(h)->Text) {  /* Check if dynamically alocated */
+        __GUI_TEXTLAYOUT_Invalidate(__GH(h)->Text); /* Memory may be used for other text */
         __GUI_MEMFREE(__GH(h)->Text);               /* Free memory first */
         __GH(h)->Text = 0;                          /* Reset memory */
         __GH(h)->TextMemSize = 0;                   /* Reset memory size */
@@ -764,7 +1034,7 @@ uint8_t __GUI_WIDGET_ProcessTextKey(GUI_HANDLE_p h, __GUI_KeyboardData_t* kb) {
         if (tlen && __GH(h)->TextCursor) {
             uint16_t pos;
             
-            GUI_STRING_Prepare(&currStr, (GUI_Char *)((uint32_t)__GH(h)->Text + __GH(h)->TextCursor - 1));  /* Set string to process */
+            GUI_STRING_Prepare(&currStr, (GUI_Char *)((uintptr_t)__GH(h)->Text + __GH(h)->TextCursor - 1));  /* Set string to process */
             GUI_STRING_GoToEnd(&currStr);           /* Go to the end of string */
             if (!GUI_STRING_GetChReverse(&currStr, &ch, &l)) {  /* Get last character */
                 return 0;                           
@@ -807,7 +1077,7 @@ uint8_t __GUI_WIDGET_SetWidth(GUI_HANDLE_p h, GUI_Dim_t width) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_WIDTH_PERCENT)) {  /* Invalidate if percent not yet enabled to force invalidation */
         __GUI_WIDGET_ClrFlag(h, GUI_FLAG_WIDTH_PERCENT);    /* Set percentage flag */
-        __GH(h)->Height = width + 1;                /* Invalidate height */
+        __GH(h)->Height = __GUI_WIDGET_GeomInvalid(width); /* Invalidate height */
     }
     return __SetWidgetSize(h, width, __GH(h)->Height);  /* Set new height */
 }
@@ -816,27 +1086,31 @@ uint8_t __GUI_WIDGET_SetHeight(GUI_HANDLE_p h, GUI_Dim_t height) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_HEIGHT_PERCENT)) { /* Invalidate if percent not yet enabled to force invalidation */
         __GUI_WIDGET_ClrFlag(h, GUI_FLAG_HEIGHT_PERCENT);   /* Set percentage flag */
-        __GH(h)->Height = height + 1;               /* Invalidate height */
+        __GH(h)->Height = __GUI_WIDGET_GeomInvalid(height); /* Invalidate height */
     }
     return __SetWidgetSize(h, __GH(h)->Width, height);  /* Set new height */
 }
 
 uint8_t __GUI_WIDGET_SetWidthPercent(GUI_HANDLE_p h, float width) {
+    GUI_Geom_t w = __GUI_WIDGET_GeomPercent(width);
+    
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     if (!__GUI_WIDGET_GetFlag(h, GUI_FLAG_WIDTH_PERCENT)) { /* Invalidate if percent not yet enabled to force invalidation */
         __GUI_WIDGET_SetFlag(h, GUI_FLAG_WIDTH_PERCENT);    /* Set percentage flag */
-        __GH(h)->Width = width + 1;                 /* Invalidate widget */
+        __GH(h)->Width = __GUI_WIDGET_GeomInvalid(w); /* Invalidate widget */
     }
-    return __SetWidgetSize(h, width, __GH(h)->Height);  /* Set new width */
+    return __SetWidgetSize(h, w, __GH(h)->Height);      /* Set new width */
 }
 
 uint8_t __GUI_WIDGET_SetHeightPercent(GUI_HANDLE_p h, float height) {
+    GUI_Geom_t ht = __GUI_WIDGET_GeomPercent(height);
+    
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     if (!__GUI_WIDGET_GetFlag(h, GUI_FLAG_HEIGHT_PERCENT)) {    /* Invalidate if percent not yet enabled to force invalidation */
         __GUI_WIDGET_SetFlag(h, GUI_FLAG_HEIGHT_PERCENT);   /* Set percentage flag */
-        __GH(h)->Height = height + 1;               /* Invalidate height */
+        __GH(h)->Height = __GUI_WIDGET_GeomInvalid(ht); /* Invalidate height */
     }
-    return __SetWidgetSize(h, __GH(h)->Width, height);  /* Set new height */
+    return __SetWidgetSize(h, __GH(h)->Width, ht);      /* Set new height */
 }
 
 uint8_t __GUI_WIDGET_SetSize(GUI_HANDLE_p h, GUI_Dim_t wi, GUI_Dim_t hi) {
@@ -844,21 +1118,24 @@ uint8_t __GUI_WIDGET_SetSize(GUI_HANDLE_p h, GUI_Dim_t wi, GUI_Dim_t hi) {
     /* If percentage enabled on at least one, either width or height */
     if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT)) {
         __GUI_WIDGET_SetFlag(h, GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT);  /* Set both flags */
-        __GH(h)->Width = wi + 1;                    /* Invalidate width */
-        __GH(h)->Height = hi + 1;                   /* Invalidate height */
+        __GH(h)->Width = __GUI_WIDGET_GeomInvalid(wi); /* Invalidate width */
+        __GH(h)->Height = __GUI_WIDGET_GeomInvalid(hi); /* Invalidate height */
     }
     return __SetWidgetSize(h, wi, hi);              /* Set widget size */
 }
 
 uint8_t __GUI_WIDGET_SetSizePercent(GUI_HANDLE_p h, float wi, float hi) {
+    GUI_Geom_t w = __GUI_WIDGET_GeomPercent(wi);
+    GUI_Geom_t ht = __GUI_WIDGET_GeomPercent(hi);
+    
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     /* If percentage not enable on width or height */
     if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT) != (GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT)) {
         __GUI_WIDGET_SetFlag(h, GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT);  /* Set both flags */
-        __GH(h)->Width = wi + 1;                    /* Invalidate width */
-        __GH(h)->Height = hi + 1;                   /* Invalidate height */
+        __GH(h)->Width = __GUI_WIDGET_GeomInvalid(w); /* Invalidate width */
+        __GH(h)->Height = __GUI_WIDGET_GeomInvalid(ht); /* Invalidate height */
     }
-    return __SetWidgetSize(h, wi, hi);              /* Set widget size */
+    return __SetWidgetSize(h, w, ht);               /* Set widget size */
 }
 
 uint8_t __GUI_WIDGET_ToggleExpanded(GUI_HANDLE_p h) {
@@ -871,8 +1148,10 @@ uint8_t __GUI_WIDGET_SetExpanded(GUI_HANDLE_p h, uint8_t state) {
     if (!state && __GUI_WIDGET_IsExpanded(h)) {     /* Check current status */
         __GUI_WIDGET_InvalidateWithParent(h);       /* Invalidate with parent first for clipping region */
         __GUI_WIDGET_ClrFlag(h, GUI_FLAG_EXPANDED); /* Clear expanded after invalidation */
+        __GUI_WIDGET_GeometryChanged(h);            /* Cached geometry is not valid anymore */
     } else if (state && !__GUI_WIDGET_IsExpanded(h)) {
         __GUI_WIDGET_SetFlag(h, GUI_FLAG_EXPANDED); /* Expand widget */
+        __GUI_WIDGET_GeometryChanged(h);            /* Cached geometry is not valid anymore */
         __GUI_WIDGET_Invalidate(h);                 /* Redraw only selected widget as it is over all window */
     }
     return 1;
@@ -886,57 +1165,64 @@ uint8_t __GUI_WIDGET_SetPosition(GUI_HANDLE_p h, GUI_iDim_t x, GUI_iDim_t y) {
     /* If percent enabled on at least one coordinate, clear to force invalidation */
     if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT)) {
         __GUI_WIDGET_ClrFlag(h, GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT); /* Disable percent on X and Y position */
-        __GH(h)->X = x + 1;                         /* Invalidate X position */
-        __GH(h)->Y = y + 1;                         /* Invalidate Y position */
+        __GH(h)->X = __GUI_WIDGET_GeomInvalid(x);   /* Invalidate X position */
+        __GH(h)->Y = __GUI_WIDGET_GeomInvalid(y);   /* Invalidate Y position */
     }  
     return __SetWidgetPosition(h, x, y);            /* Set widget position */
 }
 
 uint8_t __GUI_WIDGET_SetPositionPercent(GUI_HANDLE_p h, float x, float y) {  
+    GUI_Geom_t px = __GUI_WIDGET_GeomPercent(x);
+    GUI_Geom_t py = __GUI_WIDGET_GeomPercent(y);
+    
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */   
     /* If percent not set on both, enable to force invalidation */
     if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT) != (GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT)) {
         __GUI_WIDGET_SetFlag(h, GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT); /* Enable percent on X and Y position */
-        __GH(h)->X = x + 1;                         /* Invalidate X position */
-        __GH(h)->Y = y + 1;                         /* Invalidate Y position */
+        __GH(h)->X = __GUI_WIDGET_GeomInvalid(px);  /* Invalidate X position */
+        __GH(h)->Y = __GUI_WIDGET_GeomInvalid(py);  /* Invalidate Y position */
     }
-    return __SetWidgetPosition(h, x, y);            /* Set widget position */
+    return __SetWidgetPosition(h, px, py);          /* Set widget position */
 }
 
 uint8_t __GUI_WIDGET_SetXPosition(GUI_HANDLE_p h, GUI_iDim_t x) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_XPOS_PERCENT)) {   /* if percent enabled */
         __GUI_WIDGET_ClrFlag(h, GUI_FLAG_XPOS_PERCENT); /* Clear it to force invalidation */
-        __GH(h)->X = x + 1;                         /* Invalidate position */
+        __GH(h)->X = __GUI_WIDGET_GeomInvalid(x);   /* Invalidate position */
     }
     return __SetWidgetPosition(h, x, __GH(h)->Y);   /* Set widget position */
 }
 
 uint8_t __GUI_WIDGET_SetXPositionPercent(GUI_HANDLE_p h, float x) {
+    GUI_Geom_t px = __GUI_WIDGET_GeomPercent(x);
+    
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     if (!__GUI_WIDGET_GetFlag(h, GUI_FLAG_XPOS_PERCENT)) {  /* if percent not enabled */
         __GUI_WIDGET_SetFlag(h, GUI_FLAG_XPOS_PERCENT); /* Set it to force invalidation */
-        __GH(h)->X = x + 1;                         /* Invalidate position */
+        __GH(h)->X = __GUI_WIDGET_GeomInvalid(px);  /* Invalidate position */
     }
-    return __SetWidgetPosition(h, x, __GH(h)->Y);   /* Set widget position */
+    return __SetWidgetPosition(h, px, __GH(h)->Y);  /* Set widget position */
 }
 
 uint8_t __GUI_WIDGET_SetYPosition(GUI_HANDLE_p h, GUI_iDim_t y) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     if (__GUI_WIDGET_GetFlag(h, GUI_FLAG_YPOS_PERCENT)) {   /* if percent enabled */
         __GUI_WIDGET_ClrFlag(h, GUI_FLAG_YPOS_PERCENT); /* Clear it to force invalidation */
-        __GH(h)->Y = y + 1;                         /* Invalidate position */
+        __GH(h)->Y = __GUI_WIDGET_GeomInvalid(y);   /* Invalidate position */
     }
     return __SetWidgetPosition(h, __GH(h)->X, y);   /* Set widget position */
 }
 
 uint8_t __GUI_WIDGET_SetYPositionPercent(GUI_HANDLE_p h, float y) {
+    GUI_Geom_t py = __GUI_WIDGET_GeomPercent(y);
+    
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     if (!__GUI_WIDGET_GetFlag(h, GUI_FLAG_YPOS_PERCENT)) {  /* if percent not enabled */
         __GUI_WIDGET_SetFlag(h, GUI_FLAG_YPOS_PERCENT); /* Set it to force invalidation */
-        __GH(h)->X = y + 1;                         /* Invalidate position */
+        __GH(h)->X = __GUI_WIDGET_GeomInvalid(py);  /* Invalidate position */
     }
-    return __SetWidgetPosition(h, __GH(h)->X, y);   /* Set widget position */
+    return __SetWidgetPosition(h, __GH(h)->X, py);  /* Set widget position */
 }
 
 /*******************************************/
@@ -964,10 +1250,10 @@ uint8_t __GUI_WIDGET_Hide(GUI_HANDLE_p h) {
      * TODO: Check if active/focused widget is maybe children of this widget
      */
     
-    if (GUI.FocusedWidget == h || __GUI_WIDGET_IsChildOf(GUI.FocusedWidget, h)) {   /* Clear focus */
+    if (GUI.FocusedWidget && (GUI.FocusedWidget == h || __GUI_WIDGET_IsChildOf(GUI.FocusedWidget, h))) {   /* Clear focus */
         __GUI_WIDGET_FOCUS_SET(__GH(h)->Parent);    /* Set parent widget as focused now */
     }
-    if (GUI.ActiveWidget == h || __GUI_WIDGET_IsChildOf(GUI.ActiveWidget, h)) { /* Clear active */
+    if (GUI.ActiveWidget && (GUI.ActiveWidget == h || __GUI_WIDGET_IsChildOf(GUI.ActiveWidget, h))) {   /* Clear active */
         __GUI_WIDGET_ACTIVE_CLEAR();
     }
     return 1;
@@ -1005,8 +1291,14 @@ uint8_t __GUI_WIDGET_SetTransparency(GUI_HANDLE_p h, uint8_t trans) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     
     if (__GH(h)->Transparency != trans) {           /* Check transparency match */
+        GUI_Scratch_t* cache = __GH(h)->Cache;
+        uint8_t valid = cache && cache->Valid;
+        
         __GH(h)->Transparency = trans;              /* Set new transparency level */
         __GUI_WIDGET_Invalidate(h);                 /* Invalidate widget */
+        if (valid) {
+            cache->Valid = 1;                       /* Content is the same, only blending with parent changed */
+        }
     }
     
     return 1;
@@ -1040,7 +1332,7 @@ uint8_t __GUI_WIDGET_SetColor(GUI_HANDLE_p h, uint8_t index, GUI_Color_t color)
 }
 
 GUI_HANDLE_p __GUI_WIDGET_GetById(GUI_ID_t id) {
-    return __GetWidgetById(NULL, id, 1);            /* Find widget by ID */ 
+    return __FindWidgetById(id);                    /* Find widget by ID */
 }
 
 uint8_t __GUI_WIDGET_SetUserData(GUI_HANDLE_p h, void* data) {
@@ -1505,7 +1797,7 @@ GUI_HANDLE_p GUI_WIDGET_GetById(GUI_ID_t id) {
     GUI_HANDLE_p h;
     __GUI_ENTER();                                  /* Enter GUI */
     
-    h = __GetWidgetById(NULL, id, 1);               /* Find widget by ID */
+    h = __FindWidgetById(id);                       /* Find widget by ID */
     
     __GUI_LEAVE();                                  /* Leave GUI */
     return h; 
@@ -1580,6 +1872,7 @@ uint8_t GUI_WIDGET_SetScrollX(GUI_HANDLE_p h, GUI_iDim_t scroll) {
     
     if (__GUI_WIDGET_AllowChildren(h) && __GHR(h)->ScrollX != scroll) { /* Only widgets with children support can set scroll */
         __GHR(h)->ScrollX = scroll;
+        __GUI_WIDGET_GeometryChanged(h);            /* Children widgets are moved */
         __GUI_WIDGET_Invalidate(h);
         ret = 1;
     }
@@ -1596,6 +1889,7 @@ uint8_t GUI_WIDGET_SetScrollY(GUI_HANDLE_p h, GUI_iDim_t scroll) {
     
     if (__GUI_WIDGET_AllowChildren(h) && __GHR(h)->ScrollY != scroll) { /* Only widgets with children support can set scroll */
         __GHR(h)->ScrollY = scroll;
+        __GUI_WIDGET_GeometryChanged(h);            /* Children widgets are moved */
         __GUI_WIDGET_Invalidate(h);
         ret = 1;
     }
@@ -1668,6 +1962,18 @@ uint8_t GUI_WIDGET_SetTransparency(GUI_HANDLE_p h, uint8_t trans) {
     return ret;
 }
 
+uint8_t GUI_WIDGET_SetCache(GUI_HANDLE_p h, uint8_t enable) {
+    uint8_t ret;
+    
+    __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    ret = __GUI_WIDGET_SetCache(h, enable);         /* Set cache mode */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
 uint8_t GUI_WIDGET_GetTransparency(GUI_HANDLE_p h) {
     uint8_t trans;
     
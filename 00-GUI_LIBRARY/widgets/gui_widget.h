@@ -204,6 +204,64 @@ GUI_iDim_t __GUI_WIDGET_GetParentAbsoluteX(GUI_HANDLE_p h);
  */
 GUI_iDim_t __GUI_WIDGET_GetParentAbsoluteY(GUI_HANDLE_p h);
 
+/**
+ * \brief           Convert percentage of parent to widget position or size value in \ref GUI_HANDLE
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \note            With integer geometry percentage is rounded to nearest 0.01 percent
+ *                  and limited to range from -327.68 to 327.67 percent
+ * \param[in]       p: Percentage of parent widget
+ * \retval          Stored position or size value
+ * \hideinitializer
+ */
+#if GUI_USE_FIXED_GEOMETRY || defined(DOXYGEN)
+#define __GUI_WIDGET_GeomPercent(p)             ((GUI_Geom_t)((p) >= 327.67f ? 32767 : !((p) > -327.68f) ? -32768 : \
+                                                    (p) < 0 ? (p) * 100.0f - 0.5f : (p) * 100.0f + 0.5f))
+#else
+#define __GUI_WIDGET_GeomPercent(p)             ((GUI_Geom_t)(p))
+#endif /* GUI_USE_FIXED_GEOMETRY || defined(DOXYGEN) */
+
+/**
+ * \brief           Get position or size value which is different to input value
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \note            Stored value is set to it before new value is set to force invalidation of widget
+ * \param[in]       v: Position or size value
+ * \retval          Value different to input value
+ * \hideinitializer
+ */
+#if GUI_USE_FIXED_GEOMETRY || defined(DOXYGEN)
+#define __GUI_WIDGET_GeomInvalid(v)             ((GUI_Geom_t)~(v))
+#else
+#define __GUI_WIDGET_GeomInvalid(v)             ((v) + 1)
+#endif /* GUI_USE_FIXED_GEOMETRY || defined(DOXYGEN) */
+
+/**
+ * \brief           Get widget size in units of pixels from stored percentage, rounded to nearest pixel
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       v: Stored percentage value
+ * \param[in]       parent: Parent inner size in units of pixels
+ * \retval          Size in units of pixels
+ * \hideinitializer
+ */
+#if GUI_USE_FIXED_GEOMETRY || defined(DOXYGEN)
+#define __GUI_WIDGET_GeomSize(v, parent)        ((GUI_iDim_t)(((int32_t)(v) * (parent) + 5000) / 10000))
+#else
+#define __GUI_WIDGET_GeomSize(v, parent)        ((GUI_iDim_t)GUI_ROUND((v) * (parent) / 100))
+#endif /* GUI_USE_FIXED_GEOMETRY || defined(DOXYGEN) */
+
+/**
+ * \brief           Get widget position in units of pixels from stored percentage
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       v: Stored percentage value
+ * \param[in]       parent: Parent inner size in units of pixels
+ * \retval          Position in units of pixels
+ * \hideinitializer
+ */
+#if GUI_USE_FIXED_GEOMETRY || defined(DOXYGEN)
+#define __GUI_WIDGET_GeomPosition(v, parent)    ((GUI_iDim_t)((((int32_t)(v) * (parent) + 50) / 100) / 100))
+#else
+#define __GUI_WIDGET_GeomPosition(v, parent)    ((GUI_iDim_t)((float)GUI_ROUND((v) * (parent)) / 100.0f))
+#endif /* GUI_USE_FIXED_GEOMETRY || defined(DOXYGEN) */
+
 /**
  * \brief           Get widget relative X position according to parent widget
  * \note            Since this function is private, it can only be used by user inside GUI library
@@ -212,7 +270,7 @@ GUI_iDim_t __GUI_WIDGET_GetParentAbsoluteY(GUI_HANDLE_p h);
  * \hideinitializer
  */
 #define __GUI_WIDGET_GetRelativeX(h)    (__GUI_WIDGET_IsExpanded(h) ? 0 : \
-                                            (__GUI_WIDGET_GetFlag(h, GUI_FLAG_XPOS_PERCENT) ? (GUI_iDim_t)((float)GUI_ROUND(__GH(h)->X * __GUI_WIDGET_GetParentInnerWidth(h)) / 100.0f) : __GH(h)->X) \
+                                            (__GUI_WIDGET_GetFlag(h, GUI_FLAG_XPOS_PERCENT) ? __GUI_WIDGET_GeomPosition(__GH(h)->X, __GUI_WIDGET_GetParentInnerWidth(h)) : (GUI_iDim_t)__GH(h)->X) \
                                         )
 
 /**
@@ -223,7 +281,7 @@ GUI_iDim_t __GUI_WIDGET_GetParentAbsoluteY(GUI_HANDLE_p h);
  * \hideinitializer
  */
 #define __GUI_WIDGET_GetRelativeY(h)    (__GUI_WIDGET_IsExpanded(h) ? 0 : \
-                                            (__GUI_WIDGET_GetFlag(h, GUI_FLAG_YPOS_PERCENT) ? (GUI_iDim_t)((float)GUI_ROUND(__GH(h)->Y * __GUI_WIDGET_GetParentInnerHeight(h)) / 100.0f) : __GH(h)->Y) \
+                                            (__GUI_WIDGET_GetFlag(h, GUI_FLAG_YPOS_PERCENT) ? __GUI_WIDGET_GeomPosition(__GH(h)->Y, __GUI_WIDGET_GetParentInnerHeight(h)) : (GUI_iDim_t)__GH(h)->Y) \
                                         )
 
 /**
@@ -401,6 +459,17 @@ uint8_t __GUI_WIDGET_SetHeightPercent(GUI_HANDLE_p h, float height);
  */
 uint8_t __GUI_WIDGET_Set3DStyle(GUI_HANDLE_p h, uint8_t enable);
 
+/**
+ * \brief           Enable or disable cache of transparent widget content
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   h: Widget handle
+ * \param[in]       enable: Value to enable, either 1 or 0
+ * \retval          1: Successful
+ * \retval          0: Failed
+ * \sa              GUI_WIDGET_SetCache
+ */
+uint8_t __GUI_WIDGET_SetCache(GUI_HANDLE_p h, uint8_t enable);
+
 /**
  * \brief           Set font used for widget drawing
  * \note            Since this function is private, it can only be used by user inside GUI library
@@ -576,6 +645,19 @@ uint8_t __GUI_WIDGET_ProcessTextKey(GUI_HANDLE_p h, __GUI_KeyboardData_t* key);
  */
 uint8_t __GUI_WIDGET_SetColor(GUI_HANDLE_p h, uint8_t index, GUI_Color_t color);
 
+/**
+ * \brief           Mark cached geometry of widget as invalid
+ * \note            Must be called after any change which affects position or size of widget on LCD,
+ *                  such as position, size, padding, scroll or expanded mode change.
+ *                  Geometry of children widgets is calculated again as it depends on widget geometry
+ *                  and widget is moved to new cells in spatial index of parent widget.
+ *                  Cached content of widget and its parent widgets is marked as changed
+ *
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   h: Widget handle
+ */
+void __GUI_WIDGET_GeometryChanged(GUI_HANDLE_p h);
+
 /**
  * \brief           Get widget top padding as 8-bit value
  * \note            Since this function is private, it can only be used by user inside GUI library
@@ -623,7 +705,7 @@ uint8_t __GUI_WIDGET_SetColor(GUI_HANDLE_p h, uint8_t index, GUI_Color_t color);
  * \retval          None
  * \hideinitializer
  */
-#define __GUI_WIDGET_SetPaddingTop(h, x)            (__GH(h)->Padding = (uint32_t)((__GH(h)->Padding & 0x00FFFFFFUL) | (uint32_t)((uint8_t)(x)) << 24))
+#define __GUI_WIDGET_SetPaddingTop(h, x)            (__GH(h)->Padding = (uint32_t)((__GH(h)->Padding & 0x00FFFFFFUL) | (uint32_t)((uint8_t)(x)) << 24), __GUI_WIDGET_GeometryChanged(h))
 
 /**
  * \brief           Set right padding on widget
@@ -636,7 +718,7 @@ uint8_t __GUI_WIDGET_SetColor(GUI_HANDLE_p h, uint8_t index, GUI_Color_t color);
  * \retval          None
  * \hideinitializer
  */
-#define __GUI_WIDGET_SetPaddingRight(h, x)          (__GH(h)->Padding = (uint32_t)((__GH(h)->Padding & 0xFF00FFFFUL) | (uint32_t)((uint8_t)(x)) << 16))
+#define __GUI_WIDGET_SetPaddingRight(h, x)          (__GH(h)->Padding = (uint32_t)((__GH(h)->Padding & 0xFF00FFFFUL) | (uint32_t)((uint8_t)(x)) << 16), __GUI_WIDGET_GeometryChanged(h))
 
 /**
  * \brief           Set bottom padding on widget
@@ -649,7 +731,7 @@ uint8_t __GUI_WIDGET_SetColor(GUI_HANDLE_p h, uint8_t index, GUI_Color_t color);
  * \retval          None
  * \hideinitializer
  */
-#define __GUI_WIDGET_SetPaddingBottom(h, x)         (__GH(h)->Padding = (uint32_t)((__GH(h)->Padding & 0xFFFF00FFUL) | (uint32_t)((uint8_t)(x)) <<  8))
+#define __GUI_WIDGET_SetPaddingBottom(h, x)         (__GH(h)->Padding = (uint32_t)((__GH(h)->Padding & 0xFFFF00FFUL) | (uint32_t)((uint8_t)(x)) <<  8), __GUI_WIDGET_GeometryChanged(h))
 
 /**
  * \brief           Set left padding on widget
@@ -662,7 +744,7 @@ uint8_t __GUI_WIDGET_SetColor(GUI_HANDLE_p h, uint8_t index, GUI_Color_t color);
  * \retval          None
  * \hideinitializer
  */
-#define __GUI_WIDGET_SetPaddingLeft(h, x)           (__GH(h)->Padding = (uint32_t)((__GH(h)->Padding & 0xFFFFFF00UL) | (uint32_t)((uint8_t)(x)) <<  0))
+#define __GUI_WIDGET_SetPaddingLeft(h, x)           (__GH(h)->Padding = (uint32_t)((__GH(h)->Padding & 0xFFFFFF00UL) | (uint32_t)((uint8_t)(x)) <<  0), __GUI_WIDGET_GeometryChanged(h))
 
 /**
  * \brief           Set top and bottom paddings on widget
@@ -993,6 +1075,17 @@ GUI_Dim_t __GUI_WIDGET_GetHeight(GUI_HANDLE_p h);
  */
 #define __GUI_WIDGET_IsTransparent(h)               (__GUI_WIDGET_IsVisible(h) && __GUI_WIDGET_GetTransparency(h) < 0xFF)
 
+/**
+ * \brief           Check if widget hides everything below it
+ * \note            Widget type must have \ref GUI_FLAG_WIDGET_OPAQUE flag and widget must not have transparency
+ *
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   h: Widget handle
+ * \retval          1: Widget is opaque
+ * \retval          0: Widgets below may be visible through widget
+ */
+#define __GUI_WIDGET_IsOpaque(h)                    (__GUI_WIDGET_GetCoreFlag(h, GUI_FLAG_WIDGET_OPAQUE) && __GUI_WIDGET_GetTransparency(h) == 0xFF)
+
 /**
  * \brief           Get widget transparency value
  * \note            Value between 0 and 0xFF is used:
@@ -1452,6 +1545,21 @@ uint8_t GUI_WIDGET_GetTransparency(GUI_HANDLE_p h);
  * \sa              GUI_WIDGET_GetTransparency
  */
 uint8_t GUI_WIDGET_SetTransparency(GUI_HANDLE_p h, uint8_t trans);
+
+/**
+ * \brief           Enable or disable cache of transparent widget content
+ *
+ *                  When enabled, widget and its children are drawn to layer kept between redraws.
+ *                  Until any of them is invalidated, widget is only blended again from cache,
+ *                  for example when widget is moved over or only transparency changes
+ * \note            Layer is taken from pool limited with \ref GUI_SCRATCH_POOL_SIZE and may be freed when pool is full
+ * \param[in,out]   h: Widget handle
+ * \param[in]       enable: Value to enable, either 1 or 0
+ * \retval          1: Successful
+ * \retval          0: Failed
+ * \sa              GUI_WIDGET_SetTransparency
+ */
+uint8_t GUI_WIDGET_SetCache(GUI_HANDLE_p h, uint8_t enable);
  
 /**
  * \}
@@ -1632,6 +1740,16 @@ void __GUI_WIDGET_Init(void);
 
 //Clipping regions
 uint8_t __GUI_WIDGET_IsInsideClippingRegion(GUI_HANDLE_p h);
+uint8_t __GUI_WIDGET_IsInsideRegion(GUI_HANDLE_p h, const GUI_Region_t* region, size_t start);
+uint8_t __GUI_WIDGET_GetVisibleRect(GUI_HANDLE_p h, GUI_Display_t* rect);
+
+//Walk widget tree without recursion
+GUI_HANDLE_p __GUI_WIDGET_GetNextInTree(GUI_HANDLE_p parent, GUI_HANDLE_p h, uint8_t children);
+
+//Spatial index of children widgets
+#if GUI_WIDGET_GRID_CHILDREN
+GUI_Grid_t* __GUI_WIDGET_GetChildrenGrid(GUI_HANDLE_p parent);
+#endif /* GUI_WIDGET_GRID_CHILDREN */
 
 //Move widget down and all its parents with it
 void __GUI_WIDGET_MoveDownTree(GUI_HANDLE_p h);
@@ -0,0 +1,140 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#include "lcd_host.h"
+#include "gui.h"
+#include "gui_window.h"
+#include "gui_container.h"
+#include "gui_led.h"
+
+#include <time.h>
+
+/**
+ * Benchmark of widget geometry accessors
+ *
+ * Containers with percentage position and size are filled with small widgets
+ * which also use percentages, every 4th widget has size in units of pixels.
+ * Geometry of all widgets is resolved again after each layout change of desktop and
+ * read from cache when layout has not changed. When only one container is changed,
+ * only widgets inside it are resolved again.
+ *
+ * Program is built for each geometry type, see GUI_USE_FIXED_GEOMETRY.
+ * Checksum of resolved geometry must be equal for both programs
+ *
+ * Usage: bench_geometry_<type> [widgets]
+ */
+
+#define BENCH_CONTAINERS        50                  /* Number of containers on desktop */
+#define BENCH_ROUNDS            200                 /* Number of rounds for each test */
+
+/* Get monotonic time in units of nanoseconds */
+static
+uint64_t TimeNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Read position and size of all widgets */
+static
+uint32_t ReadGeometry(GUI_HANDLE_p* h, uint32_t count) {
+    uint32_t i, sum = 0;
+    
+    for (i = 0; i < count; i++) {
+        sum = sum * 31 + (uint16_t)__GUI_WIDGET_GetAbsoluteX(h[i]);
+        sum = sum * 31 + (uint16_t)__GUI_WIDGET_GetAbsoluteY(h[i]);
+        sum = sum * 31 + (uint16_t)__GUI_WIDGET_GetWidth(h[i]);
+        sum = sum * 31 + (uint16_t)__GUI_WIDGET_GetHeight(h[i]);
+    }
+    return sum;
+}
+
+int main(int argc, char** argv) {
+    GUI_HANDLE_p containers[BENCH_CONTAINERS], *h;
+    uint32_t count = 5000, i, sum = 0;
+    uint64_t t, resolve, cached, local;
+    
+    if (argc > 1) {
+        count = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    h = malloc(count * sizeof(*h));
+    if (!h) {
+        return 1;
+    }
+    
+    GUI_Init();
+    
+    /* Containers cover desktop in 10 columns and 5 rows */
+    for (i = 0; i < BENCH_CONTAINERS; i++) {
+        containers[i] = GUI_CONTAINER_Create(0, 0, 0, 10, 10, GUI_WINDOW_GetDesktop(), 0, 0);
+        GUI_WIDGET_SetPositionPercent(containers[i], (i % 10) * 10, (i / 10) * 20);
+        GUI_WIDGET_SetSizePercent(containers[i], 10, 20);
+    }
+    for (i = 0; i < count; i++) {
+        h[i] = GUI_LED_Create(0, 0, 0, 5, 5, containers[i % BENCH_CONTAINERS], 0, 0);
+        GUI_WIDGET_SetPositionPercent(h[i], ((i / BENCH_CONTAINERS) % 8) * 12.5f, ((i / BENCH_CONTAINERS / 8) % 6) * 16.5f);
+        if (i % 4 == 3) {
+            GUI_WIDGET_SetSize(h[i], 6, 3);
+        } else {
+            GUI_WIDGET_SetSizePercent(h[i], 12.5f, 16.5f);
+        }
+    }
+    GUI_Process();
+    
+    printf("Geometry benchmark, %s geometry, %lu bytes per handle, %lu widgets, %lu rounds\r\n",
+        GUI_USE_FIXED_GEOMETRY ? "fixed" : "float", (unsigned long)sizeof(GUI_HANDLE),
+        (unsigned long)(count + BENCH_CONTAINERS), (unsigned long)BENCH_ROUNDS);
+    
+    /* Layout of desktop is changed before each round, everything is resolved again */
+    t = TimeNs();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        __GUI_WIDGET_GeometryChanged(GUI_WINDOW_GetDesktop());
+        sum += ReadGeometry(h, count);
+    }
+    resolve = TimeNs() - t;
+    
+    /* Layout of one container is changed before each round, only its widgets are resolved again */
+    t = TimeNs();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        __GUI_WIDGET_GeometryChanged(containers[i % BENCH_CONTAINERS]);
+        sum += ReadGeometry(h, count);
+    }
+    local = TimeNs() - t;
+    
+    /* Layout is not changed, values are read from cache */
+    t = TimeNs();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        sum += ReadGeometry(h, count);
+    }
+    cached = TimeNs() - t;
+    
+    printf("Resolve: %8lu ns per widget\r\n", (unsigned long)(resolve / ((uint64_t)BENCH_ROUNDS * count)));
+    printf("Local:   %8lu ns per widget\r\n", (unsigned long)(local / ((uint64_t)BENCH_ROUNDS * count)));
+    printf("Cached:  %8lu ns per widget\r\n", (unsigned long)(cached / ((uint64_t)BENCH_ROUNDS * count)));
+    printf("Checksum: %08lx\r\n", (unsigned long)ReadGeometry(h, count));
+    
+    free(h);
+    return (int)(sum & 0);
+}
@@ -0,0 +1,152 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#include "lcd_host.h"
+#include "gui.h"
+#include "gui_window.h"
+#include "gui_container.h"
+#include "gui_led.h"
+
+#include <time.h>
+
+/**
+ * Benchmark of widget search by ID
+ *
+ * Tree with containers full of small widgets is created and random IDs are searched
+ * with tree search, the way library did it before ID map, and with GUI_WIDGET_GetById.
+ * Some widgets are removed and some share ID to check both searches return the same widget.
+ *
+ * Usage: bench_getbyid [widgets]
+ */
+
+#define BENCH_CONTAINERS        50                  /* Number of containers on desktop */
+#define BENCH_SEARCHES          100000              /* Number of searches for each method */
+#define ID_BASE                 (GUI_ID_USER + 1)
+
+/* Get monotonic time in units of microseconds */
+static
+uint64_t TimeUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+/* Simple pseudo random generator to get the same sequence on every run */
+static
+uint32_t Random(void) {
+    static uint32_t seed = 1;
+    seed = seed * 1103515245UL + 12345UL;
+    return seed >> 8;
+}
+
+/* Search widget in tree, first widget in tree order is returned */
+static
+GUI_HANDLE_p TreeSearch(GUI_HANDLE_p parent, GUI_ID_t id) {
+    GUI_HANDLE_p h, tmp;
+    
+    for (h = __GUI_LINKEDLIST_WidgetGetNext(__GHR(parent), NULL); h; h = __GUI_LINKEDLIST_WidgetGetNext(NULL, h)) {
+        if (__GUI_WIDGET_GetId(h) == id) {
+            return h;
+        } else if (__GUI_WIDGET_AllowChildren(h) && (tmp = TreeSearch(h, id)) != NULL) {
+            return tmp;
+        }
+    }
+    return NULL;
+}
+
+/* Compare both searches for all IDs */
+static
+uint32_t Verify(uint32_t count) {
+    uint32_t i, errors = 0;
+    
+    for (i = 0; i < count + 10; i++) {              /* Check also IDs which do not exist */
+        if (GUI_WIDGET_GetById(ID_BASE + i) != TreeSearch(NULL, ID_BASE + i)) {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+int main(int argc, char** argv) {
+    GUI_HANDLE_p containers[BENCH_CONTAINERS], h;
+    uint32_t count = 5000, i, errors;
+    uint64_t t, tree, map;
+    uintptr_t sum = 0;
+    
+    if (argc > 1) {
+        count = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    
+    GUI_Init();
+    
+    /* Create containers with children, each widget has its own ID */
+    for (i = 0; i < BENCH_CONTAINERS; i++) {
+        containers[i] = GUI_CONTAINER_Create(ID_BASE + count + i, (i % 10) * 48, (i / 10) * 54, 48, 54, GUI_WINDOW_GetDesktop(), 0, 0);
+    }
+    for (i = 0; i < count; i++) {
+        GUI_LED_Create(ID_BASE + i, (i % 8) * 6, ((i / 8) % 9) * 6, 5, 5, containers[i % BENCH_CONTAINERS], 0, 0);
+    }
+    GUI_Process();
+    
+    printf("ID search benchmark, %lu widgets, %lu searches\r\n", (unsigned long)(count + BENCH_CONTAINERS), (unsigned long)BENCH_SEARCHES);
+    
+    t = TimeUs();
+    for (i = 0; i < BENCH_SEARCHES; i++) {
+        sum += (uintptr_t)TreeSearch(NULL, ID_BASE + Random() % count);
+    }
+    tree = TimeUs() - t;
+    
+    t = TimeUs();
+    for (i = 0; i < BENCH_SEARCHES; i++) {
+        sum -= (uintptr_t)GUI_WIDGET_GetById(ID_BASE + Random() % count);
+    }
+    map = TimeUs() - t;
+    
+    printf("Tree search: %8lu ns per search\r\n", (unsigned long)(tree * 1000 / BENCH_SEARCHES));
+    printf("ID map:      %8lu ns per search\r\n", (unsigned long)(map * 1000 / BENCH_SEARCHES));
+    
+    /* Remove some widgets and create some with duplicated IDs, both searches must still match */
+    errors = Verify(count);
+    for (i = 0; i < count; i += 7) {
+        h = GUI_WIDGET_GetById(ID_BASE + i);
+        GUI_WIDGET_Remove(&h);
+    }
+    for (i = 0; i < count; i += 11) {
+        GUI_LED_Create(ID_BASE + i + 1, 0, 0, 5, 5, containers[(i + 3) % BENCH_CONTAINERS], 0, 0);
+    }
+    GUI_Process();
+    errors += Verify(count);
+    for (i = 0; i < count; i += 13) {
+        h = GUI_WIDGET_GetById(ID_BASE + i + 1);    /* Widget may be removed already */
+        if (h) {
+            GUI_WIDGET_Remove(&h);
+        }
+    }
+    GUI_Process();
+    errors += Verify(count);
+    printf("Verification: %s, %lu errors\r\n", errors ? "failed" : "ok", (unsigned long)errors);
+    
+    return errors ? 1 : (int)(sum & 0);
+}
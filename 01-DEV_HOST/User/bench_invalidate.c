@@ -0,0 +1,139 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#include "lcd_host.h"
+#include "gui.h"
+#include "gui_window.h"
+#include "gui_container.h"
+#include "gui_led.h"
+
+#include <time.h>
+
+/**
+ * Invalidation benchmark for containers with many children widgets
+ *
+ * Container is filled with small widgets in rows, every 8th widget is twice
+ * as big and covers its neighbours. Random children are then invalidated,
+ * moved and resized and average time of one operation is reported.
+ *
+ * Program is built with and without spatial index of children widgets,
+ * see GUI_WIDGET_GRID_CHILDREN.
+ *
+ * Usage: bench_invalidate_<type> [count ...]
+ */
+
+#define BENCH_OPS               20                  /* Number of measured operations for each test */
+
+/* Get monotonic time in units of microseconds */
+static
+uint64_t TimeUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+/* Simple pseudo random generator to get the same sequence on every run */
+static
+uint32_t Random(void) {
+    static uint32_t seed = 1;
+    seed = seed * 1103515245UL + 12345UL;
+    return seed >> 8;
+}
+
+/* Run test with specific number of children widgets */
+static
+void Bench(GUI_HANDLE_p desktop, uint32_t count) {
+    GUI_HANDLE_p container, *h;
+    GUI_Dim_t size;
+    uint32_t i, cols;
+    uint64_t t, create, invalidate, move, resize;
+    
+    h = malloc(count * sizeof(*h));
+    if (!h) {
+        return;
+    }
+    
+    /* Get widget size to fill visible area of container */
+    for (size = 2; (uint32_t)(LCD_WIDTH / (size + 1)) * (LCD_HEIGHT / (size + 1)) >= count; size++);
+    cols = LCD_WIDTH / size;
+    
+    container = GUI_CONTAINER_Create(0, 0, 0, LCD_WIDTH, LCD_HEIGHT, desktop, 0, 0);
+    t = TimeUs();
+    for (i = 0; i < count; i++) {
+        GUI_Dim_t s = (i % 8) ? size : 2 * size;
+        h[i] = GUI_LED_Create(0, (i % cols) * size, (i / cols) * size, s, s, container, 0, 0);
+    }
+    create = TimeUs() - t;
+    GUI_Process();                                  /* Draw everything and clear redraw flags */
+    
+    t = TimeUs();
+    for (i = 0; i < BENCH_OPS; i++) {
+        GUI_WIDGET_Invalidate(h[Random() % count]);
+    }
+    invalidate = TimeUs() - t;
+    
+    t = TimeUs();
+    for (i = 0; i < BENCH_OPS; i++) {
+        uint32_t n = Random() % count;
+        GUI_WIDGET_SetPosition(h[n], (n % cols) * size + (i & 1), (n / cols) * size);
+    }
+    move = TimeUs() - t;
+    
+    t = TimeUs();
+    for (i = 0; i < BENCH_OPS; i++) {
+        uint32_t n = Random() % count;
+        GUI_Dim_t s = ((n % 8) ? size : 2 * size) + (i & 1);
+        GUI_WIDGET_SetSize(h[n], s, s);
+    }
+    resize = TimeUs() - t;
+    
+    printf("%6lu children: create %8lu us, invalidate %8lu us, move %8lu us, resize %8lu us\r\n", (unsigned long)count,
+        (unsigned long)(create / count), (unsigned long)(invalidate / BENCH_OPS), 
+        (unsigned long)(move / BENCH_OPS), (unsigned long)(resize / BENCH_OPS));
+    
+    GUI_Process();
+    GUI_WIDGET_Hide(container);                     /* Keep container, removing it invalidates every child */
+    free(h);
+}
+
+int main(int argc, char** argv) {
+    static const uint32_t counts[] = {1000, 2000, 5000, 10000};
+    int i;
+    
+    GUI_Init();
+    
+    printf("Invalidation benchmark, %d operations per test, spatial index %s\r\n", (int)BENCH_OPS,
+        GUI_WIDGET_GRID_CHILDREN ? "enabled" : "disabled");
+    if (argc > 1) {
+        for (i = 1; i < argc; i++) {
+            Bench(GUI_WINDOW_GetDesktop(), (uint32_t)strtoul(argv[i], NULL, 0));
+        }
+    } else {
+        for (i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++) {
+            Bench(GUI_WINDOW_GetDesktop(), counts[i]);
+        }
+    }
+    return 0;
+}
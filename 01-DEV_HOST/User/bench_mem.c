@@ -0,0 +1,174 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#include "lcd_host.h"
+#include "gui.h"
+
+#include <time.h>
+
+/**
+ * Fragmentation and latency benchmark of memory allocator
+ *
+ * Memory is split to fast and slow region the same way as on target.
+ * Each cycle simulates screen switch: new screen allocates widgets, texts
+ * and few big buffers, then most of objects of previous screens are freed
+ * in random order. Latency of every allocation and free is measured and
+ * largest allocatable block is checked at the end.
+ *
+ * Program is built for each allocator, see GUI_MEM_TLSF
+ *
+ * Usage: bench_mem_<allocator> [cycles]
+ */
+
+#define BENCH_FAST_SIZE         0x10000             /* Size of fast region, TCM RAM on target */
+#define BENCH_SLOW_SIZE         0x400000            /* Size of slow region, SDRAM on target */
+#define BENCH_OBJECTS           4096                /* Maximal number of live objects */
+#define BENCH_SCREEN_OBJECTS    600                 /* Objects allocated on each screen switch */
+#define BENCH_KEEP_PERCENT      30                  /* Percentage of live objects kept on screen switch */
+
+static uint8_t heap[BENCH_FAST_SIZE + BENCH_SLOW_SIZE];
+static void* objects[BENCH_OBJECTS];
+static uint32_t* times;
+static size_t timesCount;
+
+/* Get monotonic time in units of nanoseconds */
+static
+uint64_t TimeNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Simple pseudo random generator to get the same sequence on every run */
+static
+uint32_t Random(void) {
+    static uint32_t seed = 1;
+    seed = seed * 1103515245UL + 12345UL;
+    return seed >> 8;
+}
+
+/* Get size of next object, mostly small widget structures and texts */
+static
+size_t RandomSize(void) {
+    uint32_t r = Random() % 100;
+    if (r < 65) {
+        return 40 + Random() % 160;                 /* Widget structure */
+    } else if (r < 95) {
+        return 4 + Random() % 60;                   /* Text, colors */
+    }
+    return 1024 + Random() % 32768;                 /* Image or temporary buffer */
+}
+
+/* Save operation time */
+static
+void SaveTime(uint64_t t) {
+    times[timesCount++] = t > 0xFFFFFFFFUL ? 0xFFFFFFFFUL : (uint32_t)t;
+}
+
+static
+int CompareTimes(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/* Get the biggest block which can be allocated */
+static
+size_t GetLargestBlock(void) {
+    size_t lo = 0, hi = __GUI_MEM_GetFree(), mid;
+    void* ptr;
+    
+    while (lo < hi) {
+        mid = lo + (hi - lo + 1) / 2;
+        if ((ptr = __GUI_MEM_Alloc(mid)) != NULL) {
+            __GUI_MEM_Free(ptr);
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+int main(int argc, char** argv) {
+    GUI_MEM_Region_t regions[] = {
+        {heap, BENCH_FAST_SIZE},
+        {heap + BENCH_FAST_SIZE, BENCH_SLOW_SIZE},
+    };
+    uint32_t cycles = 200, cycle, i, n, failed = 0;
+    uint64_t t, total = 0;
+    size_t largest, freeBytes;
+    
+    if (argc > 1) {
+        cycles = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    times = malloc(sizeof(*times) * 2 * (size_t)cycles * BENCH_SCREEN_OBJECTS);
+    if (!times || !GUI_MEM_AssignMemory(regions, GUI_COUNT_OF(regions))) {
+        return 1;
+    }
+    
+    for (cycle = 0; cycle < cycles; cycle++) {
+        /* Free most of objects from previous screens */
+        for (i = 0; i < BENCH_OBJECTS; i++) {
+            n = Random() % BENCH_OBJECTS;           /* Random order */
+            if (objects[n] && (Random() % 100) >= BENCH_KEEP_PERCENT) {
+                t = TimeNs();
+                __GUI_MEM_Free(objects[n]);
+                SaveTime(TimeNs() - t);
+                objects[n] = NULL;
+            }
+        }
+        
+        /* Create new screen */
+        for (i = 0, n = Random() % BENCH_OBJECTS; i < BENCH_SCREEN_OBJECTS; i++, n = (n + 1) % BENCH_OBJECTS) {
+            size_t size = RandomSize();
+            if (objects[n]) {                       /* Slot still used by kept object */
+                continue;
+            }
+            t = TimeNs();
+            objects[n] = __GUI_MEM_Alloc(size);
+            SaveTime(TimeNs() - t);
+            if (!objects[n]) {
+                failed++;
+            }
+        }
+    }
+    
+    freeBytes = __GUI_MEM_GetFree();
+    largest = GetLargestBlock();
+    for (i = 0; i < timesCount; i++) {
+        total += times[i];
+    }
+    qsort(times, timesCount, sizeof(*times), CompareTimes);
+    
+    printf("Allocator: %s, %lu screen switches, %lu operations\r\n", GUI_MEM_TLSF ? "TLSF" : "first-fit",
+        (unsigned long)cycles, (unsigned long)timesCount);
+    printf("Latency: avg %lu ns, p99 %lu ns, max %lu ns\r\n", (unsigned long)(timesCount ? total / timesCount : 0),
+        (unsigned long)(timesCount ? times[timesCount * 99 / 100] : 0), (unsigned long)(timesCount ? times[timesCount - 1] : 0));
+    printf("Memory: free %lu bytes, largest block %lu bytes, fragmentation %lu%%, failed allocations %lu\r\n",
+        (unsigned long)freeBytes, (unsigned long)largest,
+        (unsigned long)(freeBytes ? 100 - (uint64_t)largest * 100 / freeBytes : 0), (unsigned long)failed);
+    free(times);
+    return 0;
+}
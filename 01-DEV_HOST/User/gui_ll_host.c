@@ -0,0 +1,721 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_ll.h"
+
+#include "lcd_host.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Type of queued blitter command */
+typedef enum HOST_CommandType_t {
+    HOST_Command_Fill = 0x00,                       /*!< Fill area with color */
+    HOST_Command_Copy,                              /*!< Copy area */
+    HOST_Command_CopyBlend,                         /*!< Copy area with blending */
+    HOST_Command_DrawImage16,                       /*!< Draw RGB565 image */
+    HOST_Command_DrawImage24,                       /*!< Draw RGB888 image */
+    HOST_Command_DrawImage32,                       /*!< Draw ARGB8888 image */
+    HOST_Command_CopyChar,                          /*!< Blend A8 character with color */
+} HOST_CommandType_t;
+
+/* Single blitter command, equivalent to DMA2D register set on target */
+typedef struct HOST_Command_t {
+    HOST_CommandType_t Type;                        /*!< Command type */
+    const void* Src;                                /*!< Source address */
+    void* Dst;                                      /*!< Destination address */
+    GUI_Dim_t XSize;                                /*!< Area width */
+    GUI_Dim_t YSize;                                /*!< Area height */
+    GUI_Dim_t OffLineSrc;                           /*!< Source line offset */
+    GUI_Dim_t OffLineDst;                           /*!< Destination line offset */
+    GUI_Color_t Color;                              /*!< Fill or character color */
+    uint8_t AlphaSrc;                               /*!< Source alpha for blending */
+} HOST_Command_t;
+
+/* Ring of commands, filled by drawing functions and drained by simulated transfer complete interrupt */
+typedef struct HOST_Queue_t {
+    HOST_Command_t Cmds[HOST_DMA2D_QUEUE_SIZE];     /*!< List of commands */
+    volatile uint16_t Head;                         /*!< Index of next free command, modified by drawing functions only */
+    volatile uint16_t Tail;                         /*!< Index of command currently in transfer, modified by blitter only */
+    uint16_t Pending;                               /*!< Number of commands written after head but not yet added to queue */
+    uint8_t Batch;                                  /*!< Set to 1 when commands are added to queue at the end of batch */
+    volatile uint8_t Sleeping;                      /*!< Set to 1 when blitter waits for new command */
+    pthread_mutex_t Mutex;                          /*!< Mutex for blitter wake up */
+    pthread_cond_t Work;                            /*!< Signaled when command is added to sleeping blitter */
+    uint32_t Count;                                 /*!< Number of finished commands */
+    uint64_t BusyTime;                              /*!< Time blitter spent in commands in units of nanoseconds */
+} HOST_Queue_t;
+
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+GUI_Layer_t Layers[GUI_LAYERS];
+static uint32_t FrameBuffer[GUI_LAYERS][(LCD_FRAME_BUFFER_SIZE + 3) / 4];   /* Frame buffers, 32-bit aligned */
+static HOST_Queue_t Queue = {.Mutex = PTHREAD_MUTEX_INITIALIZER, .Work = PTHREAD_COND_INITIALIZER};
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+#define PIXEL_ADDR(layer, x, y)     ((uint8_t *)(layer)->StartAddress + LCD_PIXEL_SIZE * ((layer)->Width * (y) + (x)))
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Convert ARGB8888 color to layer pixel format */
+static
+uint32_t ColorToPixel(GUI_Color_t color) {
+#if LCD_PIXEL_SIZE == 2
+    return ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+#else
+    return color;
+#endif
+}
+
+/* Read pixel from memory and convert it to ARGB8888 color */
+static
+GUI_Color_t PixelRead(const uint8_t* addr) {
+#if LCD_PIXEL_SIZE == 2
+    uint16_t p = *(const uint16_t *)addr;
+    uint32_t r = (p >> 11) & 0x1F, g = (p >> 5) & 0x3F, b = p & 0x1F;
+    return 0xFF000000UL | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+#else
+    return *(const uint32_t *)addr;
+#endif
+}
+
+/* Write ARGB8888 color to memory in layer pixel format */
+static
+void PixelWrite(uint8_t* addr, GUI_Color_t color) {
+#if LCD_PIXEL_SIZE == 2
+    *(uint16_t *)addr = (uint16_t)ColorToPixel(color);
+#else
+    *(uint32_t *)addr = color;
+#endif
+}
+
+/* Blend foreground color with alpha over background color, the same as DMA2D blender does */
+static
+GUI_Color_t BlendColor(GUI_Color_t fg, GUI_Color_t bg, uint8_t alpha) {
+    uint32_t a = alpha, na = 0xFF - alpha;
+    uint32_t r, g, b, oa;
+
+    if (alpha == 0xFF) {
+        return fg | 0xFF000000UL;
+    } else if (!alpha) {
+        return bg;
+    }
+    r = (((fg >> 16) & 0xFF) * a + ((bg >> 16) & 0xFF) * na + 0x7F) / 0xFF;
+    g = (((fg >>  8) & 0xFF) * a + ((bg >>  8) & 0xFF) * na + 0x7F) / 0xFF;
+    b = (((fg >>  0) & 0xFF) * a + ((bg >>  0) & 0xFF) * na + 0x7F) / 0xFF;
+    oa = a + ((bg >> 24) * na + 0x7F) / 0xFF;
+    return (oa << 24) | (r << 16) | (g << 8) | b;
+}
+
+/* Software implementation of blitter operations, executed by blitter thread */
+static
+void SW_Fill(void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t OffLine, GUI_Color_t color) {
+    uint32_t pixel = ColorToPixel(color);
+    GUI_iDim_t x, y;
+
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    for (y = 0; y < ySize; y++) {
+#if LCD_PIXEL_SIZE == 2
+        uint16_t* d = (uint16_t *)dst + (size_t)y * (xSize + OffLine);
+#else
+        uint32_t* d = (uint32_t *)dst + (size_t)y * (xSize + OffLine);
+#endif
+        for (x = 0; x < xSize; x++) {
+            d[x] = pixel;
+        }
+    }
+}
+
+static
+void SW_Copy(const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    const uint8_t* s = src;
+    uint8_t* d = dst;
+    GUI_iDim_t y;
+
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    for (y = 0; y < ySize; y++) {
+        memmove(d, s, (size_t)xSize * LCD_PIXEL_SIZE);
+        s += (size_t)(xSize + offLineSrc) * LCD_PIXEL_SIZE;
+        d += (size_t)(xSize + offLineDst) * LCD_PIXEL_SIZE;
+    }
+}
+
+/* Copy layers with blending with alpha combine */
+static
+void SW_CopyBlending(const void* src, void* dst, uint8_t alphaSrc, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    const uint8_t* s = src;
+    uint8_t* d = dst;
+    GUI_iDim_t x, y;
+
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    for (y = 0; y < ySize; y++) {
+        for (x = 0; x < xSize; x++) {
+            PixelWrite(d, BlendColor(PixelRead(s), PixelRead(d), alphaSrc));    /* Source alpha is replaced with alphaSrc as on DMA2D */
+            s += LCD_PIXEL_SIZE;
+            d += LCD_PIXEL_SIZE;
+        }
+        s += (size_t)offLineSrc * LCD_PIXEL_SIZE;
+        d += (size_t)offLineDst * LCD_PIXEL_SIZE;
+    }
+}
+
+static
+void SW_DrawImage16(const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    const uint16_t* s = src;
+    uint8_t* d = dst;
+    GUI_iDim_t x, y;
+
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    for (y = 0; y < ySize; y++) {
+        for (x = 0; x < xSize; x++) {
+            uint32_t p = *s++;                      /* Red and blue are swapped in image data */
+            uint32_t b = (p >> 11) & 0x1F, g = (p >> 5) & 0x3F, r = p & 0x1F;
+            PixelWrite(d, 0xFF000000UL | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2)));
+            d += LCD_PIXEL_SIZE;
+        }
+        s += offLineSrc;
+        d += (size_t)offLineDst * LCD_PIXEL_SIZE;
+    }
+}
+
+static
+void SW_DrawImage24(const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    const uint8_t* s = src;
+    uint8_t* d = dst;
+    GUI_iDim_t x, y;
+
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    for (y = 0; y < ySize; y++) {
+        for (x = 0; x < xSize; x++) {
+            PixelWrite(d, 0xFF000000UL | ((uint32_t)s[0] << 16) | ((uint32_t)s[1] << 8) | s[2]);   /* Red and blue are swapped in image data */
+            s += 3;
+            d += LCD_PIXEL_SIZE;
+        }
+        s += (size_t)offLineSrc * 3;
+        d += (size_t)offLineDst * LCD_PIXEL_SIZE;
+    }
+}
+
+static
+void SW_DrawImage32(const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    const uint8_t* s = src;
+    uint8_t* d = dst;
+    GUI_iDim_t x, y;
+
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    for (y = 0; y < ySize; y++) {
+        for (x = 0; x < xSize; x++) {
+            /* Image is stored as ABGR with inverted alpha */
+            GUI_Color_t c = ((uint32_t)s[0] << 16) | ((uint32_t)s[1] << 8) | s[2];
+            PixelWrite(d, BlendColor(c, PixelRead(d), 0xFF - s[3]));
+            s += 4;
+            d += LCD_PIXEL_SIZE;
+        }
+        s += (size_t)offLineSrc * 4;
+        d += (size_t)offLineDst * LCD_PIXEL_SIZE;
+    }
+}
+
+static
+void SW_CopyChar(const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst, GUI_Color_t color) {
+    const uint8_t* s = src;
+    uint8_t* d = dst;
+    GUI_iDim_t x, y;
+
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    for (y = 0; y < ySize; y++) {
+        for (x = 0; x < xSize; x++) {
+            if (*s) {                               /* A8 input, alpha only */
+                PixelWrite(d, BlendColor(color, PixelRead(d), *s));
+            }
+            s++;
+            d += LCD_PIXEL_SIZE;
+        }
+        s += offLineSrc;
+        d += (size_t)offLineDst * LCD_PIXEL_SIZE;
+    }
+}
+
+/* Execute single command, the same as DMA2D transfer on target */
+static
+void Execute(const HOST_Command_t* cmd) {
+    switch (cmd->Type) {
+        case HOST_Command_Fill:
+            SW_Fill(cmd->Dst, cmd->XSize, cmd->YSize, cmd->OffLineDst, cmd->Color);
+            break;
+        case HOST_Command_Copy:
+            SW_Copy(cmd->Src, cmd->Dst, cmd->XSize, cmd->YSize, cmd->OffLineSrc, cmd->OffLineDst);
+            break;
+        case HOST_Command_CopyBlend:
+            SW_CopyBlending(cmd->Src, cmd->Dst, cmd->AlphaSrc, cmd->XSize, cmd->YSize, cmd->OffLineSrc, cmd->OffLineDst);
+            break;
+        case HOST_Command_DrawImage16:
+            SW_DrawImage16(cmd->Src, cmd->Dst, cmd->XSize, cmd->YSize, cmd->OffLineSrc, cmd->OffLineDst);
+            break;
+        case HOST_Command_DrawImage24:
+            SW_DrawImage24(cmd->Src, cmd->Dst, cmd->XSize, cmd->YSize, cmd->OffLineSrc, cmd->OffLineDst);
+            break;
+        case HOST_Command_DrawImage32:
+            SW_DrawImage32(cmd->Src, cmd->Dst, cmd->XSize, cmd->YSize, cmd->OffLineSrc, cmd->OffLineDst);
+            break;
+        case HOST_Command_CopyChar:
+            SW_CopyChar(cmd->Src, cmd->Dst, cmd->XSize, cmd->YSize, cmd->OffLineSrc, cmd->OffLineDst, cmd->Color);
+            break;
+        default:
+            break;
+    }
+}
+
+/* Get time in units of nanoseconds for blitter statistics */
+static
+uint64_t TimeNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Simulated DMA2D transfer complete interrupt, release finished command */
+static
+void DMA2D_IRQHandler(uint64_t time) {
+    Queue.Count++;
+    Queue.BusyTime += time;
+    __atomic_store_n(&Queue.Tail, (uint16_t)((Queue.Tail + 1) % HOST_DMA2D_QUEUE_SIZE), __ATOMIC_SEQ_CST);
+}
+
+#if HOST_DMA2D_ASYNC
+/* Blitter thread, processes commands from queue tail in order, the same as DMA2D does */
+static
+void* BlitterThread(void* arg) {
+    uint64_t time;
+    uint32_t idle = 0;
+    
+    while (1) {
+        if (__atomic_load_n(&Queue.Head, __ATOMIC_SEQ_CST) != Queue.Tail) {
+            idle = 0;
+            time = TimeNs();
+            Execute(&Queue.Cmds[Queue.Tail]);       /* Process transfer, command on tail is not modified until released */
+            DMA2D_IRQHandler(TimeNs() - time);      /* Transfer finished */
+        } else if (++idle < 100) {                  /* Give time to drawing thread before going to sleep */
+            sched_yield();
+        } else {
+            pthread_mutex_lock(&Queue.Mutex);
+            __atomic_store_n(&Queue.Sleeping, 1, __ATOMIC_SEQ_CST);
+            while (__atomic_load_n(&Queue.Head, __ATOMIC_SEQ_CST) == Queue.Tail) {
+                pthread_cond_wait(&Queue.Work, &Queue.Mutex);
+            }
+            __atomic_store_n(&Queue.Sleeping, 0, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&Queue.Mutex);
+            idle = 0;
+        }
+    }
+    return arg;
+}
+#endif /* HOST_DMA2D_ASYNC */
+
+/* Add pending commands after queue head to queue */
+static
+void DMA2D_Flush(void) {
+    if (!Queue.Pending) {
+        return;
+    }
+#if HOST_DMA2D_ASYNC
+    __atomic_store_n(&Queue.Head, (uint16_t)((Queue.Head + Queue.Pending) % HOST_DMA2D_QUEUE_SIZE), __ATOMIC_SEQ_CST);
+    Queue.Pending = 0;
+    if (__atomic_load_n(&Queue.Sleeping, __ATOMIC_SEQ_CST)) {   /* Wake up blitter */
+        pthread_mutex_lock(&Queue.Mutex);
+        pthread_cond_signal(&Queue.Work);
+        pthread_mutex_unlock(&Queue.Mutex);
+    }
+#else
+    while (Queue.Pending) {                         /* Process immediately, as blocking DMA2D transfer does */
+        uint64_t time = TimeNs();
+        Queue.Head = (Queue.Head + 1) % HOST_DMA2D_QUEUE_SIZE;
+        Queue.Pending--;
+        Execute(&Queue.Cmds[Queue.Tail]);
+        DMA2D_IRQHandler(TimeNs() - time);
+    }
+#endif /* HOST_DMA2D_ASYNC */
+}
+
+/* Get free command after pending commands, wait if queue is full */
+static
+HOST_Command_t* DMA2D_GetCommand(void) {
+    HOST_Command_t* cmd;
+    
+    while (((Queue.Head + Queue.Pending + 1) % HOST_DMA2D_QUEUE_SIZE) == __atomic_load_n(&Queue.Tail, __ATOMIC_SEQ_CST)) {  /* Wait for blitter to release at least one command */
+        DMA2D_Flush();                              /* Pending commands must be processed first */
+        sched_yield();
+    }
+    cmd = &Queue.Cmds[(Queue.Head + Queue.Pending) % HOST_DMA2D_QUEUE_SIZE];
+    memset(cmd, 0x00, sizeof(*cmd));
+    return cmd;
+}
+
+/* Add command to queue, or keep it pending until the end of batch */
+static
+void DMA2D_Submit(void) {
+    Queue.Pending++;
+    if (!Queue.Batch) {
+        DMA2D_Flush();
+    }
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                             LCD specific API                            **/
+/******************************************************************************/
+/******************************************************************************/
+static
+void LCD_Init(GUI_LCD_t* LCD) {
+    _LCD_Init();                                    /* Init simulated LCD */
+}
+
+static
+uint8_t LCD_Ready(GUI_LCD_t* LCD) {
+    if (__atomic_load_n(&Queue.Head, __ATOMIC_SEQ_CST) == __atomic_load_n(&Queue.Tail, __ATOMIC_SEQ_CST)) {
+        return 1;                                   /* Ready when all queued commands are processed */
+    }
+    sched_yield();                                  /* Let blitter run while GUI waits in fence */
+    return 0;
+}
+
+static
+uint32_t LCD_GetTime(GUI_LCD_t* LCD) {
+    return (uint32_t)(TimeNs() / 1000);             /* Monotonic clock in units of microseconds */
+}
+
+static
+GUI_Color_t LCD_GetPixel(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y) {
+    return PixelRead(PIXEL_ADDR(layer, x, y));
+}
+
+static
+void LCD_Fill(GUI_LCD_t* LCD, GUI_Layer_t* layer, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t OffLine, GUI_Color_t color) {
+    HOST_Command_t* cmd;
+    
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    cmd = DMA2D_GetCommand();
+    cmd->Type = HOST_Command_Fill;
+    cmd->Dst = dst;
+    cmd->XSize = xSize;
+    cmd->YSize = ySize;
+    cmd->OffLineDst = OffLine;
+    cmd->Color = color;
+    DMA2D_Submit();
+}
+
+static
+void LCD_Copy(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    HOST_Command_t* cmd;
+    
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    cmd = DMA2D_GetCommand();
+    cmd->Type = HOST_Command_Copy;
+    cmd->Src = src;
+    cmd->Dst = dst;
+    cmd->XSize = xSize;
+    cmd->YSize = ySize;
+    cmd->OffLineSrc = offLineSrc;
+    cmd->OffLineDst = offLineDst;
+    DMA2D_Submit();
+}
+
+/* Copy layers with blending with alpha combine */
+static
+void LCD_CopyBlending(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void* dst, uint8_t alphaSrc, uint8_t alphaDst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    HOST_Command_t* cmd;
+    
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    cmd = DMA2D_GetCommand();
+    cmd->Type = HOST_Command_CopyBlend;
+    cmd->Src = src;
+    cmd->Dst = dst;
+    cmd->AlphaSrc = alphaSrc;
+    cmd->XSize = xSize;
+    cmd->YSize = ySize;
+    cmd->OffLineSrc = offLineSrc;
+    cmd->OffLineDst = offLineDst;
+    DMA2D_Submit();
+}
+
+/* Queue image drawing of specific type */
+static
+void DrawImage(HOST_CommandType_t type, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    HOST_Command_t* cmd;
+    
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    cmd = DMA2D_GetCommand();
+    cmd->Type = type;
+    cmd->Src = src;
+    cmd->Dst = dst;
+    cmd->XSize = xSize;
+    cmd->YSize = ySize;
+    cmd->OffLineSrc = offLineSrc;
+    cmd->OffLineDst = offLineDst;
+    DMA2D_Submit();
+}
+
+static
+void LCD_DrawImage16(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t* img, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    DrawImage(HOST_Command_DrawImage16, src, dst, xSize, ySize, offLineSrc, offLineDst);
+}
+
+static
+void LCD_DrawImage24(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t* img, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    DrawImage(HOST_Command_DrawImage24, src, dst, xSize, ySize, offLineSrc, offLineDst);
+}
+
+static
+void LCD_DrawImage32(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_IMAGE_DESC_t* img, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    DrawImage(HOST_Command_DrawImage32, src, dst, xSize, ySize, offLineSrc, offLineDst);
+}
+
+static
+void LCD_CopyChar(GUI_LCD_t* LCD, GUI_Layer_t* layer, const void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst, GUI_Color_t color) {
+    HOST_Command_t* cmd;
+    
+    if (xSize <= 0 || ySize <= 0) {
+        return;
+    }
+    cmd = DMA2D_GetCommand();
+    cmd->Type = HOST_Command_CopyChar;
+    cmd->Src = src;
+    cmd->Dst = dst;
+    cmd->XSize = xSize;
+    cmd->YSize = ySize;
+    cmd->OffLineSrc = offLineSrc;
+    cmd->OffLineDst = offLineDst;
+    cmd->Color = color;
+    DMA2D_Submit();
+}
+
+static
+void LCD_DrawHLine(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t length, GUI_Color_t color) {
+    LCD_Fill(LCD, layer, PIXEL_ADDR(layer, x, y), length, 1, layer->Width - length, color);
+}
+
+static
+void LCD_DrawVLine(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t length, GUI_Color_t color) {
+    LCD_Fill(LCD, layer, PIXEL_ADDR(layer, x, y), 1, length, layer->Width - 1, color);
+}
+
+static
+void LCD_FillRect(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Color_t color) {
+    LCD_Fill(LCD, layer, PIXEL_ADDR(layer, x, y), xSize, ySize, layer->Width - xSize, color);
+}
+
+static
+void LCD_SetPixel(GUI_LCD_t* LCD, GUI_Layer_t* layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Color_t color) {
+    LCD_DrawHLine(LCD, layer, x, y, 1, color);      /* Pixel must be queued after previous operations */
+}
+
+/* Execute batch of commands, added to queue at once */
+static
+void LCD_DrawBatch(GUI_LCD_t* LCD, GUI_Layer_t* layer, const GUI_LL_Cmd_t* cmds, size_t count) {
+    GUI_LL_Cmd_t fill;
+    size_t i;
+    
+    Queue.Batch = 1;
+    for (i = 0; i < count; i++) {
+        const GUI_LL_Cmd_t* c = &cmds[i];
+        switch (c->Type) {
+            case GUI_LL_CmdType_Fill:
+                /**
+                 * Fills of the same color and width directly below each other,
+                 * such as rows of filled shape, are merged to single command
+                 */
+                fill = *c;
+                while (i + 1 < count && cmds[i + 1].Type == GUI_LL_CmdType_Fill
+                    && cmds[i + 1].Color == fill.Color && cmds[i + 1].XSize == fill.XSize && cmds[i + 1].OffLineDst == fill.OffLineDst
+                    && (uint8_t *)cmds[i + 1].Dst == (uint8_t *)fill.Dst + (size_t)fill.YSize * (fill.XSize + fill.OffLineDst) * LCD_PIXEL_SIZE) {
+                    fill.YSize += cmds[++i].YSize;
+                }
+                LCD_Fill(LCD, layer, fill.Dst, fill.XSize, fill.YSize, fill.OffLineDst, fill.Color);
+                break;
+            case GUI_LL_CmdType_Copy:
+                LCD_Copy(LCD, layer, c->Src, c->Dst, c->XSize, c->YSize, c->OffLineSrc, c->OffLineDst);
+                break;
+            case GUI_LL_CmdType_CopyBlend:
+                LCD_CopyBlending(LCD, layer, c->Src, c->Dst, c->AlphaSrc, c->AlphaDst, c->XSize, c->YSize, c->OffLineSrc, c->OffLineDst);
+                break;
+            case GUI_LL_CmdType_CopyChar:
+                LCD_CopyChar(LCD, layer, c->Src, c->Dst, c->XSize, c->YSize, c->OffLineSrc, c->OffLineDst, c->Color);
+                break;
+            case GUI_LL_CmdType_DrawImage:
+                DrawImage(c->Img->BPP == 16 ? HOST_Command_DrawImage16 : c->Img->BPP == 24 ? HOST_Command_DrawImage24 : HOST_Command_DrawImage32,
+                    c->Src, c->Dst, c->XSize, c->YSize, c->OffLineSrc, c->OffLineDst);
+                break;
+            default:
+                break;
+        }
+    }
+    Queue.Batch = 0;
+    DMA2D_Flush();                                  /* Add all commands to queue */
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+void LCD_HOST_GetBlitterStats(uint32_t* count, uint64_t* busyTime) {
+    if (count) {
+        *count = Queue.Count;
+    }
+    if (busyTime) {
+        *busyTime = Queue.BusyTime;
+    }
+}
+
+uint8_t GUI_LL_Control(GUI_LCD_t* LCD, GUI_LL_Command_t cmd, void* param, void* result) {
+    switch (cmd) {
+        case GUI_LL_Command_Init: {
+            uint8_t i = 0;
+            GUI_LL_t* LL = (GUI_LL_t *)param;
+
+            /*******************************/
+            /* Assign memory to GUI        */
+            /*******************************/
+            do {
+                static uint32_t FastMemory[HOST_FAST_HEAP_SIZE / 4];    /* Replaces TCM RAM */
+                static uint32_t HeapMemory[HOST_HEAP_SIZE / 4];         /* Replaces SDRAM heap memory */
+                GUI_MEM_Region_t regions[] = {
+                    {FastMemory, sizeof(FastMemory)},
+                    {HeapMemory, sizeof(HeapMemory)},
+                };
+                if ((uintptr_t)regions[0].StartAddress > (uintptr_t)regions[1].StartAddress) {
+                    GUI_MEM_Region_t tmp = regions[0];  /* Regions must be sorted by address */
+                    regions[0] = regions[1];
+                    regions[1] = tmp;
+                }
+                GUI_MEM_AssignMemory(regions, GUI_COUNT_OF(regions));
+            } while (0);
+
+            /*******************************/
+            /* Set up LCD data             */
+            /*******************************/
+            LCD->Width = LCD_WIDTH;
+            LCD->Height = LCD_HEIGHT;
+            LCD->PixelSize = LCD_PIXEL_SIZE;
+
+            /*******************************/
+            /* Set layers count            */
+            /*******************************/
+            LCD->LayersCount = GUI_LAYERS;      /* We have 2 layers for our low-level driver */
+            LCD->Layers = Layers;
+            for (i = 0; i < GUI_LAYERS; i++) {  /* Set each layer */
+                Layers[i].Num = i;
+                Layers[i].StartAddress = (uintptr_t)FrameBuffer[i];
+            }
+
+            /*******************************/
+            /* Set up LCD drawing routines */
+            /*******************************/
+            LL->Init = LCD_Init;                /* Must be set by user */
+            LL->GetPixel = LCD_GetPixel;        /* Must be set by user */
+            LL->SetPixel = LCD_SetPixel;        /* Must be set by user */
+
+            LL->IsReady = LCD_Ready;            /* Set is ready function to indicate low-level layer has finished any transmission */
+            LL->Copy = LCD_Copy;                /* Set copy memory routine */
+            LL->DrawHLine = LCD_DrawHLine;      /* Set drawing vertical line routine */
+            LL->DrawVLine = LCD_DrawVLine;      /* Set drawing horizontal line routine */
+            LL->Fill = LCD_Fill;                /* Set fill screen routine */
+            LL->FillRect = LCD_FillRect;        /* Set fill rectangle routine */
+            LL->CopyBlend = LCD_CopyBlending;   /* Set copy with blending */
+            LL->DrawImage16 = LCD_DrawImage16;  /* Set draw function for 24bit image (RGB565) format */
+            LL->DrawImage24 = LCD_DrawImage24;  /* Set draw function for 24bit image (RGB888) format */
+            LL->DrawImage32 = LCD_DrawImage32;  /* Set draw function for 32bit image (ARGB8888/ABGR8888) format */
+            LL->CopyChar = LCD_CopyChar;        /* Set draw function for char copy with alpha information */
+            LL->DrawBatch = LCD_DrawBatch;      /* Set function for batch of commands */
+            LL->GetTime = LCD_GetTime;          /* Set time function for statistics */
+
+#if HOST_DMA2D_ASYNC
+            do {
+                static pthread_t thread;
+                static uint8_t started;
+                if (!started) {                 /* Start blitter only once */
+                    started = !pthread_create(&thread, NULL, BlitterThread, NULL);
+                }
+            } while (0);
+#endif /* HOST_DMA2D_ASYNC */
+
+            if (result) {
+                *(uint8_t *)result = 0;         /* Successful initialization */
+            }
+            return 1;                           /* Command processed */
+        }
+        case GUI_LL_Command_SetActiveLayer: {   /* Set new active layer */
+            GUI_Byte layer = *(GUI_Byte *)param;/* Read layer as byte */
+            LCD->Layers[layer].Pending = 1;     /* Set layer as pending and show it on next simulated vsync */
+
+            if (result) {
+                *(uint8_t *)result = 0;         /* Successful layer set as active */
+            }
+            return 1;                           /* Command processed */
+        }
+        default:
+            return 0;
+    }
+}
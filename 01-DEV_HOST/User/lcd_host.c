@@ -0,0 +1,75 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#include "lcd_host.h"
+
+static uint8_t VisibleLayer;                        /* Layer currently shown on simulated display */
+static uint32_t VSyncCount;                         /* Number of simulated vertical synchronizations */
+
+void _LCD_Init(void) {
+    VisibleLayer = 0;
+    VSyncCount = 0;
+}
+
+/* Simulated LTDC line event at the start of vertical blanking */
+void LCD_HOST_VSync(void) {
+    uint8_t i = 0;
+    for (i = 0; i < GUI_LAYERS; i++) {
+        if (Layers[i].Pending) {                    /* Is layer waiting for redraw operation */
+            VisibleLayer = i;                       /* Show layer on display */
+            GUI_LCD_ConfirmActiveLayer(i);
+            break;
+        }
+    }
+    VSyncCount++;
+}
+
+uint32_t LCD_HOST_GetVSyncCount(void) {
+    return VSyncCount;
+}
+
+GUI_Layer_t* LCD_HOST_GetVisibleLayer(void) {
+    return &Layers[VisibleLayer];
+}
+
+uint8_t LCD_HOST_WritePPM(const char* path) {
+    GUI_Layer_t* layer = LCD_HOST_GetVisibleLayer();
+    FILE* f;
+    GUI_iDim_t x, y;
+
+    if ((f = fopen(path, "wb")) == NULL) {
+        return 0;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", (int)LCD_WIDTH, (int)LCD_HEIGHT);
+    for (y = 0; y < LCD_HEIGHT; y++) {
+        for (x = 0; x < LCD_WIDTH; x++) {
+            GUI_Color_t c = GUI.LL.GetPixel(&GUI.LCD, layer, x, y);
+            uint8_t rgb[3] = {(c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF};
+            fwrite(rgb, 1, sizeof(rgb), f);
+        }
+    }
+    fclose(f);
+    return 1;
+}
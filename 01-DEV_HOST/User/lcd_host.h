@@ -0,0 +1,85 @@
+#ifndef __LCD_HOST
+#define __LCD_HOST
+
+#define GUI_INTERNAL
+#include "gui_ll.h"
+
+/*****************************/
+/*      Host simulator       */
+/*****************************/
+#if !defined(LCD_WIDTH)
+#define LCD_WIDTH                   480
+#endif /* !defined(LCD_WIDTH) */
+#if !defined(LCD_HEIGHT)
+#define LCD_HEIGHT                  272
+#endif /* !defined(LCD_HEIGHT) */
+
+#if !defined(LCD_COLOR_FORMAT_RGB565) && !defined(LCD_COLOR_FORMAT_ARGB8888)
+#define LCD_COLOR_FORMAT_ARGB8888
+#endif
+
+#if defined(LCD_COLOR_FORMAT_RGB565)
+#define LCD_PIXEL_SIZE              2
+#else
+#define LCD_PIXEL_SIZE              4
+#endif
+
+/*****************************/
+/*       Common setup        */
+/*****************************/
+/* Frame buffer settings */
+#define LCD_FRAME_BUFFER_SIZE       ((size_t)(LCD_WIDTH * LCD_HEIGHT * LCD_PIXEL_SIZE))
+
+/* Number of layers, set to 3 for triple buffering */
+#if !defined(GUI_LAYERS)
+#define GUI_LAYERS                  2
+#endif /* !defined(GUI_LAYERS) */
+
+/* Blitter queue, when async is enabled commands are processed by separate thread instead of DMA2D */
+#if !defined(HOST_DMA2D_ASYNC)
+#define HOST_DMA2D_ASYNC            1
+#endif /* !defined(HOST_DMA2D_ASYNC) */
+#define HOST_DMA2D_QUEUE_SIZE       32
+
+/* Heap sizes, fast region replaces TCM RAM and slow region replaces SDRAM heap */
+#define HOST_FAST_HEAP_SIZE         0x10000
+#define HOST_HEAP_SIZE              0x600000
+
+extern GUI_Layer_t Layers[GUI_LAYERS];
+
+void _LCD_Init(void);
+
+/**
+ * \brief           Simulate LTDC reload event at the start of vertical blanking
+ *
+ *                  Pending layer becomes visible and GUI is notified with \ref GUI_LCD_ConfirmActiveLayer,
+ *                  the same way as LTDC line event interrupt does it on target
+ */
+void LCD_HOST_VSync(void);
+
+/**
+ * \brief           Get number of simulated vertical synchronizations so far
+ */
+uint32_t LCD_HOST_GetVSyncCount(void);
+
+/**
+ * \brief           Get layer currently shown on simulated display
+ */
+GUI_Layer_t* LCD_HOST_GetVisibleLayer(void);
+
+/**
+ * \brief           Get statistics of simulated DMA2D blitter
+ * \param[out]      *count: Number of finished commands. Set to NULL if not used
+ * \param[out]      *busyTime: Time spent in commands in units of nanoseconds. Set to NULL if not used
+ */
+void LCD_HOST_GetBlitterStats(uint32_t* count, uint64_t* busyTime);
+
+/**
+ * \brief           Write visible layer to binary PPM file
+ * \param[in]       *path: Output file path
+ * \retval          1: File written
+ * \retval          0: File could not be written
+ */
+uint8_t LCD_HOST_WritePPM(const char* path);
+
+#endif /* __LCD_HOST */
@@ -0,0 +1,223 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#include "lcd_host.h"
+#include "gui.h"
+#include "gui_window.h"
+#include "gui_button.h"
+#include "gui_led.h"
+#include "gui_progbar.h"
+#include "gui_textview.h"
+#include "gui_keyboard.h"
+
+#include <time.h>
+
+/**
+ * Host simulator for GUI library
+ *
+ * Runs GUI with software frame buffer low-level driver,
+ * simulated touch input and simulated vertical synchronization.
+ *
+ * Usage: gui_sim [frames] [output.ppm]
+ */
+
+#define ID_BASE                 (GUI_ID_USER)
+#define ID_BTN_BASE             (ID_BASE + 0x0100)
+#define ID_LED_BASE             (ID_BASE + 0x0200)
+#define ID_PROGBAR              (ID_BASE + 0x0301)
+#define ID_TEXTVIEW             (ID_BASE + 0x0401)
+
+#define SIM_FRAME_TIME          16                  /* Milliseconds between simulated frames */
+#define SIM_BUTTONS             15
+#define SIM_LEDS                4
+
+extern const GUI_FONT_t GUI_Font_Roboto_Italic_14;
+
+static GUI_HANDLE_p progbar;
+static GUI_HANDLE_p leds[SIM_LEDS];
+
+/* Get monotonic time in units of microseconds */
+static
+uint64_t TimeUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+/* Create test screen */
+static
+void CreateScreen(void) {
+    GUI_HANDLE_p desktop, h;
+    uint32_t i;
+
+    GUI_WIDGET_SetFontDefault(&GUI_Font_Roboto_Italic_14);  /* Set default font for widgets */
+    desktop = GUI_WINDOW_GetDesktop();              /* Get desktop window */
+
+    for (i = 0; i < SIM_BUTTONS; i++) {
+        h = GUI_BUTTON_Create(ID_BTN_BASE + i, 5 + (i % 3) * 160, 5 + (i / 3) * 40, 150, 35, desktop, 0, 0);
+        GUI_WIDGET_SetText(h, _GT("Button"));
+    }
+    for (i = 0; i < SIM_LEDS; i++) {
+        leds[i] = GUI_LED_Create(ID_LED_BASE + i, 5 + i * 30, 210, 20, 20, desktop, 0, 0);
+    }
+    progbar = GUI_PROGBAR_Create(ID_PROGBAR, 130, 210, 200, 20, desktop, 0, 0);
+    GUI_PROGBAR_EnablePercentages(progbar);
+
+    h = GUI_TEXTVIEW_Create(ID_TEXTVIEW, 340, 205, 135, 60, desktop, 0, 0);
+    GUI_WIDGET_SetText(h, _GT("Host simulator\nsoftware frame buffer"));
+
+    GUI_KEYBOARD_Create();                          /* Create keyboard, hidden by default */
+}
+
+/* Simulate touch press or release on specific coordinate */
+static
+void SimTouch(GUI_iDim_t x, GUI_iDim_t y, uint8_t pressed, uint32_t time) {
+    GUI_TouchData_t t;
+
+    memset(&t, 0x00, sizeof(t));
+    t.Count = pressed ? 1 : 0;
+    t.X[0] = x;
+    t.Y[0] = y;
+    t.Status = pressed ? GUI_TouchState_PRESSED : GUI_TouchState_RELEASED;
+    t.Time = time;
+    GUI_INPUT_TouchAdd(&t);
+}
+
+int main(int argc, char** argv) {
+    uint32_t frames = 600, frame, time = 0, redraws = 0;
+    uint64_t start, t, total = 0, max = 0, busy;
+    uint32_t cmds;
+    const char* out = NULL;
+#if GUI_USE_STATS
+    GUI_STATS_t stats, sum = {0};
+    uint32_t lastFrame = 0, i;
+#endif /* GUI_USE_STATS */
+
+    if (argc > 1) {
+        frames = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2) {
+        out = argv[2];
+    }
+
+    GUI_Init();
+    CreateScreen();
+
+    start = TimeUs();
+    for (frame = 0; frame < frames; frame++) {
+        /* Animate widgets */
+        if (!(frame % 5)) {
+            GUI_PROGBAR_SetValue(progbar, (frame / 5) % 100);
+        }
+        if (!(frame % 30)) {
+            GUI_LED_Toggle(leds[(frame / 30) % SIM_LEDS]);
+        }
+
+        /* Press one of buttons every half second */
+        if ((frame % 30) == 10) {
+            uint32_t i = (frame / 30) % SIM_BUTTONS;
+            SimTouch(5 + (i % 3) * 160 + 75, 5 + (i / 3) * 40 + 17, 1, time);
+        } else if ((frame % 30) == 15) {
+            SimTouch(0, 0, 0, time);
+        }
+
+        GUI_UpdateTime(SIM_FRAME_TIME);
+        time += SIM_FRAME_TIME;
+
+        t = TimeUs();
+        GUI_Process();                              /* Process GUI */
+        t = TimeUs() - t;
+        if (GUI.LCD.Flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM) {  /* New frame waits for vsync */
+            redraws++;
+        }
+        total += t;
+        if (t > max) {
+            max = t;
+        }
+#if GUI_USE_STATS
+        if (GUI_STATS_Get(&stats) && stats.Frame + 1 != lastFrame) {  /* New frame drawn */
+            lastFrame = stats.Frame + 1;
+            sum.WidgetsVisited += stats.WidgetsVisited;
+            sum.WidgetsDrawn += stats.WidgetsDrawn;
+            sum.WidgetsSkipped += stats.WidgetsSkipped;
+            sum.WidgetsOccluded += stats.WidgetsOccluded;
+            sum.PixelsFilled += stats.PixelsFilled;
+            sum.PixelsCopied += stats.PixelsCopied;
+            sum.PixelsBlended += stats.PixelsBlended;
+            for (i = 0; i < GUI_STATS_LL_Count; i++) {
+                sum.LLCalls[i] += stats.LLCalls[i];
+            }
+            sum.BatchedCommands += stats.BatchedCommands;
+            sum.Glyphs += stats.Glyphs;
+            sum.GlyphCacheHits += stats.GlyphCacheHits;
+            sum.GlyphCacheMisses += stats.GlyphCacheMisses;
+            sum.TextLayoutHits += stats.TextLayoutHits;
+            sum.TextLayoutMisses += stats.TextLayoutMisses;
+            sum.DirtyArea += stats.DirtyArea;
+            sum.CopyBackArea += stats.CopyBackArea;
+            sum.TimeInput += stats.TimeInput;
+            sum.TimeTimers += stats.TimeTimers;
+            sum.TimeRedraw += stats.TimeRedraw;
+            sum.TimeSwap += stats.TimeSwap;
+        }
+#endif /* GUI_USE_STATS */
+
+        LCD_HOST_VSync();                           /* Simulate vertical synchronization */
+    }
+
+    printf("Display: %dx%d, %d bytes per pixel\r\n", (int)LCD_WIDTH, (int)LCD_HEIGHT, (int)LCD_PIXEL_SIZE);
+    printf("Frames: %lu, frames with redraw: %lu, vsyncs: %lu\r\n",
+        (unsigned long)frames, (unsigned long)redraws, (unsigned long)LCD_HOST_GetVSyncCount());
+    printf("GUI_Process: avg %lu us, max %lu us, wall %lu us\r\n",
+        (unsigned long)(frames ? total / frames : 0), (unsigned long)max, (unsigned long)(TimeUs() - start));
+    LCD_HOST_GetBlitterStats(&cmds, &busy);
+    printf("Blitter: %s, %lu commands, busy %lu us\r\n", HOST_DMA2D_ASYNC ? "async" : "sync",
+        (unsigned long)cmds, (unsigned long)(busy / 1000));
+    printf("Memory: free %lu, min free %lu bytes\r\n",
+        (unsigned long)GUI_MEM_GetFree(), (unsigned long)GUI_MEM_GetMinFree());
+#if GUI_USE_STATS
+    for (cmds = 0, i = 0; i < GUI_STATS_LL_Count; i++) {
+        cmds += sum.LLCalls[i];
+    }
+    printf("Stats: %lu frames, widgets drawn %lu, skipped %lu, occluded %lu, visited %lu, glyphs %lu, dirty area %lu pixels\r\n",
+        (unsigned long)lastFrame, (unsigned long)sum.WidgetsDrawn, (unsigned long)sum.WidgetsSkipped,
+        (unsigned long)sum.WidgetsOccluded, (unsigned long)sum.WidgetsVisited, (unsigned long)sum.Glyphs, (unsigned long)sum.DirtyArea);
+    printf("Stats: copy-back area %lu pixels\r\n", (unsigned long)sum.CopyBackArea);
+    printf("Stats: pixels filled %lu, copied %lu, blended %lu, %lu low-level calls, %lu batched commands\r\n",
+        (unsigned long)sum.PixelsFilled, (unsigned long)sum.PixelsCopied, (unsigned long)sum.PixelsBlended, (unsigned long)cmds,
+        (unsigned long)sum.BatchedCommands);
+    printf("Stats: time input %lu us, timers %lu us, redraw %lu us, swap %lu us\r\n",
+        (unsigned long)sum.TimeInput, (unsigned long)sum.TimeTimers, (unsigned long)sum.TimeRedraw, (unsigned long)sum.TimeSwap);
+    printf("Stats: glyph cache hits %lu, misses %lu, text layout hits %lu, misses %lu\r\n",
+        (unsigned long)sum.GlyphCacheHits, (unsigned long)sum.GlyphCacheMisses,
+        (unsigned long)sum.TextLayoutHits, (unsigned long)sum.TextLayoutMisses);
+#endif /* GUI_USE_STATS */
+
+    if (out && !LCD_HOST_WritePPM(out)) {
+        printf("Cannot write %s\r\n", out);
+        return 1;
+    }
+    return 0;
+}
@@ -1514,11 +1514,23 @@ GUI_Const GUI_FONT_CharInfo_t Arial_Bold_18_CharTable[] = {
 {   0,    1,  0,    0,    6, Font_Arial_Bold_18_007f},
 };
 
+GUI_Const GUI_Byte Arial_Bold_18_Advances[] = {
+      6,   3,   8,  11,   9,  15,  13,   3,   5,   5,   8,  10,   4,   6,   4,   6,
+      9,   6,   9,   9,  11,  10,   9,   9,   9,   9,   3,   3,  10,  10,  10,  10,
+     17,  14,  12,  12,  12,  11,  10,  13,  12,   4,  10,  13,  11,  14,  12,  13,
+     11,  14,  13,  11,  12,  12,  13,  18,  13,  13,  12,   6,   6,   6,   9,  11,
+      4,   9,  10,  10,  10,   9,   8,  10,  10,   4,   6,  10,   4,  15,  10,  10,
+     10,  10,   7,   9,   7,  10,  11,  15,  10,  11,   9,   7,   3,   7,  10,   6,
+};
+
 GUI_Const GUI_FONT_t GUI_Font_Arial_Bold_18 = {
     _GT("Arial Bold"),
     18,
     0x20,
     0x7f,
     GUI_FLAG_FONT_AA,
-    Arial_Bold_18_CharTable
+    Arial_Bold_18_CharTable,
+    0,
+    0,
+    Arial_Bold_18_Advances
 };
@@ -34382,11 +34382,20 @@ GUI_Const GUI_FONT_CharInfo_t Arial_Narrow_Italic_22_CharTable[] = {
     {  13,   16,  0,    3,    1, Font_Arial_Narrow_Italic_22_2c6f},
 };
 
+GUI_Const GUI_FONT_Range_t Arial_Narrow_Italic_22_Ranges[] = {
+    {0x0020, 0x07cf, &Arial_Narrow_Italic_22_CharTable[0]},
+    {0x2c62, 0x2c62, &Arial_Narrow_Italic_22_CharTable[1968]},
+    {0x2c64, 0x2c64, &Arial_Narrow_Italic_22_CharTable[1969]},
+    {0x2c6d, 0x2c6f, &Arial_Narrow_Italic_22_CharTable[1970]},
+};
+
 GUI_Const GUI_FONT_t GUI_Font_Arial_Narrow_Italic_22 = {
     _GT("Arial Narrow Italic"),
     22,
     0x0020,
     0x2c6f,
     0,
-    Arial_Narrow_Italic_22_CharTable
+    Arial_Narrow_Italic_22_CharTable,
+    Arial_Narrow_Italic_22_Ranges,
+    4
 };
@@ -827,11 +827,23 @@ GUI_Const GUI_FONT_CharInfo_t Calibri_Bold_8_CharTable[] = {
     {   4,    1,  0,    0,    1, Font_Calibri_Bold_8_007f},
 };
 
+GUI_Const GUI_Byte Calibri_Bold_8_Advances[] = {
+      5,   2,   4,   5,   5,   7,   6,   2,   3,   3,   3,   5,   3,   3,   3,   4,
+      5,   4,   5,   5,   5,   5,   5,   5,   5,   5,   2,   3,   5,   5,   5,   4,
+      8,   6,   4,   5,   5,   4,   3,   6,   5,   2,   3,   4,   3,   6,   5,   6,
+      4,   7,   4,   5,   5,   5,   6,   8,   5,   5,   5,   2,   4,   3,   5,   5,
+      2,   4,   5,   4,   5,   5,   3,   5,   5,   3,   3,   5,   2,   7,   5,   5,
+      5,   5,   4,   4,   4,   5,   5,   7,   4,   5,   4,   3,   2,   4,   5,   5,
+};
+
 GUI_Const GUI_FONT_t GUI_Font_Calibri_Bold_8 = {
     _GT("Calibri Bold"),
     8,
     0x20,
     0x7f,
     0,
-    Calibri_Bold_8_CharTable
+    Calibri_Bold_8_CharTable,
+    0,
+    0,
+    Calibri_Bold_8_Advances
 };
@@ -1817,11 +1817,23 @@ GUI_Const GUI_FONT_CharInfo_t CharTable[] = {
     {   7,    1,  0,    0,    1, Font_Comic_Sans_MS_Regular_size_12_007f},
 };
 
+GUI_Const GUI_Byte Comic_Sans_MS_Regular_22_Advances[] = {
+      8,   4,   7,  19,  13,  16,  14,   3,   7,   7,  10,  10,   4,   8,   3,  10,
+     13,   8,  11,  11,  13,  12,  12,  13,  12,  12,   3,   4,   8,   9,   8,  10,
+     19,  15,  12,  13,  14,  12,  12,  15,  15,  11,  14,  12,  12,  19,  17,  17,
+     11,  19,  13,  14,  16,  14,  13,  22,  15,  14,  15,   7,  10,   7,  10,  15,
+      5,  11,  11,  10,  12,  12,  10,  11,  11,   4,   8,  11,   3,  16,  11,  10,
+     11,  10,  10,  11,  10,  10,  10,  14,  12,  12,  11,   8,   3,   8,  12,   8,
+};
+
 GUI_Const GUI_FONT_t GUI_Font_Comic_Sans_MS_Regular_22 = {
     _GT("Comic Sans MS Regular"),
     22,
     0x20,
     0x7f,
     0,
-    CharTable
+    CharTable,
+    0,
+    0,
+    Comic_Sans_MS_Regular_22_Advances
 };
@@ -7448,11 +7448,33 @@ GUI_Const GUI_FONT_CharInfo_t FontAwesome_Regular_30_CharTable[] = {
     {  11,   26,  0,   25,    1, Font_FontAwesome_Regular_30_f0ff},
 };
 
+GUI_Const GUI_Byte FontAwesome_Regular_30_Advances[] = {
+     27,  27,  29,  31,  31,  29,  29,  25,  33,  29,  31,  31,  27,  21,  29,  12,
+     29,  27,  31,  27,  25,  28,  27,  27,  31,  29,  27,  27,  27,  27,  27,  12,
+     12,  27,  31,  20,  30,  29,  14,  20,  29,  25,  31,  26,  33,  29,  22,  29,
+     33,  29,  25,  18,  31,  27,  31,  31,  31,  31,  31,  31,  31,  31,  33,  12,
+     26,  18,  27,  18,  31,  29,  29,  31,  18,  31,  27,  25,  27,  27,  27,  12,
+     31,  18,  27,  18,  19,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  12,
+     26,  26,  27,  27,  31,  27,  27,  25,  25,  25,  27,  27,  31,  25,  31,  12,
+     31,  31,  24,  29,  31,  31,  27,  28,  28,  33,  29,  29,  32,  12,  31,  12,
+     35,  27,  27,  31,  29,  33,  31,  27,  27,  15,  31,  27,  27,  20,  31,  12,
+     27,  29,  27,  29,  27,  25,  25,  22,  27,  27,  15,  27,  29,  33,  25,  12,
+     27,  31,  29,  27,  31,  31,  27,  27,  27,  27,  27,  27,  27,  29,  31,  12,
+     25,  31,  27,  12,  12,  12,  12,  12,  12,  12,  12,  12,  12,  12,  12,  12,
+     33,  29,  33,  25,  31,  31,  25,  27,  27,  27,  31,  31,  31,  27,  29,  12,
+     29,  30,  27,  27,  27,  40,  33,  18,  18,  11,  11,  29,  18,  18,  18,  12,
+     31,  27,  27,  30,  31,  31,  31,  16,  31,  29,  31,  18,  31,  33,  33,  12,
+     25,  25,  31,  29,  32,  25,  27,  25,  25,  32,  31,  33,  28,  27,  27,  12,
+};
+
 GUI_Const GUI_FONT_t GUI_Font_FontAwesome_Regular_30 = {
     _GT("FontAwesome Regular"),
     30,
     0xf000,
     0xf0ff,
     0,
-    FontAwesome_Regular_30_CharTable
+    FontAwesome_Regular_30_CharTable,
+    0,
+    0,
+    FontAwesome_Regular_30_Advances
 };
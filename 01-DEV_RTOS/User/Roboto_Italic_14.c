@@ -1254,11 +1254,23 @@ GUI_Const GUI_FONT_CharInfo_t Roboto_Italic_14_CharTable[] = {
     {   5,    1,  0,    0,    1, Font_Roboto_Italic_14_007f},
 };
 
+GUI_Const GUI_Byte Roboto_Italic_14_Advances[] = {
+      6,   4,   5,   9,   7,   9,   9,   3,   5,   6,   6,   7,   4,   5,   3,   8,
+      7,   5,   8,   8,   8,   8,   7,   8,   7,   7,   4,   5,   8,   7,   8,   6,
+     13,  10,   9,   9,   9,   9,   9,   9,  11,   5,   9,  10,   7,  13,  11,   9,
+     10,   9,   9,   9,   9,   9,   9,  13,  10,   9,   9,   6,   5,   6,   5,   7,
+      4,   8,   8,   7,   8,   7,   6,   8,   8,   4,   6,   8,   4,  12,   8,   7,
+      8,   7,   6,   7,   6,   7,   7,  10,   8,   9,   8,   6,   4,   6,   9,   6,
+};
+
 const GUI_FONT_t GUI_Font_Roboto_Italic_14 = {
     _GT("Roboto Italic"),
     14,
     0x0020,
-    0x2c6f,
+    0x007f,
+    0,
+    Roboto_Italic_14_CharTable,
+    0,
     0,
-    Roboto_Italic_14_CharTable
+    Roboto_Italic_14_Advances
 };
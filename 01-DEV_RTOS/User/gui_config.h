@@ -103,6 +103,119 @@
  */
 #define GUI_USE_TRANSLATE               1
 
+/**
+ * \brief           Maximal number of rectangles in list of invalidated display regions
+ *
+ *                  Invalidated areas are kept as disjoint rectangles and redrawn separately.
+ *                  When list is full, new area is merged with rectangle which wastes least pixels
+ */
+#define GUI_DISPLAY_REGIONS             8
+
+/**
+ * \brief           Maximal percentage of pixels (0-100) which may be redrawn
+ *                  without being invalidated when 2 rectangles are merged into bounding box
+ */
+#define GUI_DISPLAY_REGIONS_WASTE       25
+
+/**
+ * \brief           Minimal number of children widgets when parent widget builds spatial index of them
+ *
+ *                  Index is used on invalidation to find overlapping children widgets
+ *                  without checking every pair of them. Moved, resized or removed widget
+ *                  is updated in index, which is built again only when order of children
+ *                  or geometry of parent widget changes. Set to 0 to disable index
+ */
+#define GUI_WIDGET_GRID_CHILDREN        32
+
+/**
+ * \brief           Enables (1) or disables (0) integer widget geometry
+ *
+ *                  Widget position and size are stored as integers instead of float,
+ *                  percentage values in units of 0.01 percent, limited to range from -327.68 to 327.67 percent.
+ *                  Layout is resolved to pixels without floating point operations
+ */
+#define GUI_USE_FIXED_GEOMETRY          0
+
+/**
+ * \brief           Enables (1) or disables (0) two-level segregated fit memory allocator
+ *
+ *                  Allocation and free take bounded time regardless of fragmentation.
+ *                  When disabled, first-fit allocator with address ordered free list is used
+ */
+#define GUI_MEM_TLSF                    1
+
+/**
+ * \brief           Enables (1) or disables (0) per frame render statistics
+ *
+ *                  Statistics are read with \ref GUI_STATS_Get.
+ *                  Low-level driver must set \ref GUI_LL_t.GetTime function to measure time
+ */
+#define GUI_USE_STATS                   1
+
+/**
+ * \brief           Maximal number of bytes kept in pool of scratch layers for transparent widgets
+ *
+ *                  Released layers stay in pool and are reused by next redraw of the same size class.
+ *                  Least recently used layers are freed when limit is reached. Set to 0 to free layers after use
+ */
+#define GUI_SCRATCH_POOL_SIZE           0x100000
+
+/**
+ * \brief           Maximal number of bytes used by glyph cache
+ *
+ *                  Characters converted for \ref GUI_LL_t.CopyChar function are kept in cache.
+ *                  Least recently used characters are freed when limit is reached.
+ *                  Set to 0 to draw characters directly from font data
+ */
+#define GUI_GLYPH_CACHE_SIZE            0x8000
+
+/**
+ * \brief           Maximal number of bytes used by text layout cache
+ *
+ *                  Line breaks and widths of drawn texts are kept in cache,
+ *                  unchanged texts are not measured again on redraw.
+ *                  Set to 0 to measure texts on every redraw
+ */
+#define GUI_TEXTLAYOUT_CACHE_SIZE       0x2000
+
+/**
+ * \brief           Number of circle radii with cached span tables
+ *
+ *                  Row widths of filled circle corners are computed once per radius
+ *                  and reused by circles and rounded rectangles of the same radius.
+ *                  Least recently used table is replaced when all entries are used.
+ *                  Set to 0 to compute corners on every redraw
+ */
+#define GUI_CIRCLE_CACHE_SIZE           16
+
+/**
+ * \brief           Maximal number of drawing commands collected in single batch
+ *
+ *                  Text, lines and filled shapes collect their low-level commands
+ *                  and send them to \ref GUI_LL_t.DrawBatch at once when driver supports it.
+ *                  Set to 0 to call low-level functions for each command
+ */
+#define GUI_LL_BATCH_SIZE               32
+
+/**
+ * \brief           Maximal number of opaque sibling widgets used to hide widgets below them
+ *
+ *                  Widgets completely covered by opaque widgets above them are not drawn
+ *                  and partially covered widgets are drawn only in uncovered part when it is rectangle.
+ *                  It also limits number of repainted opaque areas not copied from active layer on layer swap.
+ *                  Set to 0 to draw all widgets in region
+ */
+#define GUI_OCCLUSION_RECTS             8
+
+/**
+ * \brief           Maximal number of widget tree levels visited on redraw and touch
+ *
+ *                  Widget tree is walked with fixed size stack instead of recursion.
+ *                  This is hard limit of widget tree depth, base widgets are on first level.
+ *                  Widget which would be nested deeper is not created and its create function returns NULL
+ */
+#define GUI_WIDGET_MAX_DEPTH            8
+
 /**
  * \}
  */